@@ -0,0 +1,453 @@
+/*
+ * Assinatura e verificação em lote das transações (Ed25519)
+ *
+ * Pipeline de um lote:
+ *    1. Cache: resumo de 64 bits de (mensagem, assinatura) num conjunto
+ *       associativo de 4 vias; o que já foi aceito não é verificado de novo
+ *       (bloco reenviado, ramo que volta numa reorganização).
+ *    2. Chaves públicas: cache por conta, preenchido por quem chama.
+ *    3. Verificação: as pendentes são divididas em fatias entre as threads
+ *       do pool (a thread que chama também trabalha). O OpenSSL não tem
+ *       verificação Ed25519 em lote, então o lote é de escalonamento: cada
+ *       assinatura é conferida inteira por uma thread.
+ *    4. As aceitas entram no cache.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <openssl/evp.h>
+#include <openssl/sha.h>
+#include "assinaturas.h"
+#include "contadores.h"
+#include "storage.h"
+
+#define MENSAGEM_LEN 20
+#define CHAVES_CACHE 4096               // Chaves por conta (mapeamento direto)
+#define CONJUNTOS_CACHE (1u << 16)      // Cache de verificadas: 64K conjuntos x 4 vias
+#define VIAS_CACHE 4
+#define FATIA_THREAD 8                  // Assinaturas pegas de uma vez por thread
+
+static const char dominioChave[] = "BLOCKCHAIN-SIM-ED25519";
+static unsigned int sementeChaves = 0;
+
+// Chaves das carteiras simuladas (assinatura) e chaves públicas (verificação)
+static EVP_PKEY *chavesPrivadas[CHAVES_CACHE];
+static unsigned int contaChavePrivada[CHAVES_CACHE];   // Conta + 1 (0 = vazio)
+static unsigned char chavesPublicas[CHAVES_CACHE][CHAVE_PUBLICA_LEN];
+static unsigned int contaChavePublica[CHAVES_CACHE];
+
+static unsigned long long cacheVerificadas[CONJUNTOS_CACHE][VIAS_CACHE];  // 0 = vazio
+static unsigned char proximaVia[CONJUNTOS_CACHE];
+
+static EstatisticasAssinaturas estatisticas;
+
+// Lote em verificação: preenchido por quem chama, lido pelas threads
+static unsigned char mensagens[ASSINATURAS_MAX_LOTE][MENSAGEM_LEN];
+static unsigned char chavesLote[ASSINATURAS_MAX_LOTE][CHAVE_PUBLICA_LEN];
+static const unsigned char *assinaturasLote[ASSINATURAS_MAX_LOTE];
+static unsigned char resultadosLote[ASSINATURAS_MAX_LOTE];
+static int qtdLote = 0;
+static int proximoDoLote = 0;
+
+// Pool: mesmo esquema de execucao.c (geração anunciada, contagem de pendentes)
+static pthread_t trabalhadores[ASSINATURAS_MAX_THREADS];
+static int qtdThreads = 1;
+static pthread_mutex_t travaPool = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t condTrabalho = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t condFim = PTHREAD_COND_INITIALIZER;
+static unsigned long long geracao = 0;
+static unsigned long long geracaoDoPool = 0;
+static int pendentes = 0;
+static int encerrar = 0;
+
+static double tempo_ms(struct timespec inicio, struct timespec fim)
+{
+    return (fim.tv_sec - inicio.tv_sec) * 1000.0 + (fim.tv_nsec - inicio.tv_nsec) / 1e6;
+}
+
+static void montarMensagem(const TransacaoAssinada *t, unsigned char msg[MENSAGEM_LEN])
+{
+    gravarU32(msg, t->bloco);
+    gravarU32(msg + 4, t->slot);
+    gravarU32(msg + 8, t->tx.origem);
+    gravarU32(msg + 12, t->tx.destino);
+    gravarU32(msg + 16, t->tx.valor);
+}
+
+// CHAVES
+
+// Chave privada da conta: SHA-256(domínio | semente | conta)
+static EVP_PKEY *chavePrivada(unsigned int conta)
+{
+    unsigned int i = conta & (CHAVES_CACHE - 1);
+    if (contaChavePrivada[i] == conta + 1)
+        return chavesPrivadas[i];
+
+    unsigned char entrada[sizeof(dominioChave) + 8], semente[SHA256_DIGEST_LENGTH];
+    memcpy(entrada, dominioChave, sizeof(dominioChave));
+    gravarU32(entrada + sizeof(dominioChave), sementeChaves);
+    gravarU32(entrada + sizeof(dominioChave) + 4, conta);
+    SHA256(entrada, sizeof(entrada), semente);
+
+    EVP_PKEY *chave = EVP_PKEY_new_raw_private_key(EVP_PKEY_ED25519, NULL, semente, sizeof(semente));
+    if (chave == NULL)
+    {
+        fprintf(stderr, "ERRO: Falha ao derivar a chave Ed25519 da conta %u\n", conta);
+        exit(1);
+    }
+    EVP_PKEY_free(chavesPrivadas[i]);
+    chavesPrivadas[i] = chave;
+    contaChavePrivada[i] = conta + 1;
+    return chave;
+}
+
+// Chave pública registrada da conta (derivada uma vez e guardada)
+static const unsigned char *chavePublica(unsigned int conta)
+{
+    unsigned int i = conta & (CHAVES_CACHE - 1);
+    if (contaChavePublica[i] != conta + 1)
+    {
+        size_t tamanho = CHAVE_PUBLICA_LEN;
+        if (EVP_PKEY_get_raw_public_key(chavePrivada(conta), chavesPublicas[i], &tamanho) != 1)
+        {
+            fprintf(stderr, "ERRO: Falha ao obter a chave pública da conta %u\n", conta);
+            exit(1);
+        }
+        contaChavePublica[i] = conta + 1;
+    }
+    return chavesPublicas[i];
+}
+
+// CACHE DE VERIFICADAS
+
+static unsigned long long resumo(const unsigned char msg[MENSAGEM_LEN], const unsigned char *assinatura)
+{
+    unsigned char entrada[MENSAGEM_LEN + ASSINATURA_LEN], h[SHA256_DIGEST_LENGTH];
+    unsigned long long r;
+
+    memcpy(entrada, msg, MENSAGEM_LEN);
+    memcpy(entrada + MENSAGEM_LEN, assinatura, ASSINATURA_LEN);
+    SHA256(entrada, sizeof(entrada), h);
+    memcpy(&r, h, sizeof(r));
+    return r ? r : 1;
+}
+
+static int noCache(unsigned long long r)
+{
+    unsigned long long *conjunto = cacheVerificadas[r & (CONJUNTOS_CACHE - 1)];
+    for (int v = 0; v < VIAS_CACHE; v++)
+    {
+        if (conjunto[v] == r)
+            return 1;
+    }
+    return 0;
+}
+
+static void guardarNoCache(unsigned long long r)
+{
+    unsigned int c = r & (CONJUNTOS_CACHE - 1);
+    cacheVerificadas[c][proximaVia[c]] = r;
+    proximaVia[c] = (proximaVia[c] + 1) & (VIAS_CACHE - 1);
+}
+
+// VERIFICAÇÃO NO POOL
+
+static int verificarUma(EVP_MD_CTX *ctx, int i)
+{
+    EVP_PKEY *chave = EVP_PKEY_new_raw_public_key(EVP_PKEY_ED25519, NULL, chavesLote[i], CHAVE_PUBLICA_LEN);
+    int ok = chave != NULL &&
+             EVP_DigestVerifyInit(ctx, NULL, NULL, NULL, chave) == 1 &&
+             EVP_DigestVerify(ctx, assinaturasLote[i], ASSINATURA_LEN, mensagens[i], MENSAGEM_LEN) == 1;
+    EVP_PKEY_free(chave);
+    EVP_MD_CTX_reset(ctx);
+    return ok;
+}
+
+static void trabalhar()
+{
+    EVP_MD_CTX *ctx = EVP_MD_CTX_new();
+    if (ctx == NULL)
+    {
+        fprintf(stderr, "ERRO: Falha ao criar contexto de verificação\n");
+        exit(1);
+    }
+
+    int inicio;
+    while ((inicio = __atomic_fetch_add(&proximoDoLote, FATIA_THREAD, __ATOMIC_ACQ_REL)) < qtdLote)
+    {
+        int fim = inicio + FATIA_THREAD < qtdLote ? inicio + FATIA_THREAD : qtdLote;
+        for (int i = inicio; i < fim; i++)
+            resultadosLote[i] = (unsigned char)verificarUma(ctx, i);
+    }
+    EVP_MD_CTX_free(ctx);
+}
+
+static void *lacoTrabalhador(void *arg)
+{
+    (void)arg;
+    pthread_mutex_lock(&travaPool);
+    unsigned long long vista = geracaoDoPool;
+    for (;;)
+    {
+        while (geracao == vista && !encerrar)
+            pthread_cond_wait(&condTrabalho, &travaPool);
+        if (encerrar)
+            break;
+        vista = geracao;
+        pthread_mutex_unlock(&travaPool);
+
+        trabalhar();
+
+        pthread_mutex_lock(&travaPool);
+        if (--pendentes == 0)
+            pthread_cond_signal(&condFim);
+    }
+    pthread_mutex_unlock(&travaPool);
+    return NULL;
+}
+
+// Verifica as 'qtdLote' assinaturas montadas (resultado em resultadosLote)
+static void verificarMontado()
+{
+    proximoDoLote = 0;
+    if (qtdThreads > 1 && qtdLote > FATIA_THREAD)
+    {
+        pthread_mutex_lock(&travaPool);
+        pendentes = qtdThreads - 1;
+        geracao++;
+        pthread_cond_broadcast(&condTrabalho);
+        pthread_mutex_unlock(&travaPool);
+
+        trabalhar();
+
+        pthread_mutex_lock(&travaPool);
+        while (pendentes > 0)
+            pthread_cond_wait(&condFim, &travaPool);
+        pthread_mutex_unlock(&travaPool);
+    }
+    else
+        trabalhar();
+}
+
+// API
+
+static void encerrarPool()
+{
+    pthread_mutex_lock(&travaPool);
+    encerrar = 1;
+    pthread_cond_broadcast(&condTrabalho);
+    pthread_mutex_unlock(&travaPool);
+
+    for (int i = 0; i < qtdThreads - 1; i++)
+        pthread_join(trabalhadores[i], NULL);
+
+    pthread_mutex_lock(&travaPool);
+    encerrar = 0;
+    pthread_mutex_unlock(&travaPool);
+    qtdThreads = 1;
+}
+
+static void descartarChaves()
+{
+    for (int i = 0; i < CHAVES_CACHE; i++)
+    {
+        EVP_PKEY_free(chavesPrivadas[i]);
+        chavesPrivadas[i] = NULL;
+    }
+    memset(contaChavePrivada, 0, sizeof(contaChavePrivada));
+    memset(contaChavePublica, 0, sizeof(contaChavePublica));
+}
+
+/**
+ * Semente das chaves e pool de 'threads' threads no total (1 = só quem
+ * chama). Com a mesma semente, só o pool é trocado; outra semente descarta
+ * as chaves e o cache de verificadas.
+ */
+void assinaturasIniciar(unsigned int semente, int threads)
+{
+    encerrarPool();
+    if (semente != sementeChaves)
+    {
+        descartarChaves();
+        assinaturasLimparCache();
+        sementeChaves = semente;
+    }
+    if (threads < 1) threads = 1;
+    if (threads > ASSINATURAS_MAX_THREADS) threads = ASSINATURAS_MAX_THREADS;
+
+    pthread_mutex_lock(&travaPool);
+    geracaoDoPool = geracao;
+    pthread_mutex_unlock(&travaPool);
+    for (qtdThreads = 1; qtdThreads < threads; qtdThreads++)
+    {
+        if (pthread_create(&trabalhadores[qtdThreads - 1], NULL, lacoTrabalhador, NULL) != 0)
+        {
+            fprintf(stderr, "AVISO: pool de assinaturas com %d threads\n", qtdThreads);
+            break;
+        }
+    }
+}
+
+int assinaturasThreads()
+{
+    return qtdThreads;
+}
+
+// Núcleos que o pool ocupa de fato (as threads além dos núcleos online só se revezam)
+int assinaturasNucleos()
+{
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    return online > 0 && online < qtdThreads ? (int)online : qtdThreads;
+}
+
+void assinaturasFinalizar()
+{
+    encerrarPool();
+    descartarChaves();
+    assinaturasLimparCache();
+}
+
+// Assina com a chave da origem (carteira simulada)
+void assinarTransacao(TransacaoAssinada *t)
+{
+    unsigned char msg[MENSAGEM_LEN];
+    size_t tamanho = ASSINATURA_LEN;
+    EVP_MD_CTX *ctx = EVP_MD_CTX_new();
+
+    montarMensagem(t, msg);
+    if (ctx == NULL ||
+        EVP_DigestSignInit(ctx, NULL, NULL, NULL, chavePrivada(t->tx.origem)) != 1 ||
+        EVP_DigestSign(ctx, t->assinatura, &tamanho, msg, MENSAGEM_LEN) != 1)
+    {
+        fprintf(stderr, "ERRO: Falha ao assinar transação do bloco %u\n", t->bloco);
+        exit(1);
+    }
+    EVP_MD_CTX_free(ctx);
+}
+
+/**
+ * Confere as assinaturas de 'qtd' transações: validas[i] = 1 se a de i
+ * confere com a chave da origem. Retorna quantas conferem.
+ */
+int verificarLote(const TransacaoAssinada *txs, int qtd, unsigned char *validas)
+{
+    struct timespec t_start, t_end;
+    unsigned long long resumos[ASSINATURAS_MAX_LOTE];
+    int indices[ASSINATURAS_MAX_LOTE];
+    int aceitas = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &t_start);
+    for (int base = 0; base < qtd; base += ASSINATURAS_MAX_LOTE)
+    {
+        int n = qtd - base < ASSINATURAS_MAX_LOTE ? qtd - base : ASSINATURAS_MAX_LOTE;
+        unsigned long long emCache = 0;
+
+        qtdLote = 0;
+        for (int i = 0; i < n; i++)
+        {
+            const TransacaoAssinada *t = &txs[base + i];
+            int j = qtdLote;
+
+            montarMensagem(t, mensagens[j]);
+            resumos[j] = resumo(mensagens[j], t->assinatura);
+            if (noCache(resumos[j]))
+            {
+                validas[base + i] = 1;
+                emCache++;
+                continue;
+            }
+            memcpy(chavesLote[j], chavePublica(t->tx.origem), CHAVE_PUBLICA_LEN);
+            assinaturasLote[j] = t->assinatura;
+            indices[j] = base + i;
+            qtdLote++;
+        }
+
+        verificarMontado();
+
+        for (int j = 0; j < qtdLote; j++)
+        {
+            validas[indices[j]] = resultadosLote[j];
+            if (resultadosLote[j])
+                guardarNoCache(resumos[j]);
+            else
+                estatisticas.rejeitadas++;
+        }
+        aceitas += (int)emCache;
+        for (int j = 0; j < qtdLote; j++)
+            aceitas += resultadosLote[j];
+
+        estatisticas.verificadas += qtdLote;
+        estatisticas.emCache += emCache;
+        contadorSomar(CONTADOR_ASSINATURAS_VERIFICADAS, qtdLote);
+        contadorSomar(CONTADOR_ASSINATURAS_EM_CACHE, emCache);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t_end);
+    estatisticas.msVerificacao += tempo_ms(t_start, t_end);
+    return aceitas;
+}
+
+/**
+ * Assina as transações do bloco 'numero': assinaturas[slot] para cada
+ * transferência (vagas ficam zeradas). Retorna quantas foram assinadas.
+ */
+unsigned int assinarBloco(const unsigned char data[DATA_SIZE], int v2, unsigned int numero, unsigned char assinaturas[][ASSINATURA_LEN])
+{
+    TransacaoAssinada t;
+    unsigned int qtd = 0;
+
+    t.bloco = numero;
+    for (int slot = 0; numero > 1 && slot < formatoMaxTransacoes(v2); slot++)
+    {
+        int tipo = formatoLerTransacao(data, v2, slot, &t.tx);
+        if (tipo < 0)
+            break;
+        if (tipo == 0)
+        {
+            memset(assinaturas[slot], 0, ASSINATURA_LEN);
+            continue;
+        }
+        t.slot = (unsigned int)slot;
+        assinarTransacao(&t);
+        memcpy(assinaturas[slot], t.assinatura, ASSINATURA_LEN);
+        qtd++;
+    }
+    return qtd;
+}
+
+// 1 se todas as transferências do bloco têm assinatura válida (o gênesis não tem transações)
+int verificarAssinaturasBloco(const unsigned char data[DATA_SIZE], int v2, unsigned int numero, const unsigned char assinaturas[][ASSINATURA_LEN])
+{
+    TransacaoAssinada txs[V1_MAX_TRANSACOES];
+    unsigned char validas[V1_MAX_TRANSACOES];
+    int qtd = 0;
+
+    for (int slot = 0; numero > 1 && slot < formatoMaxTransacoes(v2); slot++)
+    {
+        TransacaoAssinada *t = &txs[qtd];
+        int tipo = formatoLerTransacao(data, v2, slot, &t->tx);
+        if (tipo < 0)
+            break;
+        if (tipo == 0)
+            continue;
+        t->bloco = numero;
+        t->slot = (unsigned int)slot;
+        memcpy(t->assinatura, assinaturas[slot], ASSINATURA_LEN);
+        qtd++;
+    }
+    return verificarLote(txs, qtd, validas) == qtd;
+}
+
+void assinaturasLimparCache()
+{
+    memset(cacheVerificadas, 0, sizeof(cacheVerificadas));
+    memset(proximaVia, 0, sizeof(proximaVia));
+}
+
+void assinaturasEstatisticas(EstatisticasAssinaturas *saida)
+{
+    *saida = estatisticas;
+}
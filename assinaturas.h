@@ -0,0 +1,54 @@
+#ifndef ASSINATURAS_H
+#define ASSINATURAS_H
+
+#include "formato.h"
+
+/**
+ * Transações assinadas (Ed25519, pelo OpenSSL)
+ *
+ * O registro de 184 bytes não tem espaço para assinaturas, então elas
+ * acompanham o bloco na submissão (uma por slot, como testemunhas) e são
+ * conferidas antes de o bloco chegar ao ledger; o .bin continua o mesmo.
+ *
+ * Mensagem assinada (20 bytes, little-endian): bloco | slot | origem |
+ * destino | valor. Bloco e slot impedem reaproveitar a assinatura em outra
+ * posição. A chave de cada conta é derivada da semente da simulação (as
+ * carteiras são simuladas); a verificação usa só a chave pública.
+ *
+ * Verificação em lote: as assinaturas de um bloco passam primeiro pelo
+ * cache de já verificadas e as restantes são divididas entre as threads do
+ * pool. Só a thread que chama mexe no cache e nas chaves públicas.
+ */
+#define ASSINATURA_LEN 64
+#define CHAVE_PUBLICA_LEN 32
+#define ASSINATURAS_MAX_THREADS 64
+#define ASSINATURAS_MAX_LOTE 4096
+
+typedef struct {
+    TransacaoConta tx;
+    unsigned int bloco;
+    unsigned int slot;
+    unsigned char assinatura[ASSINATURA_LEN];
+} TransacaoAssinada;
+
+typedef struct {
+    unsigned long long verificadas;     // Passaram pela verificação Ed25519
+    unsigned long long emCache;         // Aceitas pelo cache, sem verificar de novo
+    unsigned long long rejeitadas;
+    double msVerificacao;               // Tempo de parede dos lotes (cache incluso)
+} EstatisticasAssinaturas;
+
+void assinaturasIniciar(unsigned int semente, int threads);
+int assinaturasThreads();
+int assinaturasNucleos();
+void assinaturasFinalizar();
+
+void assinarTransacao(TransacaoAssinada *t);
+int verificarLote(const TransacaoAssinada *txs, int qtd, unsigned char *validas);
+unsigned int assinarBloco(const unsigned char data[DATA_SIZE], int v2, unsigned int numero, unsigned char assinaturas[][ASSINATURA_LEN]);
+int verificarAssinaturasBloco(const unsigned char data[DATA_SIZE], int v2, unsigned int numero, const unsigned char assinaturas[][ASSINATURA_LEN]);
+
+void assinaturasLimparCache();
+void assinaturasEstatisticas(EstatisticasAssinaturas *saida);
+
+#endif
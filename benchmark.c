@@ -0,0 +1,695 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "mtwister.h"
+#include "structs.h"
+#include "miner.h"
+#include "transactions.h"
+#include "storage.h"
+#include "fork.h"
+#include "mempool.h"
+#include "philox.h"
+#include "contas.h"
+#include "execucao.h"
+#include "assinaturas.h"
+#include "sincronizacao.h"
+
+// Benchmarks: reorganizações de profundidade crescente, latência de consultas sob mineração, mempool, contas v2,
+// execução otimista e verificação de assinaturas
+
+#define ARQUIVO_BENCHMARK "benchmark.bin"
+#define BLOCOS_BASE 3000
+#define MINERADOR_OFFSET 183
+#define BLOCOS_CARGA 3000           // Blocos minerados em paralelo às consultas
+#define CONSULTAS_OCIOSO 2000       // Rodadas de consultas sem mineração
+#define MAX_AMOSTRAS 200000
+#define TIPOS_CONSULTA 4
+#define ADMISSOES_MEMPOOL 240000    // Tentativas de admissão divididas entre os geradores
+#define BLOCOS_MEMPOOL 300          // Blocos montados do mempool com os geradores ativos
+#define GERADORES_CONTINUOS 2
+#define BLOCOS_CONTAS 3000          // Cadeia v2 minerada para cada espaço de contas
+#define CONSULTAS_CONTAS 1000000    // Saldos aleatórios lidos por espaço de contas
+#define TOPO_CONTAS 10
+#define BLOCOS_EXECUCAO 2000        // Blocos sintéticos de 64 transações por configuração
+#define TX_ASSINADAS 4000           // Transações assinadas verificadas por quantidade de threads
+#define CONTAS_ASSINANTES 1000
+#define BLOCOS_ASSINADOS 50         // Cadeia v1 submetida com assinaturas
+
+static const unsigned int profundidades[] = {1, 10, 100, 500, 1000};
+static const unsigned int espacosContas[] = {1000000, 16000000};
+static const unsigned int contencoes[] = {8, 1000, 1000000};   // Contas sorteadas: menos contas, mais conflitos
+static const int threadsExecucao[] = {1, 2, 4, 8};
+static const int threadsAssinaturas[] = {1, 2, 4, 8};
+
+static double tempo_ms(struct timespec inicio, struct timespec fim) {
+    return (fim.tv_sec - inicio.tv_sec) * 1000.0 + (fim.tv_nsec - inicio.tv_nsec) / 1e6;
+}
+
+static void removerArquivosBenchmark() {
+    remove("benchmark.bin");
+    remove("benchmark.hdr");
+    remove("benchmark.txt");
+    remove("benchmark.idx");
+}
+
+// Minera 'qtd' blocos sem transações sobre 'base'; só o minerador varia entre ramos
+static void minerarRamo(BlocoMinerado base, unsigned int qtd, unsigned char minerador, BlocoMinerado *saida) {
+    unsigned char dados[184];
+    memset(dados, 0, sizeof(dados));
+    dados[MINERADOR_OFFSET] = minerador;
+
+    for (unsigned int i = 0; i < qtd; i++) {
+        saida[i] = criarProxBloco(base, base.bloco.numero + 1, dados, 0);
+        base = saida[i];
+    }
+}
+
+// Submete o ramo; retorna o tempo (ms) da submissão que disparou a reorganização
+static double submeterRamo(BlocoMinerado *ramo, unsigned int qtd) {
+    struct timespec t_start, t_end;
+    double tempo = -1.0;
+
+    for (unsigned int i = 0; i < qtd; i++) {
+        clock_gettime(CLOCK_MONOTONIC, &t_start);
+        int resultado = submeterBloco(&ramo[i]);
+        clock_gettime(CLOCK_MONOTONIC, &t_end);
+
+        if (resultado == SUBMISSAO_REORG)
+            tempo = tempo_ms(t_start, t_end);
+        else if (resultado != SUBMISSAO_LATERAL && resultado != SUBMISSAO_CONECTADO)
+            printf("AVISO: bloco %u rejeitado (código %d)\n", ramo[i].bloco.numero, resultado);
+    }
+    return tempo;
+}
+
+// LATÊNCIA SOB CARGA
+
+static const char *nomesConsulta[TIPOS_CONSULTA] = {
+    "Instantâneo (seqlock)", "Bloco por ID", "Bloco por hash (trava)", "Saldos na altura (trava)"
+};
+
+typedef struct {
+    double *amostras[TIPOS_CONSULTA];
+    unsigned int qtd[TIPOS_CONSULTA];
+} Latencias;
+
+static int mineradorAtivo = 0;
+
+static void *minerarCarga(void *arg) {
+    MTRand *r = arg;
+    unsigned char dados[184];
+    BlocoMinerado anterior;
+
+    buscarBlocoPorId(obterTotalBlocos(), &anterior);
+    for (unsigned int i = 0; i < BLOCOS_CARGA; i++) {
+        gerarDadosDoBloco(anterior.bloco.numero + 1, dados, NULL, r);
+        BlocoMinerado novo = criarProxBloco(anterior, anterior.bloco.numero + 1, dados, 0);
+        submeterBloco(&novo);
+        anterior = novo;
+    }
+    __atomic_store_n(&mineradorAtivo, 0, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+// Uma rodada: um exemplar de cada tipo de consulta, sobre alvos aleatórios
+static void rodadaConsultas(MTRand *r, Latencias *lat) {
+    struct timespec t_start, t_end;
+    InstantaneoEstatisticas inst;
+    BlocoMinerado b;
+    unsigned int saldosAltura[256];
+    unsigned int total = obterTotalBlocos();
+
+    for (int tipo = 0; tipo < TIPOS_CONSULTA; tipo++) {
+        unsigned int id = 1 + (unsigned int)(genRandLong(r) % total);
+        if (tipo == 2)
+            buscarBlocoPorId(id, &b);
+
+        clock_gettime(CLOCK_MONOTONIC, &t_start);
+        switch (tipo) {
+            case 0: obterInstantaneo(&inst); break;
+            case 1: buscarBlocoPorId(id, &b); break;
+            case 2: localizarBlocoPorHash(b.hash); break;
+            case 3: saldosNaAltura(id, saldosAltura); break;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &t_end);
+
+        if (lat->qtd[tipo] < MAX_AMOSTRAS)
+            lat->amostras[tipo][lat->qtd[tipo]++] = tempo_ms(t_start, t_end) * 1000.0;
+    }
+}
+
+static int compararDouble(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static void imprimirLatencias(const char *titulo, Latencias *lat) {
+    printf("\n%s\n", titulo);
+    printf("%-26s %-10s %-10s %-10s %-10s\n", "Consulta", "Amostras", "p50 (us)", "p99 (us)", "max (us)");
+    for (int tipo = 0; tipo < TIPOS_CONSULTA; tipo++) {
+        unsigned int n = lat->qtd[tipo];
+        if (n == 0) continue;
+        qsort(lat->amostras[tipo], n, sizeof(double), compararDouble);
+        printf("%-26s %-10u %-10.2f %-10.2f %-10.2f\n", nomesConsulta[tipo], n,
+               lat->amostras[tipo][n / 2], lat->amostras[tipo][(unsigned int)(n * 0.99)], lat->amostras[tipo][n - 1]);
+    }
+}
+
+static void benchmarkLatencia() {
+    MTRand rConsultas = seedRand(42);
+    MTRand rMineracao = seedRand(7654321);
+    Latencias ocioso = {0}, carga = {0};
+    struct timespec t_start, t_end;
+    pthread_t minerador;
+
+    for (int tipo = 0; tipo < TIPOS_CONSULTA; tipo++) {
+        ocioso.amostras[tipo] = verifica_malloc(MAX_AMOSTRAS * sizeof(double), "benchmarkLatencia");
+        carga.amostras[tipo] = verifica_malloc(MAX_AMOSTRAS * sizeof(double), "benchmarkLatencia");
+    }
+
+    for (int i = 0; i < CONSULTAS_OCIOSO; i++)
+        rodadaConsultas(&rConsultas, &ocioso);
+
+    // Mineração em outra thread enquanto esta consulta sem parar
+    unsigned int antes = obterTotalBlocos();
+    __atomic_store_n(&mineradorAtivo, 1, __ATOMIC_RELEASE);
+    clock_gettime(CLOCK_MONOTONIC, &t_start);
+    pthread_create(&minerador, NULL, minerarCarga, &rMineracao);
+    while (__atomic_load_n(&mineradorAtivo, __ATOMIC_ACQUIRE))
+        rodadaConsultas(&rConsultas, &carga);
+    pthread_join(minerador, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &t_end);
+
+    imprimirLatencias("--- Latência de consultas sem mineração ---", &ocioso);
+    imprimirLatencias("--- Latência de consultas durante a mineração ---", &carga);
+    printf("Mineração concorrente: %u blocos em %.1f ms\n", obterTotalBlocos() - antes, tempo_ms(t_start, t_end));
+
+    for (int tipo = 0; tipo < TIPOS_CONSULTA; tipo++) {
+        free(ocioso.amostras[tipo]);
+        free(carga.amostras[tipo]);
+    }
+}
+
+// MEMPOOL
+
+static const unsigned int qtdGeradores[] = {1, 2, 4};
+
+typedef struct {
+    unsigned int id;
+    unsigned long long tentativas;      // 0 = até geradoresAtivos cair
+    unsigned long long feitas;
+    unsigned long long aceitas;
+} Gerador;
+
+static int geradoresAtivos = 0;
+
+// Transações aleatórias (fluxo Philox próprio por thread) admitidas sem pausa
+static void *gerarTransacoes(void *arg) {
+    Gerador *g = arg;
+    FluxoPhilox fluxo;
+    philoxIniciarFluxo(&fluxo, 99, g->id);
+
+    while (g->tentativas ? g->feitas < g->tentativas : __atomic_load_n(&geradoresAtivos, __ATOMIC_ACQUIRE)) {
+        TransacaoPendente tx;
+        tx.origem = (unsigned char)sorteioLimitado(philoxProximo(&fluxo), 256);
+        tx.destino = (unsigned char)sorteioLimitado(philoxProximo(&fluxo), 256);
+        tx.valor = (unsigned char)(1 + sorteioLimitado(philoxProximo(&fluxo), 50));
+        tx.taxa = (unsigned char)sorteioLimitado(philoxProximo(&fluxo), 256);
+        if (mempoolAdmitir(&tx) == MEMPOOL_ACEITA)
+            g->aceitas++;
+        g->feitas++;
+    }
+    return NULL;
+}
+
+static int benchmarkMempool() {
+    InstantaneoEstatisticas inst;
+    EstatisticasMempool est;
+    struct timespec t_start, t_end;
+    pthread_t threads[4];
+    Gerador geradores[4];
+    int falhas = 0;
+
+    // Admissão: pool vazio, tentativas fixas divididas entre os geradores
+    printf("\n--- Admissão no mempool (%d tentativas) ---\n", ADMISSOES_MEMPOOL);
+    printf("%-9s %-10s %-13s %-12s %-12s %-10s\n", "Threads", "Aceitas", "Conflito", "Sem saldo", "Mtx/s", "ns/tx");
+    for (size_t c = 0; c < sizeof(qtdGeradores) / sizeof(qtdGeradores[0]); c++) {
+        unsigned int t = qtdGeradores[c];
+        obterInstantaneo(&inst);
+        mempoolInicializar(inst.saldos);
+
+        clock_gettime(CLOCK_MONOTONIC, &t_start);
+        for (unsigned int i = 0; i < t; i++) {
+            geradores[i] = (Gerador){.id = i, .tentativas = ADMISSOES_MEMPOOL / t};
+            pthread_create(&threads[i], NULL, gerarTransacoes, &geradores[i]);
+        }
+        for (unsigned int i = 0; i < t; i++)
+            pthread_join(threads[i], NULL);
+        clock_gettime(CLOCK_MONOTONIC, &t_end);
+
+        double ms = tempo_ms(t_start, t_end);
+        mempoolEstatisticas(&est);
+        unsigned long long total = est.aceitas + est.rejeitadas[MEMPOOL_CONFLITO] +
+                                   est.rejeitadas[MEMPOOL_SALDO_INSUFICIENTE] + est.rejeitadas[MEMPOOL_CHEIO];
+        printf("%-9u %-10llu %-13llu %-12llu %-12.2f %-10.1f\n", t, est.aceitas, est.rejeitadas[MEMPOOL_CONFLITO],
+               est.rejeitadas[MEMPOOL_SALDO_INSUFICIENTE], total / ms / 1000.0, ms * 1e6 / total);
+    }
+
+    // Modelos: o pool cheio da última rodada continua recebendo transações enquanto os blocos saem dele
+    double *latencias = verifica_malloc(BLOCOS_MEMPOOL * sizeof(double), "benchmarkMempool");
+    unsigned long long txIncluidas = 0;
+    unsigned int divergentes = 0;
+    BlocoMinerado anterior;
+    ModeloBloco modelo;
+
+    __atomic_store_n(&geradoresAtivos, 1, __ATOMIC_RELEASE);
+    for (unsigned int i = 0; i < GERADORES_CONTINUOS; i++) {
+        geradores[i] = (Gerador){.id = 100 + i};
+        pthread_create(&threads[i], NULL, gerarTransacoes, &geradores[i]);
+    }
+
+    buscarBlocoPorId(obterTotalBlocos(), &anterior);
+    for (unsigned int b = 0; b < BLOCOS_MEMPOOL; b++) {
+        clock_gettime(CLOCK_MONOTONIC, &t_start);
+        unsigned int qtd = mempoolMontarModelo((unsigned char)b, &modelo);
+        clock_gettime(CLOCK_MONOTONIC, &t_end);
+        latencias[b] = tempo_ms(t_start, t_end) * 1000.0;
+
+        BlocoMinerado novo = criarProxBloco(anterior, anterior.bloco.numero + 1, modelo.dados, 0);
+        if (submeterBloco(&novo) != SUBMISSAO_CONECTADO) {
+            obterInstantaneo(&inst);
+            mempoolResincronizar(inst.saldos);
+            continue;
+        }
+        mempoolConfirmarModelo(&modelo);
+        if (contagemTransacoes(novo.bloco.numero) != (int)qtd)
+            divergentes++;
+        txIncluidas += qtd;
+        anterior = novo;
+    }
+
+    __atomic_store_n(&geradoresAtivos, 0, __ATOMIC_RELEASE);
+    unsigned long long admitidasDurante = 0;
+    for (unsigned int i = 0; i < GERADORES_CONTINUOS; i++) {
+        pthread_join(threads[i], NULL);
+        admitidasDurante += geradores[i].feitas;
+    }
+
+    // Ledger do mempool em dia com a cadeia: resincronizar não pode remover nada
+    mempoolEstatisticas(&est);
+    unsigned long long removidasAntes = est.removidasResincronizacao;
+    obterInstantaneo(&inst);
+    mempoolResincronizar(inst.saldos);
+    mempoolEstatisticas(&est);
+
+    qsort(latencias, BLOCOS_MEMPOOL, sizeof(double), compararDouble);
+    printf("\n--- Modelo de bloco a partir do mempool (%d blocos, %d geradores ativos) ---\n", BLOCOS_MEMPOOL,
+           GERADORES_CONTINUOS);
+    printf("Montagem: p50 %.2f us, p99 %.2f us, max %.2f us\n", latencias[BLOCOS_MEMPOOL / 2],
+           latencias[(unsigned int)(BLOCOS_MEMPOOL * 0.99)], latencias[BLOCOS_MEMPOOL - 1]);
+    printf("Transações por bloco: %.1f | admissões tentadas no período: %llu | pendentes no fim: %u\n",
+           (double)txIncluidas / BLOCOS_MEMPOOL, admitidasDurante, est.pendentes);
+    if (divergentes > 0 || est.removidasResincronizacao != removidasAntes) {
+        printf("ERRO: %u blocos com contagem diferente do modelo, %llu pendentes inválidas\n", divergentes,
+               est.removidasResincronizacao - removidasAntes);
+        falhas++;
+    }
+
+    free(latencias);
+    mempoolLiberar();
+    return falhas;
+}
+
+// CONTAS V2
+
+/**
+ * Estado de contas direto, sem cadeia: crédito em todas as contas (todas as
+ * páginas alocadas), transferências aleatórias e o pior caso de memória.
+ */
+static void benchmarkEstadoContas(unsigned int qtd, MTRand *r) {
+    struct timespec t_start, t_end;
+
+    contasInicializar(qtd);
+    clock_gettime(CLOCK_MONOTONIC, &t_start);
+    for (unsigned int c = 0; c < qtd; c++)
+        contasCreditar(c, 50);
+    clock_gettime(CLOCK_MONOTONIC, &t_end);
+    double nsCredito = tempo_ms(t_start, t_end) * 1e6 / qtd;
+
+    unsigned long long falhas = 0;
+    clock_gettime(CLOCK_MONOTONIC, &t_start);
+    for (unsigned int i = 0; i < qtd; i++) {
+        unsigned int origem = (unsigned int)(genRandLong(r) % qtd);
+        unsigned int destino = (unsigned int)(genRandLong(r) % qtd);
+        unsigned int valor = 1 + (unsigned int)(genRandLong(r) % 50);
+        if (contasDebitar(origem, valor))
+            contasCreditar(destino, valor);
+        else
+            falhas++;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t_end);
+
+    printf("Estado direto: crédito %.1f ns/conta | transferência %.1f ns (%llu sem saldo) | %u com saldo | %.1f MB\n",
+           nsCredito, tempo_ms(t_start, t_end) * 1e6 / qtd, falhas, contasComSaldo(), contasMemoria() / 1048576.0);
+    contasLiberar();
+    rcuSincronizar();
+}
+
+// Cadeia v2 com 'qtd' contas: mineração, consultas por conta, relatórios e recarga do disco
+static int benchmarkCadeiaContas(unsigned int qtd, MTRand *r) {
+    struct timespec t_start, t_end;
+    unsigned char dados[184];
+    int falhas = 0;
+
+    removerArquivosBenchmark();
+    definirContasV2(qtd);
+    inicializarStorage(ARQUIVO_BENCHMARK);
+
+    clock_gettime(CLOCK_MONOTONIC, &t_start);
+    gerarDadosDoBlocoContas(1, dados, r);
+    BlocoMinerado anterior = criarBlocoGenesis(dados);
+    adicionarBloco(&anterior);
+    for (unsigned int i = 2; i <= BLOCOS_CONTAS; i++) {
+        gerarDadosDoBlocoContas(i, dados, r);
+        BlocoMinerado novo = criarProxBloco(anterior, i, dados, 1);
+        adicionarBloco(&novo);
+        anterior = novo;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t_end);
+    printf("Mineração: %u blocos em %.1f ms (%.0f blocos/s) | %u contas com saldo | estado %.1f MB\n", BLOCOS_CONTAS,
+           tempo_ms(t_start, t_end), BLOCOS_CONTAS / (tempo_ms(t_start, t_end) / 1000.0), contasComSaldo(),
+           contasMemoria() / 1048576.0);
+
+    unsigned long long soma = 0;
+    clock_gettime(CLOCK_MONOTONIC, &t_start);
+    for (unsigned int i = 0; i < CONSULTAS_CONTAS; i++)
+        soma += getSaldoConta((unsigned int)(genRandLong(r) % qtd));
+    clock_gettime(CLOCK_MONOTONIC, &t_end);
+    printf("Saldo por conta: %.1f ns (soma %llu)\n", tempo_ms(t_start, t_end) * 1e6 / CONSULTAS_CONTAS, soma);
+
+    unsigned int enderecos[TOPO_CONTAS], valores[TOPO_CONTAS], blocos;
+    clock_gettime(CLOCK_MONOTONIC, &t_start);
+    unsigned int qtdTopo = maioresSaldos(TOPO_CONTAS, enderecos, valores);
+    clock_gettime(CLOCK_MONOTONIC, &t_end);
+    printf("Top %u saldos: %.3f ms (maior: conta %u com %u BTC)\n", TOPO_CONTAS, tempo_ms(t_start, t_end),
+           qtdTopo > 0 ? enderecos[0] : 0, qtdTopo > 0 ? valores[0] : 0);
+
+    clock_gettime(CLOCK_MONOTONIC, &t_start);
+    unsigned int empatados = maioresMineradores(enderecos, TOPO_CONTAS, &blocos);
+    clock_gettime(CLOCK_MONOTONIC, &t_end);
+    printf("Maiores mineradores: %.3f ms (%u empatados com %u blocos)\n", tempo_ms(t_start, t_end), empatados, blocos);
+
+    clock_gettime(CLOCK_MONOTONIC, &t_start);
+    recarregarIndicesDoDisco();
+    clock_gettime(CLOCK_MONOTONIC, &t_end);
+    printf("Recarga do disco: %.1f ms\n", tempo_ms(t_start, t_end));
+
+    unsigned int valoresRecarga[TOPO_CONTAS];
+    if (maioresSaldos(TOPO_CONTAS, enderecos, valoresRecarga) != qtdTopo || memcmp(valores, valoresRecarga, qtdTopo * sizeof(unsigned int)) != 0) {
+        printf("ERRO: saldos diferentes depois da recarga\n");
+        falhas++;
+    }
+
+    definirModoCadeiaGrande(1);     // Sem exportar texto
+    finalizarStorage();
+    definirModoCadeiaGrande(0);
+    definirContasV2(0);
+    removerArquivosBenchmark();
+    return falhas;
+}
+
+static int benchmarkContas() {
+    MTRand r = seedRand(24680);
+    int falhas = 0;
+
+    for (size_t i = 0; i < sizeof(espacosContas) / sizeof(espacosContas[0]); i++) {
+        printf("\n--- Contas v2: %u contas ---\n", espacosContas[i]);
+        benchmarkEstadoContas(espacosContas[i], &r);
+        falhas += benchmarkCadeiaContas(espacosContas[i], &r);
+    }
+    return falhas;
+}
+
+// EXECUÇÃO OTIMISTA
+
+static unsigned int saldoDoVetor(unsigned int conta, void *contexto) {
+    return ((unsigned int *)contexto)[conta];
+}
+
+/**
+ * Blocos sintéticos de 64 transações entre 'qtd' contas, com saldos baixos
+ * para que parte delas seja rejeitada. Cada bloco é executado no pool e a
+ * máscara de válidas é comparada com a execução em série.
+ */
+static int benchmarkExecucao() {
+    MTRand r = seedRand(97531);
+    TransacaoConta *tx = verifica_malloc(BLOCOS_EXECUCAO * EXECUCAO_MAX_TX * sizeof(TransacaoConta), "benchmark");
+    unsigned long long *esperadas = verifica_malloc(BLOCOS_EXECUCAO * sizeof(unsigned long long), "benchmark");
+    struct timespec t_start, t_end;
+    int falhas = 0;
+
+    printf("\n--- Execução otimista: %d blocos de %d transações ---\n", BLOCOS_EXECUCAO, EXECUCAO_MAX_TX);
+    printf("%-10s %-8s %-12s %-12s %-10s %-10s\n", "Contas", "Threads", "us/bloco", "Exec/tx", "Abortos", "Esperas");
+    for (size_t c = 0; c < sizeof(contencoes) / sizeof(contencoes[0]); c++) {
+        unsigned int qtd = contencoes[c];
+        unsigned int *saldos = verifica_malloc(qtd * sizeof(unsigned int), "benchmark");
+        for (unsigned int i = 0; i < qtd; i++)
+            saldos[i] = (unsigned int)(genRandLong(&r) % 100);
+
+        // Destino fora do espaço em ~1% das transações: inválidas sem leitura
+        for (unsigned int i = 0; i < BLOCOS_EXECUCAO * EXECUCAO_MAX_TX; i++) {
+            tx[i].origem = (unsigned int)(genRandLong(&r) % qtd);
+            tx[i].destino = genRandLong(&r) % 100 == 0 ? qtd : (unsigned int)(genRandLong(&r) % qtd);
+            tx[i].valor = 1 + (unsigned int)(genRandLong(&r) % 60);
+        }
+        for (unsigned int b = 0; b < BLOCOS_EXECUCAO; b++)
+            esperadas[b] = executarEmSerie(&tx[b * EXECUCAO_MAX_TX], EXECUCAO_MAX_TX, qtd, saldoDoVetor, saldos);
+
+        for (size_t t = 0; t < sizeof(threadsExecucao) / sizeof(threadsExecucao[0]); t++) {
+            int threads = execucaoIniciar(threadsExecucao[t]);
+            unsigned long long execucoes = 0, abortos = 0, dependencias = 0;
+            unsigned int divergentes = 0;
+
+            clock_gettime(CLOCK_MONOTONIC, &t_start);
+            for (unsigned int b = 0; b < BLOCOS_EXECUCAO; b++) {
+                ResultadoExecucao res;
+                executarOtimista(&tx[b * EXECUCAO_MAX_TX], EXECUCAO_MAX_TX, qtd, saldoDoVetor, saldos, &res);
+                if (res.validas != esperadas[b])
+                    divergentes++;
+                execucoes += res.execucoes;
+                abortos += res.abortos;
+                dependencias += res.dependencias;
+            }
+            clock_gettime(CLOCK_MONOTONIC, &t_end);
+
+            printf("%-10u %-8d %-12.2f %-12.3f %-10llu %-10llu\n", qtd, threads,
+                   tempo_ms(t_start, t_end) * 1000.0 / BLOCOS_EXECUCAO,
+                   (double)execucoes / (BLOCOS_EXECUCAO * EXECUCAO_MAX_TX), abortos, dependencias);
+            if (divergentes > 0) {
+                printf("ERRO: %u blocos com válidas diferentes da execução em série\n", divergentes);
+                falhas++;
+            }
+        }
+        free(saldos);
+    }
+
+    execucaoFinalizar();
+    free(esperadas);
+    free(tx);
+    return falhas;
+}
+
+// ASSINATURAS
+
+// Verifica o lote inteiro e confere que só as adulteradas foram recusadas; retorna o tempo em ms
+static double verificarEConferir(TransacaoAssinada *txs, const unsigned char *adulterada, unsigned char *validas, int *erros) {
+    struct timespec t_start, t_end;
+
+    clock_gettime(CLOCK_MONOTONIC, &t_start);
+    verificarLote(txs, TX_ASSINADAS, validas);
+    clock_gettime(CLOCK_MONOTONIC, &t_end);
+    for (int i = 0; i < TX_ASSINADAS; i++) {
+        if (validas[i] == adulterada[i])
+            (*erros)++;
+    }
+    return tempo_ms(t_start, t_end);
+}
+
+/**
+ * Assinaturas por segundo (total e por núcleo) com 1 a 8 threads, a mesma
+ * passada com o cache de verificadas cheio, e uma cadeia submetida com
+ * assinaturas: um bloco com uma assinatura trocada é recusado e, corrigido,
+ * entra verificando só a que faltava.
+ */
+static int benchmarkAssinaturas() {
+    MTRand r = seedRand(13579);
+    TransacaoAssinada *txs = verifica_malloc(TX_ASSINADAS * sizeof(TransacaoAssinada), "benchmark");
+    unsigned char *adulterada = verifica_malloc(TX_ASSINADAS, "benchmark");
+    unsigned char *validas = verifica_malloc(TX_ASSINADAS, "benchmark");
+    struct timespec t_start, t_end;
+    EstatisticasAssinaturas antes, depois;
+    int falhas = 0, erros = 0;
+
+    printf("\n--- Assinaturas Ed25519: %d transações entre %d contas ---\n", TX_ASSINADAS, CONTAS_ASSINANTES);
+    assinaturasIniciar(97531, 1);
+    clock_gettime(CLOCK_MONOTONIC, &t_start);
+    for (int i = 0; i < TX_ASSINADAS; i++) {
+        txs[i].tx.origem = (unsigned int)(genRandLong(&r) % CONTAS_ASSINANTES);
+        txs[i].tx.destino = (unsigned int)(genRandLong(&r) % CONTAS_ASSINANTES);
+        txs[i].tx.valor = 1 + (unsigned int)(genRandLong(&r) % 50);
+        txs[i].bloco = 2 + i / V2_MAX_TRANSACOES;
+        txs[i].slot = i % V2_MAX_TRANSACOES;
+        assinarTransacao(&txs[i]);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t_end);
+    printf("Assinatura: %.0f/s (chaves das %d contas derivadas na primeira)\n",
+           TX_ASSINADAS / (tempo_ms(t_start, t_end) / 1000.0), CONTAS_ASSINANTES);
+
+    // ~1% adulteradas: assinatura com um bit trocado ou valor alterado depois de assinar
+    for (int i = 0; i < TX_ASSINADAS; i++) {
+        adulterada[i] = genRandLong(&r) % 100 == 0;
+        if (adulterada[i] && i % 2)
+            txs[i].assinatura[genRandLong(&r) % ASSINATURA_LEN] ^= 1;
+        else if (adulterada[i])
+            txs[i].tx.valor++;
+    }
+
+    printf("%-8s %-8s %-14s %-14s\n", "Threads", "Núcleos", "Assinat./s", "Por núcleo");
+    for (size_t t = 0; t < sizeof(threadsAssinaturas) / sizeof(threadsAssinaturas[0]); t++) {
+        assinaturasIniciar(97531, threadsAssinaturas[t]);
+        assinaturasLimparCache();
+        double ms = verificarEConferir(txs, adulterada, validas, &erros);
+        printf("%-8d %-8d %-14.0f %-14.0f\n", assinaturasThreads(), assinaturasNucleos(),
+               TX_ASSINADAS / (ms / 1000.0), TX_ASSINADAS / (ms / 1000.0) / assinaturasNucleos());
+    }
+
+    assinaturasEstatisticas(&antes);
+    double ms = verificarEConferir(txs, adulterada, validas, &erros);
+    assinaturasEstatisticas(&depois);
+    printf("Com o cache cheio: %.0f/s (%llu pelo cache, %llu verificadas de novo: as adulteradas)\n",
+           TX_ASSINADAS / (ms / 1000.0), depois.emCache - antes.emCache, depois.verificadas - antes.verificadas);
+    if (erros > 0) {
+        printf("ERRO: %d resultados de verificação errados\n", erros);
+        falhas++;
+    }
+
+    // Cadeia v1 submetida com assinaturas
+    unsigned char dados[184], assinaturas[V1_MAX_TRANSACOES][ASSINATURA_LEN];
+    removerArquivosBenchmark();
+    inicializarStorage(ARQUIVO_BENCHMARK);
+    gerarDadosDoBloco(1, dados, NULL, &r);
+    BlocoMinerado anterior = criarBlocoGenesis(dados);
+    submeterBloco(&anterior);
+    for (unsigned int i = 2; i <= BLOCOS_ASSINADOS; i++) {
+        gerarDadosDoBloco(i, dados, NULL, &r);
+        unsigned int qtd = assinarBloco(dados, 0, i, assinaturas);
+        BlocoMinerado novo = criarProxBloco(anterior, i, dados, 0);
+
+        if (i == BLOCOS_ASSINADOS && qtd > 0) {
+            // Troca a assinatura da primeira transferência (vagas do v1 não têm assinatura)
+            TransacaoConta tx;
+            int slot = 0;
+            while (formatoLerTransacao(dados, 0, slot, &tx) == 0)
+                slot++;
+            assinaturasEstatisticas(&antes);
+            assinaturas[slot][0] ^= 1;
+            if (submeterBlocoAssinado(&novo, assinaturas) != SUBMISSAO_ASSINATURA || obterTotalBlocos() != i - 1) {
+                printf("ERRO: bloco com assinatura trocada não foi recusado\n");
+                falhas++;
+            }
+            assinaturas[slot][0] ^= 1;
+        }
+        if (submeterBlocoAssinado(&novo, assinaturas) != SUBMISSAO_CONECTADO) {
+            printf("ERRO: bloco %u assinado recusado\n", i);
+            falhas++;
+            break;
+        }
+        anterior = novo;
+    }
+    assinaturasEstatisticas(&depois);
+    printf("Cadeia assinada: %u blocos | bloco adulterado recusado e reenviado com %llu assinaturas do cache\n",
+           obterTotalBlocos(), depois.emCache - antes.emCache);
+
+    limparBlocosLaterais();
+    definirModoCadeiaGrande(1);     // Sem exportar texto
+    finalizarStorage();
+    definirModoCadeiaGrande(0);
+    removerArquivosBenchmark();
+    assinaturasFinalizar();
+    free(validas);
+    free(adulterada);
+    free(txs);
+    return falhas;
+}
+
+int main() {
+    MTRand r = seedRand(1234567);
+    unsigned char dados[184];
+    int falhas = 0;
+
+    removerArquivosBenchmark();
+    inicializarStorage(ARQUIVO_BENCHMARK);
+
+    printf("Minerando cadeia base de %d blocos...\n", BLOCOS_BASE);
+    gerarDadosDoBloco(1, dados, NULL, &r);
+    BlocoMinerado anterior = criarBlocoGenesis(dados);
+    submeterBloco(&anterior);
+    for (unsigned int i = 2; i <= BLOCOS_BASE; i++) {
+        gerarDadosDoBloco(i, dados, NULL, &r);
+        BlocoMinerado novo = criarProxBloco(anterior, i, dados, 0);
+        submeterBloco(&novo);
+        anterior = novo;
+    }
+
+    printf("\n%-12s %-14s %-14s %-12s\n", "Profundidade", "Reorg (ms)", "Volta (ms)", "us/bloco");
+    for (size_t p = 0; p < sizeof(profundidades) / sizeof(profundidades[0]); p++) {
+        unsigned int d = profundidades[p];
+        unsigned int total = obterTotalBlocos();
+        BlocoMinerado bifurcacao, topoAntigo;
+        BlocoMinerado *ramo = verifica_malloc((d + 2) * sizeof(BlocoMinerado), "benchmark");
+
+        buscarBlocoPorId(total - d, &bifurcacao);
+        buscarBlocoPorId(total, &topoAntigo);
+
+        // Ramo com 1 bloco a mais: desconecta d, conecta d + 1
+        minerarRamo(bifurcacao, d + 1, (unsigned char)(p + 1), ramo);
+        double tempoReorg = submeterRamo(ramo, d + 1);
+
+        // Ramo antigo volta a vencer com 2 blocos a mais: desconecta d + 1, conecta d + 2
+        minerarRamo(topoAntigo, 2, (unsigned char)(p + 101), ramo);
+        double tempoVolta = submeterRamo(ramo, 2);
+
+        if (tempoReorg < 0 || tempoVolta < 0 || obterTotalBlocos() != total + 2) {
+            printf("%-12u FALHOU (total %u, esperado %u)\n", d, obterTotalBlocos(), total + 2);
+            falhas++;
+        }
+        else {
+            printf("%-12u %-14.3f %-14.3f %-12.2f\n", d, tempoReorg, tempoVolta,
+                   tempoReorg * 1000.0 / (2 * d + 1));
+        }
+        free(ramo);
+    }
+
+    benchmarkLatencia();
+    falhas += benchmarkMempool();
+
+    unsigned int verificados;
+    if (!verificarCadeiaCompleta(&verificados)) {
+        printf("ERRO: cadeia inconsistente após as reorganizações (bloco %u)\n", verificados + 1);
+        falhas++;
+    }
+    else
+        printf("\nCadeia final íntegra: %u blocos, %u blocos laterais no pool.\n", verificados, quantidadeBlocosLaterais());
+
+    limparBlocosLaterais();
+    finalizarStorage();
+    removerArquivosBenchmark();
+
+    falhas += benchmarkContas();
+    falhas += benchmarkExecucao();
+    falhas += benchmarkAssinaturas();
+    return falhas ? 1 : 0;
+}
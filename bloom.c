@@ -0,0 +1,98 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "bloom.h"
+
+#define BITS_POR_BLOCO 512
+#define PALAVRAS_POR_BLOCO 8
+#define LINHA_CACHE 64
+#define MAX_K 16
+
+// Mistura de 64 bits (finalizador do SplitMix64)
+static uint64_t misturar(uint64_t x)
+{
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+void bloomCriar(FiltroBloom *f, unsigned int capacidade, double taxaFalsoPositivo)
+{
+    if (capacidade == 0) capacidade = 1;
+    if (taxaFalsoPositivo <= 0.0 || taxaFalsoPositivo >= 1.0) taxaFalsoPositivo = 0.01;
+
+    // m/n = -ln(p) / ln(2)^2, com 10% a mais para compensar o particionamento em blocos
+    double bitsPorChave = -log(taxaFalsoPositivo) / (M_LN2 * M_LN2) * 1.1;
+    unsigned long long totalBits = (unsigned long long)(bitsPorChave * capacidade) + 1;
+    unsigned int k = (unsigned int)lround(bitsPorChave / 1.1 * M_LN2);
+
+    f->qtdBlocos = (unsigned int)((totalBits + BITS_POR_BLOCO - 1) / BITS_POR_BLOCO);
+    f->k = k < 1 ? 1 : (k > MAX_K ? MAX_K : k);
+    f->capacidade = capacidade;
+    f->elementos = 0;
+    f->taxaAlvo = taxaFalsoPositivo;
+
+    size_t bytes = (size_t)f->qtdBlocos * LINHA_CACHE;
+    f->bits = aligned_alloc(LINHA_CACHE, bytes);
+    if (!f->bits)
+    {
+        fprintf(stderr, "Erro malloc: bloomCriar\n");
+        exit(1);
+    }
+    memset(f->bits, 0, bytes);
+}
+
+/*
+ * Um hash de 64 bits define o bloco (32 bits altos) e gera as k posições
+ * dentro dele por hashing duplo (h1 + i*h2), 9 bits por posição.
+ */
+void bloomInserir(FiltroBloom *f, uint32_t chave)
+{
+    uint64_t h = misturar(chave);
+    uint64_t *bloco = &f->bits[((h >> 32) * f->qtdBlocos >> 32) * PALAVRAS_POR_BLOCO];
+    uint32_t h1 = (uint32_t)h;
+    uint32_t h2 = (uint32_t)(h >> 16) | 1;
+
+    for (unsigned int i = 0; i < f->k; i++)
+    {
+        unsigned int pos = (h1 + i * h2) & (BITS_POR_BLOCO - 1);
+        bloco[pos >> 6] |= 1ULL << (pos & 63);
+    }
+    f->elementos++;
+}
+
+int bloomTalvezContem(const FiltroBloom *f, uint32_t chave)
+{
+    uint64_t h = misturar(chave);
+    const uint64_t *bloco = &f->bits[((h >> 32) * f->qtdBlocos >> 32) * PALAVRAS_POR_BLOCO];
+    uint32_t h1 = (uint32_t)h;
+    uint32_t h2 = (uint32_t)(h >> 16) | 1;
+
+    for (unsigned int i = 0; i < f->k; i++)
+    {
+        unsigned int pos = (h1 + i * h2) & (BITS_POR_BLOCO - 1);
+        if (!(bloco[pos >> 6] & (1ULL << (pos & 63))))
+            return 0;
+    }
+    return 1;
+}
+
+// Taxa teórica de falso positivo com o número atual de elementos
+double bloomTaxaEstimada(const FiltroBloom *f)
+{
+    double m = (double)f->qtdBlocos * BITS_POR_BLOCO;
+    return pow(1.0 - exp(-(double)f->k * f->elementos / m), f->k);
+}
+
+size_t bloomMemoria(const FiltroBloom *f)
+{
+    return (size_t)f->qtdBlocos * LINHA_CACHE;
+}
+
+void bloomLiberar(FiltroBloom *f)
+{
+    free(f->bits);
+    memset(f, 0, sizeof(*f));
+}
@@ -0,0 +1,29 @@
+#ifndef BLOOM_H
+#define BLOOM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Filtro de Bloom particionado em linhas de cache
+ * 
+ * Cada chave cai em um único bloco de 64 bytes (512 bits) e todos os seus
+ * k bits ficam dentro dele: uma consulta toca uma só linha de cache.
+ */
+typedef struct {
+    uint64_t *bits;             // qtdBlocos * 8 palavras de 64 bits
+    unsigned int qtdBlocos;     // Blocos de 64 bytes
+    unsigned int k;             // Bits por chave
+    unsigned int capacidade;    // Chaves previstas no dimensionamento
+    unsigned int elementos;     // Chaves inseridas
+    double taxaAlvo;            // Taxa de falso positivo desejada
+} FiltroBloom;
+
+void bloomCriar(FiltroBloom *f, unsigned int capacidade, double taxaFalsoPositivo);
+void bloomInserir(FiltroBloom *f, uint32_t chave);
+int bloomTalvezContem(const FiltroBloom *f, uint32_t chave);
+double bloomTaxaEstimada(const FiltroBloom *f);
+size_t bloomMemoria(const FiltroBloom *f);
+void bloomLiberar(FiltroBloom *f);
+
+#endif
@@ -0,0 +1,158 @@
+/*
+ * Checkpoints periódicos de saldo (a cada INTERVALO_CHECKPOINT blocos)
+ *
+ * Cada checkpoint guarda, para os 256 endereços, a diferença de saldo em
+ * relação ao checkpoint anterior, em zigzag + varint (quase sempre 1-2
+ * bytes por endereço em vez de 4). A cada QUADRO_CHAVE checkpoints a
+ * diferença é calculada a partir de zero (quadro-chave), limitando a
+ * restauração a no máximo QUADRO_CHAVE decodificações.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "checkpoint.h"
+
+#define NUM_ENDERECOS 256
+#define QUADRO_CHAVE 16             // Checkpoints entre quadros-chave completos
+#define MAX_VARINT 5
+
+static unsigned char *dados = NULL;        // Todos os checkpoints codificados, em sequência
+static size_t tamanhoDados = 0;
+static size_t capacidadeDados = 0;
+static size_t *offsets = NULL;             // Início de cada checkpoint em 'dados'
+static unsigned int qtdCheckpoints = 0;
+static unsigned int capacidadeOffsets = 0;
+static unsigned int ultimoSaldos[NUM_ENDERECOS];  // Saldos do último checkpoint (base do delta)
+
+static void *realocar(void *ptr, size_t tamanho, const char *contexto)
+{
+    void *novo = realloc(ptr, tamanho);
+    if (!novo)
+    {
+        fprintf(stderr, "Erro realloc: %s\n", contexto);
+        exit(1);
+    }
+    return novo;
+}
+
+// zigzag: 0, -1, 1, -2, 2... -> 0, 1, 2, 3, 4 (deltas pequenos viram varints curtos)
+static unsigned int zigzag(int valor)
+{
+    return ((unsigned int)valor << 1) ^ (unsigned int)(valor >> 31);
+}
+
+static int desfazerZigzag(unsigned int valor)
+{
+    return (int)(valor >> 1) ^ -(int)(valor & 1);
+}
+
+void checkpointRegistrar(const unsigned int saldos[])
+{
+    if (tamanhoDados + NUM_ENDERECOS * MAX_VARINT > capacidadeDados)
+    {
+        capacidadeDados = capacidadeDados == 0 ? 4096 : capacidadeDados * 2;
+        dados = realocar(dados, capacidadeDados, "checkpointRegistrar");
+    }
+    if (qtdCheckpoints == capacidadeOffsets)
+    {
+        capacidadeOffsets = capacidadeOffsets == 0 ? 64 : capacidadeOffsets * 2;
+        offsets = realocar(offsets, capacidadeOffsets * sizeof(size_t), "checkpointRegistrar");
+    }
+
+    // Quadro-chave: delta em relação a zero
+    if (qtdCheckpoints % QUADRO_CHAVE == 0)
+        memset(ultimoSaldos, 0, sizeof(ultimoSaldos));
+
+    offsets[qtdCheckpoints] = tamanhoDados;
+    for (int i = 0; i < NUM_ENDERECOS; i++)
+    {
+        unsigned int v = zigzag((int)(saldos[i] - ultimoSaldos[i]));
+        while (v >= 0x80)
+        {
+            dados[tamanhoDados++] = (unsigned char)(v | 0x80);
+            v >>= 7;
+        }
+        dados[tamanhoDados++] = (unsigned char)v;
+        ultimoSaldos[i] = saldos[i];
+    }
+    qtdCheckpoints++;
+}
+
+static size_t aplicarDeltas(size_t pos, unsigned int saldos[])
+{
+    for (int i = 0; i < NUM_ENDERECOS; i++)
+    {
+        unsigned int v = 0;
+        int deslocamento = 0;
+        while (dados[pos] & 0x80)
+        {
+            v |= (unsigned int)(dados[pos++] & 0x7f) << deslocamento;
+            deslocamento += 7;
+        }
+        v |= (unsigned int)dados[pos++] << deslocamento;
+        saldos[i] += (unsigned int)desfazerZigzag(v);
+    }
+    return pos;
+}
+
+/**
+ * Preenche 'saldos' com o checkpoint mais recente de altura <= 'altura'.
+ * Retorna a altura desse checkpoint (0 = nenhum, saldos zerados).
+ */
+unsigned int checkpointRestaurar(unsigned int altura, unsigned int saldos[])
+{
+    memset(saldos, 0, NUM_ENDERECOS * sizeof(unsigned int));
+
+    unsigned int alvo = altura / INTERVALO_CHECKPOINT;   // Checkpoint c cobre a altura c*K (c >= 1)
+    if (alvo > qtdCheckpoints)
+        alvo = qtdCheckpoints;
+    if (alvo == 0)
+        return 0;
+
+    // Índice interno (0-based) do checkpoint alvo e do quadro-chave anterior
+    unsigned int indice = alvo - 1;
+    unsigned int quadro = (indice / QUADRO_CHAVE) * QUADRO_CHAVE;
+
+    size_t pos = offsets[quadro];
+    for (unsigned int c = quadro; c <= indice; c++)
+        pos = aplicarDeltas(pos, saldos);
+
+    return alvo * INTERVALO_CHECKPOINT;
+}
+
+// Descarta o checkpoint mais recente (desconexão do bloco da sua altura)
+void checkpointRemoverUltimo()
+{
+    if (qtdCheckpoints == 0)
+        return;
+
+    qtdCheckpoints--;
+    tamanhoDados = offsets[qtdCheckpoints];
+
+    // A base do próximo delta volta a ser o checkpoint anterior
+    checkpointRestaurar(qtdCheckpoints * INTERVALO_CHECKPOINT, ultimoSaldos);
+}
+
+unsigned int checkpointQuantidade()
+{
+    return qtdCheckpoints;
+}
+
+size_t checkpointMemoria()
+{
+    return tamanhoDados + qtdCheckpoints * sizeof(size_t);
+}
+
+void checkpointLimpar()
+{
+    free(dados);
+    free(offsets);
+    dados = NULL;
+    offsets = NULL;
+    tamanhoDados = 0;
+    capacidadeDados = 0;
+    qtdCheckpoints = 0;
+    capacidadeOffsets = 0;
+    memset(ultimoSaldos, 0, sizeof(ultimoSaldos));
+}
@@ -0,0 +1,18 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <stddef.h>
+
+// Blocos entre checkpoints de saldo (K). Menor = consultas mais rápidas, mais memória.
+#ifndef INTERVALO_CHECKPOINT
+#define INTERVALO_CHECKPOINT 500
+#endif
+
+void checkpointRegistrar(const unsigned int saldos[]);
+unsigned int checkpointRestaurar(unsigned int altura, unsigned int saldos[]);
+void checkpointRemoverUltimo();
+unsigned int checkpointQuantidade();
+size_t checkpointMemoria();
+void checkpointLimpar();
+
+#endif
@@ -0,0 +1,133 @@
+/*
+ * Contadores de execução (instrumentação leve, sempre ligada)
+ *
+ * Cada thread ganha, no primeiro incremento, um bloco próprio de contadores
+ * alinhado em linha de cache. O incremento é uma soma comum na memória da
+ * thread (store relaxado, sem lock nem instrução atômica de RMW), então o
+ * custo é o de um acesso a variável thread-local. Os blocos ficam numa lista
+ * global (inserção com CAS) percorrida só na agregação, que é rara: menu,
+ * modo lote e dumps. Como os blocos não são liberados, o trabalho de uma
+ * thread encerrada (ex.: a mineração em segundo plano) continua contando.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "contadores.h"
+
+#define LINHA_CACHE 64
+
+typedef struct NoContadores {
+    ContadoresThread contadores;        // Primeiro campo: o bloco começa alinhado
+    struct NoContadores *prox;
+} NoContadores;
+
+_Thread_local ContadoresThread *contadoresDaThread = NULL;
+
+static NoContadores *listaContadores = NULL;    // Acessada só com __atomic_*
+
+static const char *nomes[QTD_CONTADORES] = {
+    "hashes",
+    "blocos_minerados",
+    "tentativas_nonce",
+    "blocos_gerados",
+    "transacoes_geradas",
+    "sorteios_rng",
+    "chamadas_fwrite",
+    "bytes_escritos",
+    "flushes_buffer",
+    "chamadas_fread",
+    "chamadas_pread",
+    "bytes_lidos",
+    "blocos_do_buffer",
+    "buscas_nonce",
+    "sondagens_nonce",
+    "cache_tx_acertos",
+    "cache_tx_falhas",
+    "execucoes_otimistas",
+    "abortos_otimistas",
+    "assinaturas_verificadas",
+    "assinaturas_em_cache",
+    "arvores_merkle_montadas",
+    "arvores_merkle_em_cache",
+};
+
+ContadoresThread *contadoresRegistrarThread()
+{
+    // Tamanho arredondado para múltiplo da linha: aligned_alloc exige
+    size_t tamanho = (sizeof(NoContadores) + LINHA_CACHE - 1) / LINHA_CACHE * LINHA_CACHE;
+    NoContadores *no = aligned_alloc(LINHA_CACHE, tamanho);
+    if (no == NULL)
+    {
+        fprintf(stderr, "Erro malloc: contadoresRegistrarThread\n");
+        exit(1);
+    }
+    for (int i = 0; i < QTD_CONTADORES; i++)
+        no->contadores.valores[i] = 0;
+
+    no->prox = __atomic_load_n(&listaContadores, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&listaContadores, &no->prox, no, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+        ;
+
+    contadoresDaThread = &no->contadores;
+    return contadoresDaThread;
+}
+
+void contadoresAgregar(unsigned long long total[QTD_CONTADORES])
+{
+    for (int i = 0; i < QTD_CONTADORES; i++)
+        total[i] = 0;
+
+    for (NoContadores *no = __atomic_load_n(&listaContadores, __ATOMIC_ACQUIRE); no != NULL; no = no->prox)
+    {
+        for (int i = 0; i < QTD_CONTADORES; i++)
+            total[i] += __atomic_load_n(&no->contadores.valores[i], __ATOMIC_RELAXED);
+    }
+}
+
+unsigned int contadoresQuantidadeThreads()
+{
+    unsigned int qtd = 0;
+    for (NoContadores *no = __atomic_load_n(&listaContadores, __ATOMIC_ACQUIRE); no != NULL; no = no->prox)
+        qtd++;
+    return qtd;
+}
+
+const char *contadorNome(Contador c)
+{
+    return (c >= 0 && c < QTD_CONTADORES) ? nomes[c] : "?";
+}
+
+static double razao(unsigned long long a, unsigned long long b)
+{
+    return b ? (double)a / (double)b : 0.0;
+}
+
+void contadoresImprimir()
+{
+    unsigned long long t[QTD_CONTADORES];
+    contadoresAgregar(t);
+
+    printf("\n--- Contadores de Execução (threads registradas: %u) ---\n", contadoresQuantidadeThreads());
+    for (int i = 0; i < QTD_CONTADORES; i++)
+        printf("%-22s %llu\n", nomes[i], t[i]);
+
+    printf("\nDerivados:\n");
+    printf("Tentativas por bloco minerado:   %.1f\n", razao(t[CONTADOR_TENTATIVAS_NONCE], t[CONTADOR_BLOCOS_MINERADOS]));
+    printf("Transações por bloco gerado:     %.2f\n", razao(t[CONTADOR_TRANSACOES_GERADAS], t[CONTADOR_BLOCOS_GERADOS]));
+    printf("Bytes por fwrite:                %.0f\n", razao(t[CONTADOR_BYTES_ESCRITOS], t[CONTADOR_CHAMADAS_FWRITE]));
+    printf("Sondagens por busca de nonce:    %.2f\n", razao(t[CONTADOR_SONDAGENS_NONCE], t[CONTADOR_BUSCAS_NONCE]));
+    printf("Acerto do cache de transações:   %.1f%%\n",
+           100.0 * razao(t[CONTADOR_CACHE_TX_ACERTOS], t[CONTADOR_CACHE_TX_ACERTOS] + t[CONTADOR_CACHE_TX_FALHAS]));
+}
+
+// Um objeto JSON numa linha: {"threads":N,"hashes":...,...}
+void contadoresExportarJson(FILE *saida)
+{
+    unsigned long long t[QTD_CONTADORES];
+    contadoresAgregar(t);
+
+    fprintf(saida, "{\"threads\":%u", contadoresQuantidadeThreads());
+    for (int i = 0; i < QTD_CONTADORES; i++)
+        fprintf(saida, ",\"%s\":%llu", nomes[i], t[i]);
+    fprintf(saida, "}");
+}
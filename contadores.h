@@ -0,0 +1,64 @@
+#ifndef CONTADORES_H
+#define CONTADORES_H
+
+#include <stdio.h>
+
+/**
+ * Contadores de execução por thread
+ *
+ * Cada thread incrementa o próprio bloco de contadores (sem atomics de
+ * leitura-modificação-escrita nem compartilhamento de linha de cache);
+ * a agregação soma os blocos de todas as threads sob demanda. Os blocos
+ * nunca são liberados, então o que uma thread já encerrada contou continua
+ * no total.
+ */
+typedef enum {
+    CONTADOR_HASHES,                // SHA-256 completos (calcularHash e finalizarHashParcial)
+    CONTADOR_BLOCOS_MINERADOS,      // Chamadas concluídas de minerarBloco
+    CONTADOR_TENTATIVAS_NONCE,      // Nonces testados por minerarBloco
+    CONTADOR_BLOCOS_GERADOS,        // Chamadas de gerarDadosDoBloco
+    CONTADOR_TRANSACOES_GERADAS,    // Transações válidas geradas
+    CONTADOR_SORTEIOS_RNG,          // Sorteios (MT ou Philox) feitos por gerarDadosDoBloco
+    CONTADOR_CHAMADAS_FWRITE,       // fwrite de blocos e cabeçalhos
+    CONTADOR_BYTES_ESCRITOS,
+    CONTADOR_FLUSHES_BUFFER,        // Esvaziamentos do buffer de escrita
+    CONTADOR_CHAMADAS_FREAD,        // fread em lote (reconstrução dos índices)
+    CONTADOR_CHAMADAS_PREAD,        // pread de blocos já persistidos
+    CONTADOR_BYTES_LIDOS,
+    CONTADOR_BLOCOS_DO_BUFFER,      // Blocos servidos direto do buffer de escrita
+    CONTADOR_BUSCAS_NONCE,          // Buscas que passaram pelo filtro de Bloom
+    CONTADOR_SONDAGENS_NONCE,       // Nós percorridos nas listas da tabela de nonces
+    CONTADOR_CACHE_TX_ACERTOS,      // Contagem lida da tabela de metadados
+    CONTADOR_CACHE_TX_FALHAS,       // Bloco ainda fora da tabela de metadados
+    CONTADOR_EXECUCOES_OTIMISTAS,   // Encarnações de transações na execução otimista
+    CONTADOR_ABORTOS_OTIMISTAS,     // Encarnações abortadas pela validação
+    CONTADOR_ASSINATURAS_VERIFICADAS, // Verificações Ed25519 feitas
+    CONTADOR_ASSINATURAS_EM_CACHE,  // Assinaturas aceitas pelo cache de verificadas
+    CONTADOR_ARVORES_MONTADAS,      // Árvores Merkle montadas para provas de inclusão
+    CONTADOR_ARVORES_EM_CACHE,      // Provas servidas por árvore já no cache
+    QTD_CONTADORES
+} Contador;
+
+typedef struct {
+    unsigned long long valores[QTD_CONTADORES];
+} ContadoresThread;
+
+extern _Thread_local ContadoresThread *contadoresDaThread;
+
+ContadoresThread *contadoresRegistrarThread();
+void contadoresAgregar(unsigned long long total[QTD_CONTADORES]);
+unsigned int contadoresQuantidadeThreads();
+const char *contadorNome(Contador c);
+void contadoresImprimir();
+void contadoresExportarJson(FILE *saida);
+
+// Caminho quente: só a thread dona escreve; o store relaxado evita leitura rasgada na agregação
+static inline void contadorSomar(Contador c, unsigned long long valor)
+{
+    ContadoresThread *t = contadoresDaThread;
+    if (t == NULL)
+        t = contadoresRegistrarThread();
+    __atomic_store_n(&t->valores[c], t->valores[c] + valor, __ATOMIC_RELAXED);
+}
+
+#endif
@@ -0,0 +1,180 @@
+/*
+ * Estado das contas v2: vetor denso paginado + conjunto das contas com saldo
+ *
+ * As páginas são publicadas com release e só voltam ao sistema pelo RCU
+ * (contasInicializar roda na seção de escrita do storage), então um leitor
+ * sem trava sempre encontra uma página válida ou NULL (saldo zero).
+ * O conjunto com saldo troca o removido pelo último: a ordem depende só da
+ * sequência de créditos e débitos, então é a mesma a cada recarga.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "contas.h"
+#include "storage.h"
+#include "sincronizacao.h"
+
+#define CONJUNTO_CAPACIDADE_INICIAL 4096
+
+static PaginaContas *paginas[CONTAS_MAX_PAGINAS];   // Acessadas com __atomic_* (leitores sem trava)
+static unsigned int qtdContas = 0;
+static unsigned int qtdPaginasAlocadas = 0;
+
+static unsigned int *comSaldo = NULL;               // Contas com saldo > 0, sem ordem
+static unsigned int qtdComSaldo = 0;
+static unsigned int capacidadeComSaldo = 0;
+
+// Página da conta, alocada zerada no primeiro crédito (só o escritor)
+static PaginaContas *paginaParaEscrita(unsigned int conta)
+{
+    PaginaContas *p = paginas[conta >> CONTAS_PAGINA_BITS];
+    if (p == NULL)
+    {
+        p = verifica_malloc(sizeof(PaginaContas), "contasPagina");
+        memset(p, 0, sizeof(PaginaContas));
+        __atomic_store_n(&paginas[conta >> CONTAS_PAGINA_BITS], p, __ATOMIC_RELEASE);
+        qtdPaginasAlocadas++;
+    }
+    return p;
+}
+
+static void entrarNoConjunto(PaginaContas *p, unsigned int conta)
+{
+    if (qtdComSaldo == capacidadeComSaldo)
+    {
+        capacidadeComSaldo = capacidadeComSaldo == 0 ? CONJUNTO_CAPACIDADE_INICIAL : capacidadeComSaldo * 2;
+        unsigned int *novo = realloc(comSaldo, capacidadeComSaldo * sizeof(unsigned int));
+        if (novo == NULL)
+        {
+            fprintf(stderr, "Erro realloc: contasComSaldo\n");
+            exit(1);
+        }
+        comSaldo = novo;
+    }
+    comSaldo[qtdComSaldo++] = conta;
+    p->posicaoComSaldo[conta & (CONTAS_POR_PAGINA - 1)] = qtdComSaldo;
+}
+
+// Tira a conta do conjunto trocando-a pela última
+static void sairDoConjunto(PaginaContas *p, unsigned int conta)
+{
+    unsigned int posicao = p->posicaoComSaldo[conta & (CONTAS_POR_PAGINA - 1)] - 1;
+    unsigned int ultima = comSaldo[--qtdComSaldo];
+
+    comSaldo[posicao] = ultima;
+    paginas[ultima >> CONTAS_PAGINA_BITS]->posicaoComSaldo[ultima & (CONTAS_POR_PAGINA - 1)] = posicao + 1;
+    p->posicaoComSaldo[conta & (CONTAS_POR_PAGINA - 1)] = 0;
+}
+
+// Começa um espaço de 'qtd' contas vazio (libera o anterior)
+void contasInicializar(unsigned int qtd)
+{
+    contasLiberar();
+    qtdContas = qtd > CONTAS_MAXIMO ? CONTAS_MAXIMO : qtd;
+}
+
+unsigned int contasQuantidade()
+{
+    return qtdContas;
+}
+
+unsigned int contasSaldo(unsigned int conta)
+{
+    if (conta >= qtdContas)
+        return 0;
+    PaginaContas *p = __atomic_load_n(&paginas[conta >> CONTAS_PAGINA_BITS], __ATOMIC_ACQUIRE);
+    return p ? __atomic_load_n(&p->saldo[conta & (CONTAS_POR_PAGINA - 1)], __ATOMIC_RELAXED) : 0;
+}
+
+unsigned int contasBlocosMinerados(unsigned int conta)
+{
+    if (conta >= qtdContas)
+        return 0;
+    PaginaContas *p = __atomic_load_n(&paginas[conta >> CONTAS_PAGINA_BITS], __ATOMIC_ACQUIRE);
+    return p ? __atomic_load_n(&p->blocosMinerados[conta & (CONTAS_POR_PAGINA - 1)], __ATOMIC_RELAXED) : 0;
+}
+
+void contasCreditar(unsigned int conta, unsigned int valor)
+{
+    if (conta >= qtdContas || valor == 0)
+        return;
+    PaginaContas *p = paginaParaEscrita(conta);
+    unsigned int *saldo = &p->saldo[conta & (CONTAS_POR_PAGINA - 1)];
+
+    if (*saldo == 0)
+        entrarNoConjunto(p, conta);
+    __atomic_store_n(saldo, *saldo + valor, __ATOMIC_RELAXED);
+}
+
+// Retorna 0 (sem mexer em nada) se a conta não tem 'valor'
+int contasDebitar(unsigned int conta, unsigned int valor)
+{
+    if (contasSaldo(conta) < valor)
+        return 0;
+    if (valor == 0)
+        return 1;
+
+    PaginaContas *p = paginas[conta >> CONTAS_PAGINA_BITS];
+    unsigned int *saldo = &p->saldo[conta & (CONTAS_POR_PAGINA - 1)];
+    __atomic_store_n(saldo, *saldo - valor, __ATOMIC_RELAXED);
+    if (*saldo == 0)
+        sairDoConjunto(p, conta);
+    return 1;
+}
+
+// Soma 'delta' (+1 ao conectar, -1 ao desconectar) aos blocos da conta e retorna o novo total
+unsigned int contasSomarMinerado(unsigned int conta, int delta)
+{
+    if (conta >= qtdContas)
+        return 0;
+    PaginaContas *p = paginaParaEscrita(conta);
+    unsigned int *blocos = &p->blocosMinerados[conta & (CONTAS_POR_PAGINA - 1)];
+    __atomic_store_n(blocos, *blocos + (unsigned int)delta, __ATOMIC_RELAXED);
+    return *blocos;
+}
+
+unsigned int contasComSaldo()
+{
+    return qtdComSaldo;
+}
+
+// Conta na posição do conjunto (0 <= posicao < contasComSaldo)
+unsigned int contasComSaldoEm(unsigned int posicao)
+{
+    return comSaldo[posicao];
+}
+
+// Página 'indice' ou NULL se nenhuma conta dela foi tocada
+const PaginaContas *contasPagina(unsigned int indice)
+{
+    return indice < CONTAS_MAX_PAGINAS ? __atomic_load_n(&paginas[indice], __ATOMIC_ACQUIRE) : NULL;
+}
+
+unsigned int contasPaginasAlocadas()
+{
+    return qtdPaginasAlocadas;
+}
+
+size_t contasMemoria()
+{
+    return (size_t)qtdPaginasAlocadas * sizeof(PaginaContas) + (size_t)capacidadeComSaldo * sizeof(unsigned int);
+}
+
+void contasLiberar()
+{
+    unsigned int limite = (qtdContas + CONTAS_POR_PAGINA - 1) >> CONTAS_PAGINA_BITS;
+    for (unsigned int i = 0; i < limite; i++)
+    {
+        if (paginas[i] == NULL)
+            continue;
+        PaginaContas *p = paginas[i];
+        __atomic_store_n(&paginas[i], NULL, __ATOMIC_RELEASE);
+        rcuAposentar(p);
+    }
+    free(comSaldo);
+    comSaldo = NULL;
+    qtdComSaldo = capacidadeComSaldo = 0;
+    qtdPaginasAlocadas = 0;
+    qtdContas = 0;
+}
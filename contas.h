@@ -0,0 +1,45 @@
+#ifndef CONTAS_H
+#define CONTAS_H
+
+#include <stddef.h>
+
+/**
+ * Estado das contas do formato v2 (milhões de contas)
+ *
+ * Vetor denso paginado: a conta c fica na página c >> 12, posição c & 4095.
+ * Uma página só é alocada quando uma conta dela recebe algo, então a
+ * memória acompanha as páginas tocadas (no pior caso, 12 bytes por conta
+ * do espaço). Junto, o conjunto das contas com saldo > 0 num vetor
+ * compacto: sortear uma origem ou percorrer quem tem saldo custa O(1) por
+ * conta com saldo, sem varrer as vazias.
+ *
+ * Escritor único (o storage). contasSaldo e contasBlocosMinerados podem ser
+ * lidos sem trava; o conjunto com saldo, só pelo escritor ou com a trava de
+ * índices do storage.
+ */
+#define CONTAS_PAGINA_BITS 12
+#define CONTAS_POR_PAGINA (1u << CONTAS_PAGINA_BITS)
+#define CONTAS_MAXIMO (1u << 28)
+#define CONTAS_MAX_PAGINAS (CONTAS_MAXIMO / CONTAS_POR_PAGINA)
+
+typedef struct {
+    unsigned int saldo[CONTAS_POR_PAGINA];
+    unsigned int blocosMinerados[CONTAS_POR_PAGINA];
+    unsigned int posicaoComSaldo[CONTAS_POR_PAGINA];   // 1 + posição no conjunto com saldo (0 = fora)
+} PaginaContas;
+
+void contasInicializar(unsigned int qtdContas);
+unsigned int contasQuantidade();
+unsigned int contasSaldo(unsigned int conta);
+unsigned int contasBlocosMinerados(unsigned int conta);
+void contasCreditar(unsigned int conta, unsigned int valor);
+int contasDebitar(unsigned int conta, unsigned int valor);
+unsigned int contasSomarMinerado(unsigned int conta, int delta);
+unsigned int contasComSaldo();
+unsigned int contasComSaldoEm(unsigned int posicao);
+const PaginaContas *contasPagina(unsigned int indice);
+unsigned int contasPaginasAlocadas();
+size_t contasMemoria();
+void contasLiberar();
+
+#endif
@@ -0,0 +1,230 @@
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include "mtwister.h"
+#include "structs.h"
+#include "miner.h"
+#include "transactions.h"
+#include "storage.h"
+
+// Harness de escala: minera, recarrega e consulta cadeias de tamanho crescente, medindo tempo e RSS
+
+#define ARQUIVO_ESCALA "escala.bin"
+#define CONSULTAS_AMOSTRA 1000
+
+static const unsigned int tamanhosPadrao[] = {30000, 1000000, 10000000, 100000000};
+
+// Resultado de um tamanho; cada fase roda num processo filho e devolve sua parte via pipe
+typedef struct {
+    unsigned int blocos;
+    double tempoMineracao;      // s
+    double tempoEncerramento;   // s (flush final, .idx e exportação fora do modo grande)
+    double tempoRecarga;        // s (inicializarStorage sobre o disco, processo novo)
+    double consultaUs;          // us médios de bloco por ID + saldos na altura
+    long rssBaseKB;             // Antes de abrir o storage
+    long rssMineracaoKB;        // Ao fim da mineração
+    long rssRecargaKB;          // Depois de recarregar do disco
+    long picoMineracaoKB;       // ru_maxrss de cada fase
+    long picoRecargaKB;
+    long long discoBytes;       // .bin + .hdr + .idx
+} ResultadoEscala;
+
+#define FASE_MINERACAO 0
+#define FASE_RECARGA 1
+
+static double tempo_ms(struct timespec inicio, struct timespec fim) {
+    return (fim.tv_sec - inicio.tv_sec) * 1000.0 + (fim.tv_nsec - inicio.tv_nsec) / 1e6;
+}
+
+static double agora_s(struct timespec inicio) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return tempo_ms(inicio, t) / 1000.0;
+}
+
+// RSS atual (não o pico) pelo /proc
+static long rssAtualKB() {
+    long paginas = 0, residentes = 0;
+    FILE *f = fopen("/proc/self/statm", "r");
+    if (!f) return 0;
+    if (fscanf(f, "%ld %ld", &paginas, &residentes) != 2) residentes = 0;
+    fclose(f);
+    return residentes * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+static long long tamanhoArquivo(const char *nome) {
+    struct stat st;
+    return stat(nome, &st) == 0 ? (long long)st.st_size : 0;
+}
+
+static void removerArquivosEscala() {
+    remove(ARQUIVO_ESCALA);
+    remove("escala.hdr");
+    remove("escala.txt");
+    remove("escala.idx");
+}
+
+// Fase 1 (processo filho): minera do zero e encerra gravando o .idx
+static void medirMineracao(unsigned int n, int grande, ResultadoEscala *res) {
+    MTRand r = seedRand(1234567);
+    unsigned char dados[DATA_SIZE];
+    struct timespec t0;
+    unsigned int progresso = n / 10 > 0 ? n / 10 : 1;
+
+    res->rssBaseKB = rssAtualKB();
+
+    removerArquivosEscala();
+    definirModoCadeiaGrande(grande);
+    inicializarStorage(ARQUIVO_ESCALA);
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    gerarDadosDoBloco(1, dados, NULL, &r);
+    BlocoMinerado anterior = criarBlocoGenesis(dados);
+    adicionarBloco(&anterior);
+    for (unsigned int i = 2; i <= n; i++) {
+        gerarDadosDoBloco(i, dados, NULL, &r);
+        BlocoMinerado novo = criarProxBloco(anterior, i, dados, 0);
+        adicionarBloco(&novo);
+        anterior = novo;
+        if (i % progresso == 0)
+            fprintf(stderr, "  [%u blocos] %u minerados (%.0f s)\n", n, i, agora_s(t0));
+    }
+    res->tempoMineracao = agora_s(t0);
+    res->rssMineracaoKB = rssAtualKB();
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    finalizarStorage();
+    res->tempoEncerramento = agora_s(t0);
+    res->discoBytes = tamanhoArquivo(ARQUIVO_ESCALA) + tamanhoArquivo("escala.hdr") + tamanhoArquivo("escala.idx");
+}
+
+// Fase 2 (processo novo): carga a partir do disco, como numa reabertura do programa
+static void medirRecarga(unsigned int n, int grande, ResultadoEscala *res) {
+    MTRand r = seedRand(7654321);
+    struct timespec t0;
+
+    definirModoCadeiaGrande(grande);
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    inicializarStorage(ARQUIVO_ESCALA);
+    res->tempoRecarga = agora_s(t0);
+    res->rssRecargaKB = rssAtualKB();
+
+    // Consultas aleatórias sobre a cadeia recarregada
+    BlocoMinerado b;
+    unsigned int saldosAltura[256];
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int i = 0; i < CONSULTAS_AMOSTRA; i++) {
+        unsigned int id = 1 + genRandLong(&r) % n;
+        buscarBlocoPorId(id, &b);
+        saldosNaAltura(id, saldosAltura);
+    }
+    res->consultaUs = agora_s(t0) * 1e6 / CONSULTAS_AMOSTRA;
+
+    // Sai sem exportar: só o flush importa aqui
+    definirModoCadeiaGrande(1);
+    finalizarStorage();
+}
+
+// Roda 'fase' num filho; o pico de RSS fica isolado por fase e tamanho
+static int rodarFase(int fase, unsigned int n, int grande, ResultadoEscala *res) {
+    int canal[2];
+    if (pipe(canal) != 0) {
+        perror("pipe");
+        return 0;
+    }
+    fflush(NULL);
+
+    pid_t filho = fork();
+    if (filho == 0) {
+        close(canal[0]);
+        // Mensagens do storage não poluem a tabela
+        if (!freopen("/dev/null", "w", stdout)) _exit(1);
+        if (fase == FASE_MINERACAO)
+            medirMineracao(n, grande, res);
+        else
+            medirRecarga(n, grande, res);
+        _exit(write(canal[1], res, sizeof(*res)) == (ssize_t)sizeof(*res) ? 0 : 1);
+    }
+
+    close(canal[1]);
+    ssize_t lidos = read(canal[0], res, sizeof(*res));
+    close(canal[0]);
+
+    int status = 0;
+    struct rusage uso;
+    wait4(filho, &status, 0, &uso);
+    if (fase == FASE_MINERACAO)
+        res->picoMineracaoKB = uso.ru_maxrss;
+    else
+        res->picoRecargaKB = uso.ru_maxrss;
+    return lidos == (ssize_t)sizeof(*res) && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+/**
+ * Uso: ./escala [--grande] [N ...]
+ * Sem tamanhos, mede 30k, 1M, 10M e 100M blocos. Mineração e recarga rodam
+ * em processos filhos separados (o pico de RSS vem do wait4). Atenção: a prova de trabalho
+ * custa ~150 us por bloco, então 100M blocos levam horas e ~40 GB de disco.
+ */
+int main(int argc, char *argv[]) {
+    unsigned int tamanhos[64];
+    int qtdTamanhos = 0;
+    int grande = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--grande") == 0) {
+            grande = 1;
+        } else if (qtdTamanhos < 64) {
+            unsigned long long n = strtoull(argv[i], NULL, 10);
+            if (n < 2 || n > 4000000000ULL) {
+                fprintf(stderr, "Tamanho inválido: %s\n", argv[i]);
+                return 1;
+            }
+            tamanhos[qtdTamanhos++] = (unsigned int)n;
+        }
+    }
+    if (qtdTamanhos == 0) {
+        for (size_t i = 0; i < sizeof(tamanhosPadrao) / sizeof(tamanhosPadrao[0]); i++)
+            tamanhos[qtdTamanhos++] = tamanhosPadrao[i];
+    }
+
+    ResultadoEscala resultados[64];
+    int falhas = 0;
+
+    for (int t = 0; t < qtdTamanhos; t++) {
+        ResultadoEscala *res = &resultados[t];
+        memset(res, 0, sizeof(*res));
+        res->blocos = tamanhos[t];
+
+        fprintf(stderr, "Medindo %u blocos (%s)...\n", tamanhos[t], grande ? "modo grande" : "modo normal");
+        if (!rodarFase(FASE_MINERACAO, tamanhos[t], grande, res) || !rodarFase(FASE_RECARGA, tamanhos[t], grande, res)) {
+            fprintf(stderr, "Falha ao medir %u blocos\n", tamanhos[t]);
+            res->blocos = 0;
+            falhas++;
+        }
+        removerArquivosEscala();
+    }
+
+    printf("\n%-11s %-10s %-9s %-9s %-9s %-10s %-11s %-11s %-11s %-9s\n", "Blocos", "Mineração", "Blocos/s",
+           "Encerr.", "Recarga", "Consulta", "Pico mine.", "Pico carga", "B/bloco", "Disco");
+    printf("%-11s %-10s %-9s %-9s %-9s %-10s %-11s %-11s %-11s %-9s\n", "", "(s)", "", "(s)", "(s)", "(us)",
+           "(MB)", "(MB)", "(RAM carga)", "(MB)");
+    for (int t = 0; t < qtdTamanhos; t++) {
+        ResultadoEscala *res = &resultados[t];
+        if (res->blocos == 0) continue;
+        printf("%-11u %-10.1f %-9.0f %-9.2f %-9.2f %-10.1f %-11.1f %-11.1f %-11.1f %-9.0f\n", res->blocos,
+               res->tempoMineracao, res->blocos / res->tempoMineracao, res->tempoEncerramento, res->tempoRecarga,
+               res->consultaUs, res->picoMineracaoKB / 1024.0, res->picoRecargaKB / 1024.0,
+               (res->rssRecargaKB - res->rssBaseKB) * 1024.0 / res->blocos, res->discoBytes / 1048576.0);
+    }
+    return falhas ? 1 : 0;
+}
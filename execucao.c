@@ -0,0 +1,639 @@
+/*
+ * Execução otimista paralela das transações de um bloco (Block-STM)
+ *
+ * Escalonador colaborativo: as threads pegam tarefas de dois índices
+ * atômicos, um de execução e um de validação, sempre preferindo validar o
+ * que já foi executado abaixo do índice de execução.
+ *    - Execução: a transação lê da memória multiversão a escrita mais
+ *      recente de uma transação anterior (ou o saldo de antes do bloco),
+ *      registra as versões lidas e publica suas escritas.
+ *    - Validação: relê as mesmas contas; se alguma versão mudou, a
+ *      encarnação é abortada, suas escritas viram estimativas e as
+ *      transações seguintes são revalidadas.
+ *    - Estimativa: quem lê uma estimativa espera a transação que a deixou
+ *      (dependência) em vez de executar com um valor que vai mudar.
+ * Uma execução por vez (o storage é escritor único); as threads do pool
+ * dormem entre os blocos.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <pthread.h>
+#include "execucao.h"
+#include "contadores.h"
+
+#define MAX_LOCAIS (2 * EXECUCAO_MAX_TX)    // Origem e destino de cada transação
+#define SLOTS_LOCAIS (2 * MAX_LOCAIS)       // Tabela conta -> local (endereçamento aberto)
+
+// Entrada da memória multiversão: 0 = sem escrita; senão presença | encarnação (30 bits) << 32 | saldo
+#define ENTRADA_PRESENTE (1ULL << 62)
+#define ENTRADA_ESTIMATIVA (1ULL << 63)
+#define MASCARA_ENCARNACAO 0x3FFFFFFFULL
+#define VERSAO_DO_ESTADO (~0ULL)            // Leitura que não achou escrita anterior no bloco
+
+enum { PRONTA, EXECUTANDO, EXECUTADA, ABORTANDO };
+enum { TAREFA_EXECUCAO, TAREFA_VALIDACAO };
+
+typedef struct {
+    pthread_mutex_t trava;
+    unsigned int encarnacao;
+    int estado;
+    unsigned long long dependentes;     // Transações esperando esta (um bit cada)
+} StatusTx;
+
+typedef struct {
+    int tipo;
+    int tx;
+    unsigned int encarnacao;
+} Tarefa;
+
+// Resultado de uma encarnação antes de ser publicado
+typedef struct {
+    unsigned long long leituras[2];     // Versões lidas da origem e do destino
+    int qtdLeituras;
+    int valida;
+    unsigned int saldoOrigem;
+    unsigned int saldoDestino;
+} EncarnacaoTx;
+
+typedef struct {
+    const TransacaoConta *tx;
+    int qtd;
+    unsigned int limiteContas;
+    unsigned char localOrigem[EXECUCAO_MAX_TX];
+    unsigned char localDestino[EXECUCAO_MAX_TX];
+    unsigned int base[MAX_LOCAIS];
+
+    unsigned long long memoria[MAX_LOCAIS][EXECUCAO_MAX_TX];   // Acessada com __atomic_*
+    unsigned long long leituras[EXECUCAO_MAX_TX][2];           // Da última encarnação registrada
+    int qtdLeituras[EXECUCAO_MAX_TX];
+    int escreveu[EXECUCAO_MAX_TX];      // Só quem executa ou abortou a transação mexe
+    int valida[EXECUCAO_MAX_TX];
+    StatusTx status[EXECUCAO_MAX_TX];
+
+    int idxExecucao;
+    int idxValidacao;
+    int decrementos;                    // Quantas vezes um dos índices voltou
+    int tarefasAtivas;
+    int concluida;
+
+    unsigned int execucoes;
+    unsigned int abortos;
+    unsigned int dependencias;
+} Execucao;
+
+static Execucao ex;
+static pthread_once_t travasIniciadas = PTHREAD_ONCE_INIT;
+
+// Pool: a thread que pede a execução também trabalha
+static pthread_t trabalhadores[EXECUCAO_MAX_THREADS];
+static int qtdThreads = 1;
+static pthread_mutex_t travaPool = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t condTrabalho = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t condFim = PTHREAD_COND_INITIALIZER;
+static unsigned long long geracao = 0;
+static unsigned long long geracaoDoPool = 0;   // Geração quando o pool subiu: a primeira que os trabalhadores esperam passar
+static int pendentes = 0;
+static int encerrar = 0;
+
+static void iniciarTravas()
+{
+    for (int i = 0; i < EXECUCAO_MAX_TX; i++)
+        pthread_mutex_init(&ex.status[i].trava, NULL);
+}
+
+// MEMÓRIA MULTIVERSÃO
+
+/**
+ * Escrita mais recente de uma transação anterior a 'txn' no local (ou o
+ * saldo de antes do bloco). Retorna 0 se encontrou uma estimativa, com a
+ * transação que a deixou em *bloqueadora.
+ */
+static int lerLocal(int local, int txn, unsigned int *saldo, unsigned long long *versao, int *bloqueadora)
+{
+    for (int i = txn - 1; i >= 0; i--)
+    {
+        unsigned long long e = __atomic_load_n(&ex.memoria[local][i], __ATOMIC_ACQUIRE);
+        if (e == 0)
+            continue;
+        if (e & ENTRADA_ESTIMATIVA)
+        {
+            *bloqueadora = i;
+            return 0;
+        }
+        *saldo = (unsigned int)e;
+        *versao = (unsigned long long)i << 32 | ((e >> 32) & MASCARA_ENCARNACAO);
+        return 1;
+    }
+    *saldo = ex.base[local];
+    *versao = VERSAO_DO_ESTADO;
+    return 1;
+}
+
+// Roda a transação sobre a memória multiversão; retorna 0 se esbarrou numa estimativa
+static int executarTx(int txn, EncarnacaoTx *s, int *bloqueadora)
+{
+    const TransacaoConta *t = &ex.tx[txn];
+    unsigned int saldoOrigem, saldoDestino;
+
+    s->qtdLeituras = 0;
+    s->valida = 0;
+    if (t->destino >= ex.limiteContas)
+        return 1;
+
+    if (!lerLocal(ex.localOrigem[txn], txn, &saldoOrigem, &s->leituras[0], bloqueadora))
+        return 0;
+    s->qtdLeituras = 1;
+    if (saldoOrigem < t->valor)
+        return 1;
+
+    // Para si mesma: o saldo não muda, mas a escrita existe (como no storage)
+    if (ex.localDestino[txn] == ex.localOrigem[txn])
+    {
+        s->valida = 1;
+        s->saldoOrigem = saldoOrigem;
+        return 1;
+    }
+    if (!lerLocal(ex.localDestino[txn], txn, &saldoDestino, &s->leituras[1], bloqueadora))
+        return 0;
+    s->qtdLeituras = 2;
+    s->valida = 1;
+    s->saldoOrigem = saldoOrigem - t->valor;
+    s->saldoDestino = saldoDestino + t->valor;
+    return 1;
+}
+
+// Publica leituras e escritas da encarnação; retorna 1 se ela escreveu onde a anterior não escrevia
+static int registrar(int txn, unsigned int encarnacao, EncarnacaoTx *s)
+{
+    int anterior = ex.escreveu[txn];
+    int lo = ex.localOrigem[txn], ld = ex.localDestino[txn];
+
+    for (int k = 0; k < s->qtdLeituras; k++)
+        __atomic_store_n(&ex.leituras[txn][k], s->leituras[k], __ATOMIC_RELAXED);
+    __atomic_store_n(&ex.qtdLeituras[txn], s->qtdLeituras, __ATOMIC_RELEASE);
+
+    if (s->valida)
+    {
+        unsigned long long marca = ENTRADA_PRESENTE | (encarnacao & MASCARA_ENCARNACAO) << 32;
+        __atomic_store_n(&ex.memoria[lo][txn], marca | s->saldoOrigem, __ATOMIC_RELEASE);
+        if (ld != lo)
+            __atomic_store_n(&ex.memoria[ld][txn], marca | s->saldoDestino, __ATOMIC_RELEASE);
+    }
+    else if (anterior)
+    {
+        __atomic_store_n(&ex.memoria[lo][txn], 0, __ATOMIC_RELEASE);
+        __atomic_store_n(&ex.memoria[ld][txn], 0, __ATOMIC_RELEASE);
+    }
+    ex.escreveu[txn] = s->valida;
+    __atomic_store_n(&ex.valida[txn], s->valida, __ATOMIC_RELAXED);
+    return s->valida && !anterior;
+}
+
+// Refaz as leituras da última encarnação registrada; 0 se alguma versão mudou
+static int validarLeituras(int txn)
+{
+    int qtd = __atomic_load_n(&ex.qtdLeituras[txn], __ATOMIC_ACQUIRE);
+
+    for (int k = 0; k < qtd; k++)
+    {
+        unsigned int saldo;
+        unsigned long long versao;
+        int bloqueadora;
+        int local = k == 0 ? ex.localOrigem[txn] : ex.localDestino[txn];
+
+        if (!lerLocal(local, txn, &saldo, &versao, &bloqueadora))
+            return 0;
+        if (versao != __atomic_load_n(&ex.leituras[txn][k], __ATOMIC_RELAXED))
+            return 0;
+    }
+    return 1;
+}
+
+static void converterEmEstimativas(int txn)
+{
+    if (!ex.escreveu[txn])
+        return;
+    __atomic_fetch_or(&ex.memoria[ex.localOrigem[txn]][txn], ENTRADA_ESTIMATIVA, __ATOMIC_RELEASE);
+    __atomic_fetch_or(&ex.memoria[ex.localDestino[txn]][txn], ENTRADA_ESTIMATIVA, __ATOMIC_RELEASE);
+}
+
+// ESCALONADOR
+
+static void diminuirIndice(int *indice, int alvo)
+{
+    int atual = __atomic_load_n(indice, __ATOMIC_ACQUIRE);
+    while (alvo < atual && !__atomic_compare_exchange_n(indice, &atual, alvo, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+        ;
+    __atomic_fetch_add(&ex.decrementos, 1, __ATOMIC_ACQ_REL);
+}
+
+static void verificarConclusao()
+{
+    int observado = __atomic_load_n(&ex.decrementos, __ATOMIC_ACQUIRE);
+    int execucao = __atomic_load_n(&ex.idxExecucao, __ATOMIC_ACQUIRE);
+    int validacao = __atomic_load_n(&ex.idxValidacao, __ATOMIC_ACQUIRE);
+
+    if ((execucao < validacao ? execucao : validacao) >= ex.qtd &&
+        __atomic_load_n(&ex.tarefasAtivas, __ATOMIC_ACQUIRE) == 0 &&
+        observado == __atomic_load_n(&ex.decrementos, __ATOMIC_ACQUIRE))
+        __atomic_store_n(&ex.concluida, 1, __ATOMIC_RELEASE);
+}
+
+static int tentarEncarnar(int txn, Tarefa *t)
+{
+    if (txn >= ex.qtd)
+        return 0;
+
+    StatusTx *s = &ex.status[txn];
+    int ok = 0;
+    pthread_mutex_lock(&s->trava);
+    if (s->estado == PRONTA)
+    {
+        s->estado = EXECUTANDO;
+        t->tipo = TAREFA_EXECUCAO;
+        t->tx = txn;
+        t->encarnacao = s->encarnacao;
+        ok = 1;
+    }
+    pthread_mutex_unlock(&s->trava);
+    return ok;
+}
+
+static void marcarPronta(int txn)
+{
+    StatusTx *s = &ex.status[txn];
+    pthread_mutex_lock(&s->trava);
+    s->encarnacao++;
+    s->estado = PRONTA;
+    pthread_mutex_unlock(&s->trava);
+}
+
+static int proximaTarefa(Tarefa *t)
+{
+    if (__atomic_load_n(&ex.idxValidacao, __ATOMIC_ACQUIRE) < __atomic_load_n(&ex.idxExecucao, __ATOMIC_ACQUIRE))
+    {
+        if (__atomic_load_n(&ex.idxValidacao, __ATOMIC_ACQUIRE) >= ex.qtd)
+        {
+            verificarConclusao();
+            return 0;
+        }
+        __atomic_fetch_add(&ex.tarefasAtivas, 1, __ATOMIC_ACQ_REL);
+        int txn = __atomic_fetch_add(&ex.idxValidacao, 1, __ATOMIC_ACQ_REL);
+        if (txn < ex.qtd)
+        {
+            StatusTx *s = &ex.status[txn];
+            pthread_mutex_lock(&s->trava);
+            int executada = s->estado == EXECUTADA;
+            t->encarnacao = s->encarnacao;
+            pthread_mutex_unlock(&s->trava);
+            if (executada)
+            {
+                t->tipo = TAREFA_VALIDACAO;
+                t->tx = txn;
+                return 1;
+            }
+        }
+    }
+    else
+    {
+        if (__atomic_load_n(&ex.idxExecucao, __ATOMIC_ACQUIRE) >= ex.qtd)
+        {
+            verificarConclusao();
+            return 0;
+        }
+        __atomic_fetch_add(&ex.tarefasAtivas, 1, __ATOMIC_ACQ_REL);
+        if (tentarEncarnar(__atomic_fetch_add(&ex.idxExecucao, 1, __ATOMIC_ACQ_REL), t))
+            return 1;
+    }
+    __atomic_fetch_sub(&ex.tarefasAtivas, 1, __ATOMIC_ACQ_REL);
+    return 0;
+}
+
+/**
+ * 'txn' leu uma estimativa de 'bloqueadora': fica esperando por ela e sai
+ * das tarefas ativas. Retorna 0 se a bloqueadora já terminou (reexecutar já).
+ * Trava a menor transação antes da maior, então não há impasse.
+ */
+static int adicionarDependencia(int txn, int bloqueadora)
+{
+    StatusTx *b = &ex.status[bloqueadora];
+    pthread_mutex_lock(&b->trava);
+    if (b->estado == EXECUTADA)
+    {
+        pthread_mutex_unlock(&b->trava);
+        return 0;
+    }
+    pthread_mutex_lock(&ex.status[txn].trava);
+    ex.status[txn].estado = ABORTANDO;
+    pthread_mutex_unlock(&ex.status[txn].trava);
+    b->dependentes |= 1ULL << txn;
+    __atomic_fetch_sub(&ex.tarefasAtivas, 1, __ATOMIC_ACQ_REL);
+    pthread_mutex_unlock(&b->trava);
+    return 1;
+}
+
+static int concluirExecucao(int txn, unsigned int encarnacao, int escreveuNovo, Tarefa *t)
+{
+    StatusTx *s = &ex.status[txn];
+    pthread_mutex_lock(&s->trava);
+    s->estado = EXECUTADA;
+    unsigned long long dependentes = s->dependentes;
+    s->dependentes = 0;
+    pthread_mutex_unlock(&s->trava);
+
+    // Quem esperava volta a ficar pronto; o índice de execução recua até o menor deles
+    if (dependentes)
+    {
+        for (unsigned long long d = dependentes; d; d &= d - 1)
+            marcarPronta(__builtin_ctzll(d));
+        diminuirIndice(&ex.idxExecucao, __builtin_ctzll(dependentes));
+    }
+
+    if (__atomic_load_n(&ex.idxValidacao, __ATOMIC_ACQUIRE) > txn)
+    {
+        // Escrita em conta nova pode invalidar as seguintes: todas são revalidadas
+        if (escreveuNovo)
+            diminuirIndice(&ex.idxValidacao, txn);
+        else
+        {
+            t->tipo = TAREFA_VALIDACAO;
+            t->tx = txn;
+            t->encarnacao = encarnacao;
+            return 1;
+        }
+    }
+    __atomic_fetch_sub(&ex.tarefasAtivas, 1, __ATOMIC_ACQ_REL);
+    return 0;
+}
+
+// Executa a tarefa; retorna 1 se 't' recebeu a próxima tarefa da mesma transação
+static int tentarExecutar(Tarefa *t)
+{
+    for (;;)
+    {
+        EncarnacaoTx s;
+        int bloqueadora;
+
+        __atomic_fetch_add(&ex.execucoes, 1, __ATOMIC_RELAXED);
+        if (executarTx(t->tx, &s, &bloqueadora))
+            return concluirExecucao(t->tx, t->encarnacao, registrar(t->tx, t->encarnacao, &s), t);
+
+        __atomic_fetch_add(&ex.dependencias, 1, __ATOMIC_RELAXED);
+        if (adicionarDependencia(t->tx, bloqueadora))
+            return 0;
+    }
+}
+
+static int validar(Tarefa *t)
+{
+    int txn = t->tx;
+    int abortada = 0;
+
+    if (!validarLeituras(txn))
+    {
+        StatusTx *s = &ex.status[txn];
+        pthread_mutex_lock(&s->trava);
+        if (s->encarnacao == t->encarnacao && s->estado == EXECUTADA)
+        {
+            s->estado = ABORTANDO;
+            abortada = 1;
+        }
+        pthread_mutex_unlock(&s->trava);
+    }
+
+    if (abortada)
+    {
+        __atomic_fetch_add(&ex.abortos, 1, __ATOMIC_RELAXED);
+        converterEmEstimativas(txn);
+        marcarPronta(txn);
+        diminuirIndice(&ex.idxValidacao, txn + 1);
+        if (__atomic_load_n(&ex.idxExecucao, __ATOMIC_ACQUIRE) > txn && tentarEncarnar(txn, t))
+            return 1;
+    }
+    __atomic_fetch_sub(&ex.tarefasAtivas, 1, __ATOMIC_ACQ_REL);
+    return 0;
+}
+
+static void trabalhar()
+{
+    Tarefa t = {TAREFA_EXECUCAO, 0, 0};
+    int temTarefa = 0;
+
+    while (!__atomic_load_n(&ex.concluida, __ATOMIC_ACQUIRE))
+    {
+        if (temTarefa)
+            temTarefa = t.tipo == TAREFA_EXECUCAO ? tentarExecutar(&t) : validar(&t);
+        if (!temTarefa && !(temTarefa = proximaTarefa(&t)))
+            sched_yield();
+    }
+}
+
+// POOL DE THREADS
+
+static void *lacoTrabalhador(void *arg)
+{
+    (void)arg;
+    pthread_mutex_lock(&travaPool);
+    unsigned long long vista = geracaoDoPool;
+    for (;;)
+    {
+        while (geracao == vista && !encerrar)
+            pthread_cond_wait(&condTrabalho, &travaPool);
+        if (encerrar)
+            break;
+        vista = geracao;
+        pthread_mutex_unlock(&travaPool);
+
+        trabalhar();
+
+        pthread_mutex_lock(&travaPool);
+        if (--pendentes == 0)
+            pthread_cond_signal(&condFim);
+    }
+    pthread_mutex_unlock(&travaPool);
+    return NULL;
+}
+
+// Troca o pool por um de 'threads' threads no total (1 = só quem chama). Retorna quantas ficaram.
+int execucaoIniciar(int threads)
+{
+    execucaoFinalizar();
+    pthread_once(&travasIniciadas, iniciarTravas);
+    if (threads < 1) threads = 1;
+    if (threads > EXECUCAO_MAX_THREADS) threads = EXECUCAO_MAX_THREADS;
+
+    pthread_mutex_lock(&travaPool);
+    geracaoDoPool = geracao;
+    pthread_mutex_unlock(&travaPool);
+    for (qtdThreads = 1; qtdThreads < threads; qtdThreads++)
+    {
+        if (pthread_create(&trabalhadores[qtdThreads - 1], NULL, lacoTrabalhador, NULL) != 0)
+        {
+            fprintf(stderr, "AVISO: pool de execução com %d threads\n", qtdThreads);
+            break;
+        }
+    }
+    return qtdThreads;
+}
+
+int execucaoThreads()
+{
+    return qtdThreads;
+}
+
+void execucaoFinalizar()
+{
+    pthread_mutex_lock(&travaPool);
+    encerrar = 1;
+    pthread_cond_broadcast(&condTrabalho);
+    pthread_mutex_unlock(&travaPool);
+
+    for (int i = 0; i < qtdThreads - 1; i++)
+        pthread_join(trabalhadores[i], NULL);
+
+    pthread_mutex_lock(&travaPool);
+    encerrar = 0;
+    pthread_mutex_unlock(&travaPool);
+    qtdThreads = 1;
+}
+
+// EXECUÇÃO DE UM BLOCO
+
+// Local da conta no bloco (cada conta distinta ganha um e tem o saldo de antes do bloco lido uma vez)
+static int localDaConta(unsigned int conta, unsigned int *contas, unsigned char *slots, int *qtdLocais, LeitorSaldo ler, void *contexto)
+{
+    unsigned int slot = (conta * 2654435761u) >> 24;
+    for (;; slot = (slot + 1) & (SLOTS_LOCAIS - 1))
+    {
+        if (slots[slot] == 0)
+            break;
+        if (contas[slots[slot] - 1] == conta)
+            return slots[slot] - 1;
+    }
+    int local = (*qtdLocais)++;
+    contas[local] = conta;
+    ex.base[local] = ler(conta, contexto);
+    slots[slot] = (unsigned char)(local + 1);
+    return local;
+}
+
+/**
+ * Validade das 'qtd' transações (até 64) pela execução otimista no pool.
+ * O estado de 'ler' não pode mudar durante a chamada.
+ */
+void executarOtimista(const TransacaoConta *tx, int qtd, unsigned int limiteContas, LeitorSaldo ler, void *contexto, ResultadoExecucao *res)
+{
+    unsigned int contas[MAX_LOCAIS];
+    unsigned char slots[SLOTS_LOCAIS];
+    int qtdLocais = 0;
+
+    memset(res, 0, sizeof(*res));
+    if (qtd > EXECUCAO_MAX_TX) qtd = EXECUCAO_MAX_TX;
+    if (qtd <= 0)
+        return;
+    pthread_once(&travasIniciadas, iniciarTravas);
+
+    memset(slots, 0, sizeof(slots));
+    ex.tx = tx;
+    ex.qtd = qtd;
+    ex.limiteContas = limiteContas;
+    for (int i = 0; i < qtd; i++)
+    {
+        // Transação para fora do espaço é inválida sem ler nada
+        if (tx[i].destino >= limiteContas)
+            continue;
+        ex.localOrigem[i] = (unsigned char)localDaConta(tx[i].origem, contas, slots, &qtdLocais, ler, contexto);
+        ex.localDestino[i] = (unsigned char)localDaConta(tx[i].destino, contas, slots, &qtdLocais, ler, contexto);
+    }
+    for (int l = 0; l < qtdLocais; l++)
+        memset(ex.memoria[l], 0, qtd * sizeof(ex.memoria[l][0]));
+    for (int i = 0; i < qtd; i++)
+    {
+        ex.qtdLeituras[i] = 0;
+        ex.escreveu[i] = 0;
+        ex.valida[i] = 0;
+        ex.status[i].encarnacao = 0;
+        ex.status[i].estado = PRONTA;
+        ex.status[i].dependentes = 0;
+    }
+    ex.idxExecucao = ex.idxValidacao = ex.decrementos = ex.tarefasAtivas = ex.concluida = 0;
+    ex.execucoes = ex.abortos = ex.dependencias = 0;
+
+    if (qtdThreads > 1)
+    {
+        pthread_mutex_lock(&travaPool);
+        pendentes = qtdThreads - 1;
+        geracao++;
+        pthread_cond_broadcast(&condTrabalho);
+        pthread_mutex_unlock(&travaPool);
+    }
+
+    trabalhar();
+
+    // O estado é reaproveitado no próximo bloco: espera as outras threads saírem dele
+    if (qtdThreads > 1)
+    {
+        pthread_mutex_lock(&travaPool);
+        while (pendentes > 0)
+            pthread_cond_wait(&condFim, &travaPool);
+        pthread_mutex_unlock(&travaPool);
+    }
+
+    for (int i = 0; i < qtd; i++)
+    {
+        if (ex.valida[i])
+            res->validas |= 1ULL << i;
+    }
+    res->execucoes = ex.execucoes;
+    res->abortos = ex.abortos;
+    res->dependencias = ex.dependencias;
+    contadorSomar(CONTADOR_EXECUCOES_OTIMISTAS, ex.execucoes);
+    contadorSomar(CONTADOR_ABORTOS_OTIMISTAS, ex.abortos);
+}
+
+/**
+ * Referência em série: aplica as transações em ordem sobre um rascunho das
+ * contas tocadas e devolve a máscara de válidas.
+ */
+unsigned long long executarEmSerie(const TransacaoConta *tx, int qtd, unsigned int limiteContas, LeitorSaldo ler, void *contexto)
+{
+    unsigned int contas[MAX_LOCAIS], saldos[MAX_LOCAIS];
+    int qtdLocais = 0;
+    unsigned long long validas = 0;
+
+    if (qtd > EXECUCAO_MAX_TX) qtd = EXECUCAO_MAX_TX;
+    for (int i = 0; i < qtd; i++)
+    {
+        if (tx[i].destino >= limiteContas)
+            continue;
+
+        int o = -1, d = -1;
+        for (int l = 0; l < qtdLocais; l++)
+        {
+            if (contas[l] == tx[i].origem) o = l;
+            if (contas[l] == tx[i].destino) d = l;
+        }
+        if (o < 0)
+        {
+            o = qtdLocais++;
+            contas[o] = tx[i].origem;
+            saldos[o] = ler(tx[i].origem, contexto);
+            if (tx[i].destino == tx[i].origem) d = o;
+        }
+        if (saldos[o] < tx[i].valor)
+            continue;
+        if (d < 0)
+        {
+            d = qtdLocais++;
+            contas[d] = tx[i].destino;
+            saldos[d] = ler(tx[i].destino, contexto);
+        }
+        saldos[o] -= tx[i].valor;
+        saldos[d] += tx[i].valor;
+        validas |= 1ULL << i;
+    }
+    return validas;
+}
@@ -0,0 +1,39 @@
+#ifndef EXECUCAO_H
+#define EXECUCAO_H
+
+#include "formato.h"
+
+/**
+ * Execução otimista das transações de um bloco (estilo Block-STM)
+ *
+ * As transações rodam especulativamente em várias threads sobre uma memória
+ * multiversão (um valor por conta e por transação que a escreveu). Cada
+ * execução registra as versões que leu; a validação refaz as leituras e só
+ * a transação cujo conjunto de leitura mudou é abortada e reexecutada. O
+ * resultado é o da execução em série, inclusive quais transações são
+ * rejeitadas por saldo insuficiente.
+ *
+ * Regra de uma transação (a mesma do storage): válida se o destino está
+ * abaixo de 'limiteContas' e a origem tem pelo menos 'valor' naquele ponto
+ * do bloco; uma válida tira 'valor' da origem e soma no destino.
+ */
+#define EXECUCAO_MAX_TX 64          // Uma transação por bit da máscara de válidas
+#define EXECUCAO_MAX_THREADS 64
+
+// Saldo de uma conta antes do bloco; chamado só pela thread que pediu a execução
+typedef unsigned int (*LeitorSaldo)(unsigned int conta, void *contexto);
+
+typedef struct {
+    unsigned long long validas;     // Bit i = transação i aplicada
+    unsigned int execucoes;         // Encarnações executadas (qtd se não houve conflito)
+    unsigned int abortos;           // Validações que invalidaram uma encarnação
+    unsigned int dependencias;      // Leituras que esbarraram numa estimativa e esperaram
+} ResultadoExecucao;
+
+unsigned long long executarEmSerie(const TransacaoConta *tx, int qtd, unsigned int limiteContas, LeitorSaldo ler, void *contexto);
+void executarOtimista(const TransacaoConta *tx, int qtd, unsigned int limiteContas, LeitorSaldo ler, void *contexto, ResultadoExecucao *res);
+int execucaoIniciar(int threads);
+int execucaoThreads();
+void execucaoFinalizar();
+
+#endif
@@ -0,0 +1,275 @@
+/*
+ * Bifurcações e escolha de cadeia (fork-choice)
+ *
+ * Blocos que não estendem o topo ficam num pool de blocos laterais. Quando
+ * um ramo lateral passa a ter mais trabalho acumulado que a cadeia
+ * principal, a cadeia é reorganizada:
+ *    1. desconecta os blocos do topo até o ponto de bifurcação, usando os
+ *       registros de desfazer do storage (O(profundidade), sem reconstruir)
+ *    2. os blocos desconectados vão para o pool (podem voltar a vencer)
+ *    3. conecta os blocos do ramo vencedor, do mais antigo ao mais novo
+ *
+ * Trabalho: a dificuldade é fixa (hash[0] == 0, 2^8 tentativas esperadas),
+ * então o trabalho acumulado é proporcional à altura e a cadeia mais
+ * pesada é a mais longa. Empate mantém o topo visto primeiro.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "fork.h"
+#include "miner.h"
+#include "storage.h"
+#include "hashindex.h"
+
+#define TRABALHO_POR_BLOCO 256ULL   // 2^8 hashes esperados para hash[0] == 0
+#define TAMANHO_POOL 1024           // Slots da tabela de blocos laterais (potência de 2)
+
+typedef struct NoLateral {
+    BlocoMinerado bloco;
+    struct NoLateral *prox;
+} NoLateral;
+
+static NoLateral *blocosLaterais[TAMANHO_POOL];   // Tabela hash com encadeamento
+static unsigned int qtdLaterais = 0;
+
+unsigned long long trabalhoAcumulado(unsigned int altura)
+{
+    return (unsigned long long)altura * TRABALHO_POR_BLOCO;
+}
+
+static unsigned int slotDoHash(const unsigned char hash[SHA256_LEN])
+{
+    return (unsigned int)(prefixoDoHash(hash) & (TAMANHO_POOL - 1));
+}
+
+static NoLateral *buscarLateral(const unsigned char hash[SHA256_LEN])
+{
+    for (NoLateral *no = blocosLaterais[slotDoHash(hash)]; no != NULL; no = no->prox)
+    {
+        if (memcmp(no->bloco.hash, hash, SHA256_LEN) == 0)
+            return no;
+    }
+    return NULL;
+}
+
+static void guardarLateral(BlocoMinerado *b)
+{
+    NoLateral *novo = verifica_malloc(sizeof(NoLateral), "guardarLateral");
+    novo->bloco = *b;
+    novo->prox = blocosLaterais[slotDoHash(b->hash)];
+    blocosLaterais[slotDoHash(b->hash)] = novo;
+    qtdLaterais++;
+}
+
+static void removerLateral(const unsigned char hash[SHA256_LEN])
+{
+    NoLateral **atual = &blocosLaterais[slotDoHash(hash)];
+    while (*atual != NULL)
+    {
+        if (memcmp((*atual)->bloco.hash, hash, SHA256_LEN) == 0)
+        {
+            NoLateral *removido = *atual;
+            *atual = removido->prox;
+            free(removido);
+            qtdLaterais--;
+            return;
+        }
+        atual = &(*atual)->prox;
+    }
+}
+
+// Pai está na cadeia principal exatamente na altura anterior?
+static int paiNaPrincipal(BlocoMinerado *b)
+{
+    if (b->bloco.numero == 1)
+        return 1;
+    return localizarBlocoPorHash(b->bloco.hashAnterior) == b->bloco.numero - 1;
+}
+
+/**
+ * Descarta os laterais que nenhuma reorganização pode mais usar: um bloco
+ * na altura n bifurca em n - 1 ou abaixo, então com n <= topo - profundidade
+ * de desfazer o ramo já é mais fundo que o limite (e os filhos também).
+ * Desconectar e reconectar move topo e profundidade juntos, então o limite
+ * só avança.
+ */
+static void podarLaterais()
+{
+    unsigned int total = obterTotalBlocos();
+    unsigned int profundidade = profundidadeDesfazerDisponivel();
+
+    if (qtdLaterais == 0 || total <= profundidade)
+        return;
+
+    unsigned int limite = total - profundidade;
+    for (int i = 0; i < TAMANHO_POOL; i++)
+    {
+        NoLateral **atual = &blocosLaterais[i];
+        while (*atual != NULL)
+        {
+            if ((*atual)->bloco.bloco.numero <= limite)
+            {
+                NoLateral *removido = *atual;
+                *atual = removido->prox;
+                free(removido);
+                qtdLaterais--;
+            }
+            else
+                atual = &(*atual)->prox;
+        }
+    }
+}
+
+/**
+ * Troca a cadeia principal pelo ramo que termina em 'topo'. Retorna 0 (sem
+ * alterar nada) se a bifurcação for mais funda que os registros de desfazer.
+ * O ramo tem no máximo profundidade + 1 blocos, então a memória não depende
+ * da altura da cadeia.
+ */
+static int reorganizar(BlocoMinerado *topo)
+{
+    unsigned int maxRamo = profundidadeDesfazerDisponivel() + 1;
+    BlocoMinerado *ramo = verifica_malloc(maxRamo * sizeof(BlocoMinerado), "reorganizar");
+    unsigned int qtdRamo = 0;
+    BlocoMinerado atual = *topo;
+
+    // Sobe pelo pool até achar o ancestral na cadeia principal
+    while (1)
+    {
+        if (qtdRamo == maxRamo)
+        {
+            fprintf(stderr, "AVISO: Ramo lateral mais fundo que o limite de desfazer (%u)\n", maxRamo - 1);
+            free(ramo);
+            return 0;
+        }
+        ramo[qtdRamo++] = atual;
+        if (paiNaPrincipal(&atual))
+            break;
+        NoLateral *pai = buscarLateral(atual.bloco.hashAnterior);
+        if (pai == NULL)
+        {
+            free(ramo);
+            return 0;
+        }
+        atual = pai->bloco;
+    }
+
+    unsigned int bifurcacao = atual.bloco.numero - 1;
+    if (obterTotalBlocos() - bifurcacao > profundidadeDesfazerDisponivel())
+    {
+        fprintf(stderr, "AVISO: Reorganização de %u blocos excede o limite de desfazer (%u)\n",
+                obterTotalBlocos() - bifurcacao, profundidadeDesfazerDisponivel());
+        free(ramo);
+        return 0;
+    }
+
+    // Desconecta o topo atual; os blocos removidos continuam candidatos
+    BlocoMinerado removido;
+    while (obterTotalBlocos() > bifurcacao && desconectarBlocoTopo(&removido))
+        guardarLateral(&removido);
+
+    // Conecta o ramo do mais antigo ao mais novo
+    for (unsigned int i = qtdRamo; i > 0; i--)
+    {
+        removerLateral(ramo[i - 1].hash);
+        adicionarBloco(&ramo[i - 1]);
+    }
+
+    free(ramo);
+    podarLaterais();
+    return 1;
+}
+
+// Prova de trabalho e duplicidade; retorna -1 se o bloco pode seguir
+static int conferirCabecalho(BlocoMinerado *b)
+{
+    unsigned char hash[SHA256_LEN];
+
+    calcularHashFormato(&b->bloco, contasDaCadeia() != 0, hash);
+    if (memcmp(hash, b->hash, SHA256_LEN) != 0 || hash[0] != 0 || b->bloco.numero == 0)
+        return SUBMISSAO_INVALIDO;
+
+    if (localizarBlocoPorHash(b->hash) != 0 || buscarLateral(b->hash) != NULL)
+        return SUBMISSAO_DUPLICADO;
+    return -1;
+}
+
+// Bloco que já passou por conferirCabecalho
+static int encaixarBloco(BlocoMinerado *b)
+{
+    unsigned char topo[SHA256_LEN];
+
+    // Caso comum: estende o topo
+    unsigned int total = obterTotalBlocos();
+    getUltimoHash(topo);
+    if (b->bloco.numero == total + 1 && memcmp(b->bloco.hashAnterior, topo, SHA256_LEN) == 0)
+    {
+        adicionarBloco(b);
+        podarLaterais();
+        return SUBMISSAO_CONECTADO;
+    }
+
+    // Pai tem que ser conhecido e estar exatamente uma altura abaixo
+    if (b->bloco.numero == 1)
+        return SUBMISSAO_INVALIDO;
+    if (!paiNaPrincipal(b))
+    {
+        NoLateral *pai = buscarLateral(b->bloco.hashAnterior);
+        if (pai == NULL)
+            return SUBMISSAO_ORFAO;
+        if (pai->bloco.bloco.numero + 1 != b->bloco.numero)
+            return SUBMISSAO_INVALIDO;
+    }
+
+    guardarLateral(b);
+
+    if (trabalhoAcumulado(b->bloco.numero) > trabalhoAcumulado(total) && reorganizar(b))
+        return SUBMISSAO_REORG;
+    return SUBMISSAO_LATERAL;
+}
+
+/**
+ * Entrada única de blocos vindos da rede (ou de outro minerador).
+ * Retorna um dos códigos SUBMISSAO_*.
+ */
+int submeterBloco(BlocoMinerado *b)
+{
+    int codigo = conferirCabecalho(b);
+    return codigo >= 0 ? codigo : encaixarBloco(b);
+}
+
+/**
+ * Submissão com as assinaturas das transações (uma por slot): depois da
+ * prova de trabalho, o lote é conferido antes de o bloco chegar ao ledger
+ * ou ao pool de laterais. As assinaturas não são gravadas; um bloco aceito
+ * já foi verificado.
+ */
+int submeterBlocoAssinado(BlocoMinerado *b, const unsigned char assinaturas[][ASSINATURA_LEN])
+{
+    int codigo = conferirCabecalho(b);
+    if (codigo >= 0)
+        return codigo;
+    if (!verificarAssinaturasBloco(b->bloco.data, contasDaCadeia() != 0, b->bloco.numero, assinaturas))
+        return SUBMISSAO_ASSINATURA;
+    return encaixarBloco(b);
+}
+
+unsigned int quantidadeBlocosLaterais()
+{
+    return qtdLaterais;
+}
+
+void limparBlocosLaterais()
+{
+    for (int i = 0; i < TAMANHO_POOL; i++)
+    {
+        while (blocosLaterais[i] != NULL)
+        {
+            NoLateral *prox = blocosLaterais[i]->prox;
+            free(blocosLaterais[i]);
+            blocosLaterais[i] = prox;
+        }
+    }
+    qtdLaterais = 0;
+}
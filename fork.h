@@ -0,0 +1,22 @@
+#ifndef FORK_H
+#define FORK_H
+
+#include "structs.h"
+#include "assinaturas.h"
+
+// Resultado de submeterBloco
+#define SUBMISSAO_INVALIDO 0    // Prova de trabalho ou numeração inválida
+#define SUBMISSAO_DUPLICADO 1   // Bloco já conhecido (cadeia principal ou lateral)
+#define SUBMISSAO_ORFAO 2       // Pai desconhecido: bloco descartado
+#define SUBMISSAO_CONECTADO 3   // Estendeu o topo da cadeia principal
+#define SUBMISSAO_LATERAL 4     // Guardado em ramo lateral com menos trabalho
+#define SUBMISSAO_REORG 5       // Ramo lateral passou a ter mais trabalho e virou a cadeia principal
+#define SUBMISSAO_ASSINATURA 6  // Alguma transação com assinatura inválida: bloco descartado
+
+int submeterBloco(BlocoMinerado *b);
+int submeterBlocoAssinado(BlocoMinerado *b, const unsigned char assinaturas[][ASSINATURA_LEN]);
+unsigned long long trabalhoAcumulado(unsigned int altura);
+unsigned int quantidadeBlocosLaterais();
+void limparBlocosLaterais();
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef FORMATO_H
+#define FORMATO_H
+
+#include <stdint.h>
+#include <string.h>
+#include "structs.h"
+
+/**
+ * Formatos do vetor 'data' (184 bytes, o registro do bloco não muda)
+ *
+ * v1: 61 transações de 3 bytes (origem, destino, valor) + minerador no
+ *     byte 183. Endereços 0-255, valores até 255. Valor 0 é vaga; origem,
+ *     destino e valor zerados encerram a lista.
+ * v2: 15 transações de 12 bytes (origem, destino e valor em 32 bits,
+ *     little-endian) + minerador em 32 bits no byte 180. Valor 0 encerra a
+ *     lista. O gênesis de uma cadeia v2 leva a marca e a quantidade de
+ *     contas depois da frase, então o formato é lido do próprio .bin.
+ */
+#define V1_TRANSACAO_SIZE 3
+#define V1_MAX_TRANSACOES 61
+#define V1_MINERADOR_OFFSET 183
+
+#define V2_TRANSACAO_SIZE 12
+#define V2_MAX_TRANSACOES 15
+#define V2_MINERADOR_OFFSET 180
+#define V2_MARCA "CONTAS-V2"
+#define V2_MARCA_OFFSET 160             // Depois da frase do gênesis (70 bytes com o '\0')
+#define V2_QTD_CONTAS_OFFSET 172
+
+typedef struct {
+    uint32_t origem;
+    uint32_t destino;
+    uint32_t valor;
+} TransacaoConta;
+
+static inline uint32_t lerU32(const unsigned char *p)
+{
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static inline void gravarU32(unsigned char *p, uint32_t v)
+{
+    p[0] = (unsigned char)v;
+    p[1] = (unsigned char)(v >> 8);
+    p[2] = (unsigned char)(v >> 16);
+    p[3] = (unsigned char)(v >> 24);
+}
+
+// Quantidade de contas de uma cadeia v2 pelo gênesis (0 = cadeia v1)
+static inline uint32_t formatoContasDoGenesis(const unsigned char data[DATA_SIZE])
+{
+    if (memcmp(&data[V2_MARCA_OFFSET], V2_MARCA, sizeof(V2_MARCA)) != 0)
+        return 0;
+    return lerU32(&data[V2_QTD_CONTAS_OFFSET]);
+}
+
+static inline void formatoMarcarGenesisV2(unsigned char data[DATA_SIZE], uint32_t qtdContas)
+{
+    memcpy(&data[V2_MARCA_OFFSET], V2_MARCA, sizeof(V2_MARCA));
+    gravarU32(&data[V2_QTD_CONTAS_OFFSET], qtdContas);
+}
+
+static inline int formatoMaxTransacoes(int v2)
+{
+    return v2 ? V2_MAX_TRANSACOES : V1_MAX_TRANSACOES;
+}
+
+static inline uint32_t formatoMinerador(const unsigned char data[DATA_SIZE], int v2)
+{
+    return v2 ? lerU32(&data[V2_MINERADOR_OFFSET]) : data[V1_MINERADOR_OFFSET];
+}
+
+static inline void formatoGravarTransacaoV2(unsigned char data[DATA_SIZE], int slot, uint32_t origem, uint32_t destino, uint32_t valor)
+{
+    unsigned char *p = &data[slot * V2_TRANSACAO_SIZE];
+    gravarU32(p, origem);
+    gravarU32(p + 4, destino);
+    gravarU32(p + 8, valor);
+}
+
+/**
+ * Transação do slot em qualquer formato (não vale para o gênesis).
+ * Retorna 1 = transferência, 0 = vaga (só v1), -1 = fim da lista.
+ */
+static inline int formatoLerTransacao(const unsigned char data[DATA_SIZE], int v2, int slot, TransacaoConta *tx)
+{
+    if (v2)
+    {
+        const unsigned char *p = &data[slot * V2_TRANSACAO_SIZE];
+        tx->origem = lerU32(p);
+        tx->destino = lerU32(p + 4);
+        tx->valor = lerU32(p + 8);
+        return tx->valor > 0 ? 1 : -1;
+    }
+    const unsigned char *p = &data[slot * V1_TRANSACAO_SIZE];
+    tx->origem = p[0];
+    tx->destino = p[1];
+    tx->valor = p[2];
+    if (tx->valor > 0)
+        return 1;
+    return tx->origem == 0 && tx->destino == 0 ? -1 : 0;
+}
+
+#endif
@@ -0,0 +1,283 @@
+/*
+ * Índice de blocos por hash (prefixo de 8 bytes -> ID do bloco)
+ *
+ * Diretório radix: os B bits mais altos da chave escolhem um balde e cada
+ * balde é um vetor pequeno ordenado. Como hashes são uniformes, os baldes
+ * ficam com ~BALDE_MEDIO entradas:
+ *    - busca exata: 1 acesso ao diretório + busca binária no balde
+ *    - busca por prefixo: só os baldes cobertos pelo prefixo
+ *    - inserção: O(BALDE_MEDIO); o diretório dobra quando a média estoura
+ * Percorrer os baldes em ordem dá o vetor global ordenado, que é o formato
+ * persistido em disco (.idx).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hashindex.h"
+
+#define BITS_INICIAIS 10        // 1024 baldes
+#define BALDE_MEDIO 64          // Média de entradas por balde antes de dobrar o diretório
+#define MAGICO_INDICE 0x58494342u  // "BCIX"
+#define VERSAO_INDICE 1
+
+typedef struct {
+    uint64_t prefixo;
+    unsigned int idBloco;
+} EntradaHash;
+
+typedef struct {
+    EntradaHash *entradas;
+    unsigned int qtd;
+    unsigned int capacidade;
+} BaldeHash;
+
+typedef struct {
+    unsigned int magico;
+    unsigned int versao;
+    unsigned int totalBlocos;
+    unsigned int qtdEntradas;
+    unsigned char hashTopo[SHA256_LEN];  // Detecta índice de outra cadeia com o mesmo tamanho
+} CabecalhoIndice;
+
+static BaldeHash *baldes = NULL;
+static unsigned int bitsDiretorio = 0;
+static unsigned int totalEntradas = 0;
+
+static void *realocar(void *ptr, size_t tamanho, const char *contexto)
+{
+    void *novo = realloc(ptr, tamanho);
+    if (!novo)
+    {
+        fprintf(stderr, "Erro realloc: %s\n", contexto);
+        exit(1);
+    }
+    return novo;
+}
+
+uint64_t prefixoDoHash(const unsigned char hash[SHA256_LEN])
+{
+    uint64_t p = 0;
+    for (int i = 0; i < 8; i++)
+        p = (p << 8) | hash[PREFIXO_OFFSET + i];
+    return p;
+}
+
+static unsigned int baldeDe(uint64_t prefixo)
+{
+    return (unsigned int)(prefixo >> (64 - bitsDiretorio));
+}
+
+static void anexarNoBalde(BaldeHash *b, EntradaHash e)
+{
+    if (b->qtd == b->capacidade)
+    {
+        b->capacidade = b->capacidade == 0 ? 8 : b->capacidade * 2;
+        b->entradas = realocar(b->entradas, b->capacidade * sizeof(EntradaHash), "indiceHash");
+    }
+    b->entradas[b->qtd++] = e;
+}
+
+static BaldeHash *alocarDiretorio(unsigned int bits)
+{
+    BaldeHash *novo = calloc((size_t)1 << bits, sizeof(BaldeHash));
+    if (!novo)
+    {
+        fprintf(stderr, "Erro malloc: diretório do índice de hashes\n");
+        exit(1);
+    }
+    return novo;
+}
+
+void indiceHashInicializar()
+{
+    indiceHashLimpar();
+    bitsDiretorio = BITS_INICIAIS;
+    baldes = alocarDiretorio(bitsDiretorio);
+}
+
+// Dobra o diretório: cada balde se divide em dois mantendo a ordem
+static void dobrarDiretorio()
+{
+    unsigned int qtdAntiga = 1u << bitsDiretorio;
+    BaldeHash *antigos = baldes;
+
+    bitsDiretorio++;
+    baldes = alocarDiretorio(bitsDiretorio);
+
+    for (unsigned int i = 0; i < qtdAntiga; i++)
+    {
+        for (unsigned int j = 0; j < antigos[i].qtd; j++)
+            anexarNoBalde(&baldes[baldeDe(antigos[i].entradas[j].prefixo)], antigos[i].entradas[j]);
+        free(antigos[i].entradas);
+    }
+    free(antigos);
+}
+
+void indiceHashInserir(uint64_t prefixo, unsigned int idBloco)
+{
+    if (totalEntradas >= ((unsigned int)BALDE_MEDIO << bitsDiretorio))
+        dobrarDiretorio();
+
+    BaldeHash *b = &baldes[baldeDe(prefixo)];
+    EntradaHash nova = {prefixo, idBloco};
+
+    anexarNoBalde(b, nova);
+
+    // Inserção ordenada: desloca para a direita os maiores
+    unsigned int pos = b->qtd - 1;
+    while (pos > 0 && b->entradas[pos - 1].prefixo > prefixo)
+    {
+        b->entradas[pos] = b->entradas[pos - 1];
+        pos--;
+    }
+    b->entradas[pos] = nova;
+    totalEntradas++;
+}
+
+// Remove a entrada (prefixo, idBloco); o diretório não encolhe
+void indiceHashRemover(uint64_t prefixo, unsigned int idBloco)
+{
+    if (baldes == NULL)
+        return;
+
+    BaldeHash *b = &baldes[baldeDe(prefixo)];
+    for (unsigned int j = 0; j < b->qtd; j++)
+    {
+        if (b->entradas[j].prefixo == prefixo && b->entradas[j].idBloco == idBloco)
+        {
+            memmove(&b->entradas[j], &b->entradas[j + 1], (b->qtd - j - 1) * sizeof(EntradaHash));
+            b->qtd--;
+            totalEntradas--;
+            return;
+        }
+    }
+}
+
+/**
+ * IDs dos blocos cuja chave está em [minimo, maximo] (um prefixo vira esse
+ * intervalo). Copia até 'maxIds' e retorna o total encontrado.
+ */
+unsigned int indiceHashBuscar(uint64_t minimo, uint64_t maximo, unsigned int *ids, unsigned int maxIds)
+{
+    unsigned int encontrados = 0;
+    if (baldes == NULL)
+        return 0;
+
+    for (unsigned int bi = baldeDe(minimo); bi <= baldeDe(maximo); bi++)
+    {
+        BaldeHash *b = &baldes[bi];
+
+        // Primeira entrada >= minimo
+        unsigned int esq = 0, dir = b->qtd;
+        while (esq < dir)
+        {
+            unsigned int meio = (esq + dir) / 2;
+            if (b->entradas[meio].prefixo < minimo)
+                esq = meio + 1;
+            else
+                dir = meio;
+        }
+
+        for (unsigned int j = esq; j < b->qtd && b->entradas[j].prefixo <= maximo; j++)
+        {
+            if (encontrados < maxIds)
+                ids[encontrados] = b->entradas[j].idBloco;
+            encontrados++;
+        }
+    }
+    return encontrados;
+}
+
+/**
+ * Grava o índice inteiro. Em qualquer falha de escrita o arquivo é
+ * apagado, para uma gravação incompleta não ser carregada como válida.
+ */
+int indiceHashSalvar(const char *nomeArquivo, unsigned int totalBlocos, const unsigned char hashTopo[SHA256_LEN])
+{
+    FILE *arq = fopen(nomeArquivo, "wb");
+    if (!arq)
+        return 0;
+
+    CabecalhoIndice cab = {MAGICO_INDICE, VERSAO_INDICE, totalBlocos, totalEntradas, {0}};
+    memcpy(cab.hashTopo, hashTopo, SHA256_LEN);
+    int ok = fwrite(&cab, sizeof(cab), 1, arq) == 1;
+
+    // Baldes vazios não têm vetor alocado (entradas == NULL)
+    for (unsigned int i = 0; ok && i < (1u << bitsDiretorio); i++)
+    {
+        if (baldes[i].qtd > 0)
+            ok = fwrite(baldes[i].entradas, sizeof(EntradaHash), baldes[i].qtd, arq) == baldes[i].qtd;
+    }
+
+    if (fclose(arq) != 0)
+        ok = 0;
+    if (!ok)
+        remove(nomeArquivo);
+    return ok;
+}
+
+/**
+ * Carrega o índice salvo se ele corresponder exatamente à cadeia atual
+ * (mesmo total de blocos e mesmo hash do topo). Retorna 1 se carregou.
+ */
+int indiceHashCarregar(const char *nomeArquivo, unsigned int totalBlocos, const unsigned char hashTopo[SHA256_LEN])
+{
+    FILE *arq = fopen(nomeArquivo, "rb");
+    if (!arq)
+        return 0;
+
+    CabecalhoIndice cab;
+    if (fread(&cab, sizeof(cab), 1, arq) != 1 || cab.magico != MAGICO_INDICE || cab.versao != VERSAO_INDICE ||
+        cab.totalBlocos != totalBlocos || cab.qtdEntradas != totalBlocos || memcmp(cab.hashTopo, hashTopo, SHA256_LEN) != 0)
+    {
+        fclose(arq);
+        return 0;
+    }
+
+    // Diretório já no tamanho final: nenhuma divisão de balde durante a carga
+    indiceHashLimpar();
+    bitsDiretorio = BITS_INICIAIS;
+    while (((unsigned long long)BALDE_MEDIO << bitsDiretorio) < cab.qtdEntradas)
+        bitsDiretorio++;
+    baldes = alocarDiretorio(bitsDiretorio);
+
+    // Entradas já vêm ordenadas: basta anexar ao balde certo
+    EntradaHash lote[1024];
+    size_t lidos;
+    while ((lidos = fread(lote, sizeof(EntradaHash), 1024, arq)) > 0)
+    {
+        for (size_t i = 0; i < lidos; i++)
+            anexarNoBalde(&baldes[baldeDe(lote[i].prefixo)], lote[i]);
+        totalEntradas += (unsigned int)lidos;
+    }
+    fclose(arq);
+
+    if (totalEntradas != cab.qtdEntradas)
+    {
+        indiceHashInicializar();
+        return 0;
+    }
+    return 1;
+}
+
+size_t indiceHashMemoria()
+{
+    size_t total = ((size_t)1 << bitsDiretorio) * sizeof(BaldeHash);
+    for (unsigned int i = 0; baldes != NULL && i < (1u << bitsDiretorio); i++)
+        total += baldes[i].capacidade * sizeof(EntradaHash);
+    return total;
+}
+
+void indiceHashLimpar()
+{
+    if (baldes != NULL)
+    {
+        for (unsigned int i = 0; i < (1u << bitsDiretorio); i++)
+            free(baldes[i].entradas);
+        free(baldes);
+    }
+    baldes = NULL;
+    bitsDiretorio = 0;
+    totalEntradas = 0;
+}
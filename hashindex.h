@@ -0,0 +1,20 @@
+#ifndef HASHINDEX_H
+#define HASHINDEX_H
+
+#include <stdint.h>
+#include "structs.h"
+
+// hash[0] é sempre 0 (dificuldade), então a chave usa os 8 bytes seguintes
+#define PREFIXO_OFFSET 1
+
+uint64_t prefixoDoHash(const unsigned char hash[SHA256_LEN]);
+void indiceHashInicializar();
+void indiceHashInserir(uint64_t prefixo, unsigned int idBloco);
+void indiceHashRemover(uint64_t prefixo, unsigned int idBloco);
+unsigned int indiceHashBuscar(uint64_t minimo, uint64_t maximo, unsigned int *ids, unsigned int maxIds);
+int indiceHashSalvar(const char *nomeArquivo, unsigned int totalBlocos, const unsigned char hashTopo[SHA256_LEN]);
+int indiceHashCarregar(const char *nomeArquivo, unsigned int totalBlocos, const unsigned char hashTopo[SHA256_LEN]);
+size_t indiceHashMemoria();
+void indiceHashLimpar();
+
+#endif
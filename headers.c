@@ -0,0 +1,142 @@
+/*
+ * Arquivo de cabeçalhos (.hdr) mantido ao lado do blockchain.bin
+ *
+ * Cada registro tem 136 bytes em vez dos 256 do bloco completo. A prova de
+ * trabalho é refeita sem ler os 184 bytes de 'data': no v2 com a raiz Merkle,
+ * que é o que o hash do bloco cobre nesse formato; no v1 com o estado parcial
+ * do SHA-256 (uma compressão), que não amarra número, nonce nem raiz.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "headers.h"
+#include "merkle.h"
+#include "miner.h"
+
+#define LOTE_CABECALHOS 1024    // Cabeçalhos lidos por vez do disco
+
+// 'v2' escolhe as folhas da raiz Merkle e a regra do hash (sem estado parcial no v2)
+void montarCabecalho(BlocoMinerado *b, int v2, CabecalhoBloco *cab)
+{
+    cab->numero = b->bloco.numero;
+    cab->nonce = b->bloco.nonce;
+    memcpy(cab->hashAnterior, b->bloco.hashAnterior, SHA256_LEN);
+    if (v2)
+        memset(cab->estadoParcial, 0, SHA256_LEN);
+    else
+        calcularEstadoParcial(&b->bloco, cab->estadoParcial);
+    calcularRaizMerkle(b->bloco.data, v2, cab->raizDados);
+    memcpy(cab->hash, b->hash, SHA256_LEN);
+}
+
+/**
+ * Verifica numeração, encadeamento e prova de trabalho usando só cabeçalhos.
+ * No v2 o hash é refeito sobre número, nonce e raiz, que ficam conferidos.
+ * No v1 a prova de trabalho é sobre o estado parcial opaco: 'numero', 'nonce'
+ * e 'raizDados' não entram na conta (ver CabecalhoBloco em structs.h).
+ * Lê no máximo 'limite' registros: o arquivo pode crescer durante a leitura.
+ * Retorna 1 se esses cabeçalhos são válidos, 0 no primeiro inválido.
+ */
+int verificarCabecalhos(const char *nomeArquivo, int v2, unsigned int limite, unsigned int *totalVerificados)
+{
+    FILE *arq = fopen(nomeArquivo, "rb");
+    *totalVerificados = 0;
+    if (!arq)
+    {
+        printf("Erro ao abrir arquivo de cabeçalhos (%s).\n", nomeArquivo);
+        return 0;
+    }
+
+    // Lote por chamada: a verificação roda fora da trava de índices
+    CabecalhoBloco *lote = malloc(LOTE_CABECALHOS * sizeof(CabecalhoBloco));
+    if (!lote)
+    {
+        fprintf(stderr, "Erro malloc: verificarCabecalhos\n");
+        exit(1);
+    }
+    unsigned char hashAnterior[SHA256_LEN] = {0};
+    unsigned char hashCalculado[SHA256_LEN];
+    unsigned int esperado = 1;
+
+    while (*totalVerificados < limite)
+    {
+        size_t pedidos = limite - *totalVerificados < LOTE_CABECALHOS ? limite - *totalVerificados : LOTE_CABECALHOS;
+        size_t lidos = fread(lote, sizeof(CabecalhoBloco), pedidos, arq);
+        if (lidos == 0)
+            break;
+
+        for (size_t i = 0; i < lidos; i++)
+        {
+            CabecalhoBloco *c = &lote[i];
+
+            if (c->numero != esperado)
+            {
+                printf("Cabeçalho %u: número fora de sequência (lido %u).\n", esperado, c->numero);
+                fclose(arq);
+                free(lote);
+                return 0;
+            }
+            if (memcmp(c->hashAnterior, hashAnterior, SHA256_LEN) != 0)
+            {
+                printf("Cabeçalho %u: hashAnterior não confere.\n", c->numero);
+                fclose(arq);
+                free(lote);
+                return 0;
+            }
+
+            // v1: só o estado parcial e o hashAnterior entram; o resto do registro não é amarrado
+            if (v2)
+                calcularHashComRaiz(c->numero, c->nonce, c->raizDados, c->hashAnterior, hashCalculado);
+            else
+                finalizarHashParcial(c->estadoParcial, c->hashAnterior, hashCalculado);
+            if (memcmp(hashCalculado, c->hash, SHA256_LEN) != 0 || c->hash[0] != 0)
+            {
+                printf("Cabeçalho %u: prova de trabalho inválida.\n", c->numero);
+                fclose(arq);
+                free(lote);
+                return 0;
+            }
+
+            memcpy(hashAnterior, c->hash, SHA256_LEN);
+            esperado++;
+            (*totalVerificados)++;
+        }
+    }
+
+    fclose(arq);
+    free(lote);
+    return 1;
+}
+
+/**
+ * Primeiro passo da sincronização "headers-first" entre nós locais:
+ * retorna o número do último bloco em comum entre dois arquivos de
+ * cabeçalhos (0 se nem o gênesis coincide).
+ */
+unsigned int encontrarAncestralComum(const char *arquivoA, const char *arquivoB)
+{
+    FILE *a = fopen(arquivoA, "rb");
+    FILE *b = fopen(arquivoB, "rb");
+    unsigned int comum = 0;
+
+    if (!a || !b)
+    {
+        if (a) fclose(a);
+        if (b) fclose(b);
+        return 0;
+    }
+
+    CabecalhoBloco ca, cb;
+    while (fread(&ca, sizeof(CabecalhoBloco), 1, a) == 1 &&
+           fread(&cb, sizeof(CabecalhoBloco), 1, b) == 1)
+    {
+        if (memcmp(ca.hash, cb.hash, SHA256_LEN) != 0)
+            break;
+        comum = ca.numero;
+    }
+
+    fclose(a);
+    fclose(b);
+    return comum;
+}
@@ -0,0 +1,10 @@
+#ifndef HEADERS_H
+#define HEADERS_H
+
+#include "structs.h"
+
+void montarCabecalho(BlocoMinerado *b, int v2, CabecalhoBloco *cab);
+int verificarCabecalhos(const char *nomeArquivo, int v2, unsigned int limite, unsigned int *totalVerificados);
+unsigned int encontrarAncestralComum(const char *arquivoA, const char *arquivoB);
+
+#endif
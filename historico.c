@@ -0,0 +1,207 @@
+/*
+ * Índice de histórico por endereço (lista invertida comprimida)
+ *
+ * Cada endereço tem uma sequência de bytes com suas transferências em ordem
+ * de bloco. Cada entrada ocupa:
+ *    - varint com o delta do ID do bloco em relação à entrada anterior
+ *    - 1 byte com (slot << 1) | direcao
+ * Blocos próximos geram deltas pequenos, então a maioria das entradas
+ * cabe em 2 bytes (contra 9 bytes de uma struct sem compressão).
+ *
+ * A cada HISTORICO_SALTO entradas guarda-se um ponto de salto (offset em
+ * bytes + último bloco antes dele), permitindo paginar sem decodificar a
+ * lista inteira: custo O(HISTORICO_SALTO + tamanho da página).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "historico.h"
+
+#define NUM_ENDERECOS 256
+#define HISTORICO_SALTO 64          // Entradas entre pontos de salto
+#define HISTORICO_CAP_INICIAL 64    // Bytes iniciais de cada lista
+#define MAX_VARINT 5                // unsigned int em varint ocupa até 5 bytes
+
+typedef struct {
+    size_t offset;                  // Posição em bytes da entrada
+    unsigned int blocoBase;         // ID do bloco da entrada anterior (base do delta)
+} SaltoHistorico;
+
+typedef struct {
+    unsigned char *bytes;
+    size_t tamanho;
+    size_t capacidade;
+    unsigned int totalEntradas;
+    unsigned int ultimoBloco;
+    SaltoHistorico *saltos;
+    unsigned int qtdSaltos;
+    unsigned int capSaltos;
+} ListaHistorico;
+
+static ListaHistorico listas[NUM_ENDERECOS];
+
+static void *realocar(void *ptr, size_t tamanho, const char *contexto)
+{
+    void *novo = realloc(ptr, tamanho);
+    if (!novo)
+    {
+        fprintf(stderr, "Erro realloc: %s\n", contexto);
+        exit(1);
+    }
+    return novo;
+}
+
+static size_t escreverVarint(unsigned char *destino, unsigned int valor)
+{
+    size_t n = 0;
+    while (valor >= 0x80)
+    {
+        destino[n++] = (unsigned char)(valor | 0x80);
+        valor >>= 7;
+    }
+    destino[n++] = (unsigned char)valor;
+    return n;
+}
+
+static size_t lerVarint(const unsigned char *origem, unsigned int *valor)
+{
+    unsigned int resultado = 0;
+    int deslocamento = 0;
+    size_t n = 0;
+
+    while (origem[n] & 0x80)
+    {
+        resultado |= (unsigned int)(origem[n] & 0x7f) << deslocamento;
+        deslocamento += 7;
+        n++;
+    }
+    resultado |= (unsigned int)origem[n] << deslocamento;
+    *valor = resultado;
+    return n + 1;
+}
+
+void historicoRegistrar(unsigned char endereco, unsigned int idBloco, unsigned char slot, unsigned char direcao)
+{
+    ListaHistorico *l = &listas[endereco];
+
+    if (l->tamanho + MAX_VARINT + 1 > l->capacidade)
+    {
+        l->capacidade = l->capacidade == 0 ? HISTORICO_CAP_INICIAL : l->capacidade * 2;
+        l->bytes = realocar(l->bytes, l->capacidade, "historicoRegistrar");
+    }
+
+    if (l->totalEntradas % HISTORICO_SALTO == 0)
+    {
+        if (l->qtdSaltos == l->capSaltos)
+        {
+            l->capSaltos = l->capSaltos == 0 ? 4 : l->capSaltos * 2;
+            l->saltos = realocar(l->saltos, l->capSaltos * sizeof(SaltoHistorico), "historicoRegistrar");
+        }
+        l->saltos[l->qtdSaltos].offset = l->tamanho;
+        l->saltos[l->qtdSaltos].blocoBase = l->ultimoBloco;
+        l->qtdSaltos++;
+    }
+
+    l->tamanho += escreverVarint(&l->bytes[l->tamanho], idBloco - l->ultimoBloco);
+    l->bytes[l->tamanho++] = (unsigned char)((slot << 1) | (direcao & 1));
+    l->ultimoBloco = idBloco;
+    l->totalEntradas++;
+}
+
+/**
+ * Copia para 'saida' até 'limite' entradas a partir da posição 'inicio'
+ * (0 = transferência mais antiga). Retorna quantas foram copiadas.
+ */
+unsigned int historicoConsultar(unsigned char endereco, unsigned int inicio, unsigned int limite, EntradaHistorico *saida)
+{
+    ListaHistorico *l = &listas[endereco];
+    if (inicio >= l->totalEntradas || limite == 0)
+        return 0;
+
+    // Pula direto para o ponto de salto mais próximo
+    SaltoHistorico *salto = &l->saltos[inicio / HISTORICO_SALTO];
+    size_t pos = salto->offset;
+    unsigned int bloco = salto->blocoBase;
+    unsigned int indice = (inicio / HISTORICO_SALTO) * HISTORICO_SALTO;
+    unsigned int copiadas = 0;
+
+    while (indice < l->totalEntradas && copiadas < limite)
+    {
+        unsigned int delta;
+        pos += lerVarint(&l->bytes[pos], &delta);
+        unsigned char info = l->bytes[pos++];
+        bloco += delta;
+
+        if (indice >= inicio)
+        {
+            saida[copiadas].idBloco = bloco;
+            saida[copiadas].slot = info >> 1;
+            saida[copiadas].direcao = info & 1;
+            copiadas++;
+        }
+        indice++;
+    }
+    return copiadas;
+}
+
+/**
+ * Remove as entradas do bloco 'idBloco' se ele for o último da lista
+ * (desconexão do topo). Decodifica a partir do ponto de salto anterior ao
+ * bloco; um bloco tem no máximo 122 entradas, então são poucos saltos.
+ */
+void historicoRemoverBloco(unsigned char endereco, unsigned int idBloco)
+{
+    ListaHistorico *l = &listas[endereco];
+    if (l->totalEntradas == 0 || l->ultimoBloco != idBloco)
+        return;
+
+    // Último ponto de salto cuja entrada anterior é de um bloco mais antigo
+    unsigned int s = l->qtdSaltos - 1;
+    while (s > 0 && l->saltos[s].blocoBase >= idBloco)
+        s--;
+
+    size_t pos = l->saltos[s].offset;
+    unsigned int bloco = l->saltos[s].blocoBase;
+    unsigned int indice = s * HISTORICO_SALTO;
+
+    while (indice < l->totalEntradas)
+    {
+        unsigned int delta;
+        size_t tamanhoVarint = lerVarint(&l->bytes[pos], &delta);
+        if (bloco + delta == idBloco)
+            break;
+        pos += tamanhoVarint + 1;
+        bloco += delta;
+        indice++;
+    }
+
+    l->tamanho = pos;
+    l->totalEntradas = indice;
+    l->ultimoBloco = bloco;
+    l->qtdSaltos = (indice + HISTORICO_SALTO - 1) / HISTORICO_SALTO;
+}
+
+unsigned int historicoTotal(unsigned char endereco)
+{
+    return listas[endereco].totalEntradas;
+}
+
+// Bytes efetivamente usados pelas listas e pontos de salto
+size_t historicoMemoria()
+{
+    size_t total = 0;
+    for (int i = 0; i < NUM_ENDERECOS; i++)
+        total += listas[i].tamanho + listas[i].qtdSaltos * sizeof(SaltoHistorico);
+    return total;
+}
+
+void historicoLimpar()
+{
+    for (int i = 0; i < NUM_ENDERECOS; i++)
+    {
+        free(listas[i].bytes);
+        free(listas[i].saltos);
+    }
+    memset(listas, 0, sizeof(listas));
+}
@@ -0,0 +1,22 @@
+#ifndef HISTORICO_H
+#define HISTORICO_H
+
+#include <stddef.h>
+
+#define DIRECAO_SAIDA 0     // Endereço foi a origem da transferência
+#define DIRECAO_ENTRADA 1   // Endereço foi o destino da transferência
+
+typedef struct {
+    unsigned int idBloco;   // Bloco onde a transação está
+    unsigned char slot;     // Posição da transação no bloco (0 a 60)
+    unsigned char direcao;  // DIRECAO_SAIDA ou DIRECAO_ENTRADA
+} EntradaHistorico;
+
+void historicoRegistrar(unsigned char endereco, unsigned int idBloco, unsigned char slot, unsigned char direcao);
+unsigned int historicoConsultar(unsigned char endereco, unsigned int inicio, unsigned int limite, EntradaHistorico *saida);
+void historicoRemoverBloco(unsigned char endereco, unsigned int idBloco);
+unsigned int historicoTotal(unsigned char endereco);
+size_t historicoMemoria();
+void historicoLimpar();
+
+#endif
@@ -0,0 +1,189 @@
+/*
+ * Ledger versionado
+ *
+ * Escritor único (o storage, dentro da sua seção de escrita). A versão
+ * atual carrega uma referência própria; ao ser substituída, essa referência
+ * é solta e a versão vai para a lista de aposentadas do escritor. Quando o
+ * último leitor a libera, o escritor devolve as páginas que só ela usava e
+ * entrega a versão ao RCU: um leitor que carregou o ponteiro antigo ainda
+ * pode ler o contador (e vê zero, então tenta de novo com a atual).
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "ledger.h"
+#include "storage.h"
+#include "sincronizacao.h"
+
+static VersaoLedger *versaoAtual = NULL;            // Acessada só com __atomic_*
+static VersaoLedger *aposentadas = NULL;            // Exclusiva do escritor
+static unsigned int qtdAposentadas = 0;
+
+static void marcarNaoZero(VersaoLedger *v, unsigned char endereco, unsigned int saldo)
+{
+    uint64_t bit = 1ULL << (endereco & 63);
+    int estava = (v->naoZero[endereco >> 6] & bit) != 0;
+
+    if (saldo > 0 && !estava)
+    {
+        v->naoZero[endereco >> 6] |= bit;
+        v->qtdNaoZero++;
+    }
+    else if (saldo == 0 && estava)
+    {
+        v->naoZero[endereco >> 6] &= ~bit;
+        v->qtdNaoZero--;
+    }
+}
+
+// Devolve as páginas e entrega a versão ao RCU (nenhum leitor a segura mais)
+static void liberarVersao(VersaoLedger *v)
+{
+    for (int p = 0; p < LEDGER_PAGINAS; p++)
+    {
+        if (--v->paginas[p]->referencias == 0)
+            free(v->paginas[p]);
+    }
+    rcuAposentar(v);
+}
+
+static void coletarAposentadas()
+{
+    VersaoLedger **anterior = &aposentadas;
+    while (*anterior != NULL)
+    {
+        VersaoLedger *v = *anterior;
+        if (__atomic_load_n(&v->referencias, __ATOMIC_ACQUIRE) == 0)
+        {
+            *anterior = v->proxAposentada;
+            qtdAposentadas--;
+            liberarVersao(v);
+        }
+        else
+            anterior = &v->proxAposentada;
+    }
+}
+
+// Troca a versão atual e aposenta a anterior
+static void publicarVersao(VersaoLedger *nova)
+{
+    VersaoLedger *antiga = versaoAtual;
+    __atomic_store_n(&versaoAtual, nova, __ATOMIC_RELEASE);
+    if (antiga != NULL)
+    {
+        __atomic_fetch_sub(&antiga->referencias, 1, __ATOMIC_ACQ_REL);
+        antiga->proxAposentada = aposentadas;
+        aposentadas = antiga;
+        qtdAposentadas++;
+    }
+    coletarAposentadas();
+}
+
+// Versão nova com páginas próprias (inicialização, recarga e reconstrução)
+void ledgerReiniciar(const unsigned int saldos[LEDGER_ENDERECOS], unsigned int altura)
+{
+    VersaoLedger *nova = verifica_malloc(sizeof(VersaoLedger), "ledgerReiniciar");
+    memset(nova->naoZero, 0, sizeof(nova->naoZero));
+    nova->qtdNaoZero = 0;
+    nova->altura = altura;
+    nova->referencias = 1;
+    nova->proxAposentada = NULL;
+
+    for (int p = 0; p < LEDGER_PAGINAS; p++)
+    {
+        nova->paginas[p] = verifica_malloc(sizeof(PaginaLedger), "ledgerReiniciar");
+        nova->paginas[p]->referencias = 1;
+        memcpy(nova->paginas[p]->saldos, &saldos[p * LEDGER_POR_PAGINA], sizeof(nova->paginas[p]->saldos));
+    }
+    for (int e = 0; e < LEDGER_ENDERECOS; e++)
+        marcarNaoZero(nova, (unsigned char)e, saldos[e]);
+    publicarVersao(nova);
+}
+
+/**
+ * Publica os saldos de 'alterados' (repetições permitidas) sobre a versão
+ * atual. Só as páginas desses endereços são copiadas; as demais passam a
+ * ser compartilhadas pelas duas versões.
+ */
+void ledgerPublicar(const unsigned char *alterados, int qtdAlterados, const unsigned int saldos[LEDGER_ENDERECOS], unsigned int altura)
+{
+    VersaoLedger *base = versaoAtual;
+    if (base == NULL)
+    {
+        ledgerReiniciar(saldos, altura);
+        return;
+    }
+
+    VersaoLedger *nova = verifica_malloc(sizeof(VersaoLedger), "ledgerPublicar");
+    memcpy(nova->paginas, base->paginas, sizeof(nova->paginas));
+    memcpy(nova->naoZero, base->naoZero, sizeof(nova->naoZero));
+    nova->qtdNaoZero = base->qtdNaoZero;
+    nova->altura = altura;
+    nova->referencias = 1;
+    nova->proxAposentada = NULL;
+    for (int p = 0; p < LEDGER_PAGINAS; p++)
+        nova->paginas[p]->referencias++;
+
+    unsigned int copiadas = 0;      // Bit p = página p já é só desta versão
+    for (int i = 0; i < qtdAlterados; i++)
+    {
+        unsigned char e = alterados[i];
+        int p = e / LEDGER_POR_PAGINA;
+        if (!(copiadas & (1u << p)))
+        {
+            PaginaLedger *copia = verifica_malloc(sizeof(PaginaLedger), "ledgerPublicar");
+            memcpy(copia->saldos, nova->paginas[p]->saldos, sizeof(copia->saldos));
+            copia->referencias = 1;
+            nova->paginas[p]->referencias--;
+            nova->paginas[p] = copia;
+            copiadas |= 1u << p;
+        }
+        nova->paginas[p]->saldos[e % LEDGER_POR_PAGINA] = saldos[e];
+        marcarNaoZero(nova, e, saldos[e]);
+    }
+    publicarVersao(nova);
+}
+
+// Versão atual com uma referência a mais (nunca uma que já chegou a zero)
+VersaoLedger *ledgerAdquirir()
+{
+    VersaoLedger *v;
+    unsigned int refs;
+
+    rcuLeituraInicio();
+    do
+    {
+        v = __atomic_load_n(&versaoAtual, __ATOMIC_ACQUIRE);
+        if (v == NULL)
+            break;
+        refs = __atomic_load_n(&v->referencias, __ATOMIC_RELAXED);
+        while (refs != 0 && !__atomic_compare_exchange_n(&v->referencias, &refs, refs + 1, 1, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+            ;
+    } while (refs == 0);
+    rcuLeituraFim();
+    return v;
+}
+
+void ledgerLiberar(VersaoLedger *versao)
+{
+    if (versao != NULL)
+        __atomic_fetch_sub(&versao->referencias, 1, __ATOMIC_RELEASE);
+}
+
+// Endereços com saldo > 0 em ordem crescente, direto do bitmap
+unsigned int ledgerEnderecosNaoZero(const VersaoLedger *versao, unsigned char saida[LEDGER_ENDERECOS])
+{
+    unsigned int qtd = 0;
+    for (int palavra = 0; palavra < LEDGER_ENDERECOS / 64; palavra++)
+    {
+        for (uint64_t bits = versao->naoZero[palavra]; bits != 0; bits &= bits - 1)
+            saida[qtd++] = (unsigned char)(palavra * 64 + __builtin_ctzll(bits));
+    }
+    return qtd;
+}
+
+// Versões substituídas que algum leitor ainda segura
+unsigned int ledgerVersoesRetidas()
+{
+    return qtdAposentadas;
+}
@@ -0,0 +1,46 @@
+#ifndef LEDGER_H
+#define LEDGER_H
+
+#include <stdint.h>
+
+/**
+ * Versões imutáveis dos saldos (copy-on-write por página)
+ *
+ * Os 256 saldos ficam em 16 páginas de 16. Uma versão nova compartilha com
+ * a anterior as páginas que o bloco não tocou e só copia as que mudaram; o
+ * conjunto de endereços com saldo > 0 é um bitmap da versão, ajustado só
+ * nos endereços alterados. Quem lê adquire a versão atual em O(1), lê os
+ * saldos que precisar sem trava e sem repetir, e a libera no fim. O storage
+ * (único escritor) publica uma versão por bloco em O(endereços alterados).
+ */
+#define LEDGER_ENDERECOS 256
+#define LEDGER_POR_PAGINA 16
+#define LEDGER_PAGINAS (LEDGER_ENDERECOS / LEDGER_POR_PAGINA)
+
+typedef struct {
+    unsigned int saldos[LEDGER_POR_PAGINA];
+    unsigned int referencias;                   // Versões que usam a página (só o escritor altera)
+} PaginaLedger;
+
+typedef struct VersaoLedger {
+    PaginaLedger *paginas[LEDGER_PAGINAS];
+    uint64_t naoZero[LEDGER_ENDERECOS / 64];    // Endereços com saldo > 0
+    unsigned int qtdNaoZero;
+    unsigned int altura;                        // Blocos aplicados nesta versão
+    unsigned int referencias;                   // Leitores, +1 enquanto é a atual (__atomic_*)
+    struct VersaoLedger *proxAposentada;        // Lista do escritor
+} VersaoLedger;
+
+void ledgerReiniciar(const unsigned int saldos[LEDGER_ENDERECOS], unsigned int altura);
+void ledgerPublicar(const unsigned char *alterados, int qtdAlterados, const unsigned int saldos[LEDGER_ENDERECOS], unsigned int altura);
+VersaoLedger *ledgerAdquirir();
+void ledgerLiberar(VersaoLedger *versao);
+unsigned int ledgerEnderecosNaoZero(const VersaoLedger *versao, unsigned char saida[LEDGER_ENDERECOS]);
+unsigned int ledgerVersoesRetidas();
+
+static inline unsigned int ledgerSaldo(const VersaoLedger *versao, unsigned char endereco)
+{
+    return versao->paginas[endereco / LEDGER_POR_PAGINA]->saldos[endereco % LEDGER_POR_PAGINA];
+}
+
+#endif
@@ -4,43 +4,97 @@
 #include <string.h>
 #include <time.h>
 #include <signal.h>
+#include <pthread.h>
+#include <unistd.h>
 #include "mtwister.h"
 #include "structs.h"
 #include "miner.h"
 #include "transactions.h"
 #include "storage.h"
+#include "fork.h"
+#include "assinaturas.h"
+#include "contadores.h"
+#include "rastreamento.h"
 
-// Signal handler para Ctrl+C
-static void handleSigint(int sig) {
-    (void)sig;  // Suprimir warning
+// Mineração em segundo plano (o menu responde enquanto os blocos são minerados)
+static pthread_t threadMineracao;
+static int threadIniciada = 0;
+static int mineracaoAtiva = 0;      // Lido pelo menu com __atomic_load_n
+static int exportacaoAtiva = 0;     // .txt sendo gerado em segundo plano depois da mineração
+static int pararMineracao = 0;      // Pedido de parada (Ctrl+C)
+
+// Ctrl+C: tratado por uma thread com sigwait, fora de contexto de sinal (trava e I/O permitidos)
+static sigset_t sinaisEncerramento;
+
+/**
+ * Encerramento rápido, com custo que não depende do tamanho da cadeia: não
+ * espera a mineração nem a exportação, só persiste o que falta e sai sem
+ * liberar os índices nó por nó.
+ */
+static void *aguardarInterrupcao(void *arg) {
+    (void)arg;
+    int sinal;
+    if (sigwait(&sinaisEncerramento, &sinal) != 0)
+        return NULL;
+
+    struct timespec inicio, fim;
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
     printf("\n\nInterrupção detectada. Salvando dados...\n");
-    finalizarStorage();
-    exit(0);
+    __atomic_store_n(&pararMineracao, 1, __ATOMIC_RELAXED);
+    finalizarStorageRapido();
+    rastroFinalizar();
+    clock_gettime(CLOCK_MONOTONIC, &fim);
+    printf("Dados salvos em %.1f ms.\n", (fim.tv_sec - inicio.tv_sec) * 1000.0 + (fim.tv_nsec - inicio.tv_nsec) / 1e6);
+    fflush(stdout);
+    _exit(0);
 }
 
 // CONSTANTES
 
-#define TOTAL_BLOCOS_SIMULACAO 30000   // 30.000 blocos
+#define TOTAL_BLOCOS_SIMULACAO 30000   // 30.000 blocos (padrão; --blocos N muda)
+#define MAX_BLOCOS_SIMULACAO 4000000000U  // IDs de 32 bits no formato do bloco
+#define MAX_CONTAS_SIMULACAO (1U << 28)     // Limite do estado de contas paginado (contas.h)
 #define ARQUIVO_BLOCKCHAIN "blockchain.bin"
+#define ARQUIVO_CONTADORES "contadores.json"
+#define VARIAVEL_RASTRO "BLOCKCHAIN_RASTRO"      // Caminho do trace JSON (desligado se ausente)
+#define SEMENTE_SIMULACAO 1234567
 
 MTRand r;  // Gerador Mersenne Twister
+static unsigned int totalBlocosSimulacao = TOTAL_BLOCOS_SIMULACAO;
+static int cadeiaGrande = 0;    // --grande: sem índice de histórico
+static int sorteioContador = 0; // --philox: sorteios de cada bloco por (semente, bloco, índice)
+static unsigned int qtdContas = 0;  // --contas N: formato v2 com N contas (0 = formato v1)
+static int threadsValidacao = 0;    // --validacao-paralela T: execução otimista das transações
+static int threadsAssinaturas = 0;  // --assinaturas T: transações assinadas, verificadas em lote com T threads
+static double taxaFalsoPositivo = 0.0;  // --fp-nonce P: alvo de falso positivo do filtro de Bloom (0 = padrão)
 
 // FUNÇÕES AUXILIARES
 
 void inicializarEstado() {
     // Semente fixa
-    r = seedRand(1234567); 
+    r = seedRand(SEMENTE_SIMULACAO); 
+}
+
+// Dados do bloco i pelo gerador escolhido (o Philox não depende dos sorteios dos blocos anteriores)
+static int gerarDadosSimulacao(unsigned int i, unsigned char dados[]) {
+    if (contasDaCadeia())
+        return sorteioContador ? gerarDadosDoBlocoContasContador(i, dados, SEMENTE_SIMULACAO)
+                               : gerarDadosDoBlocoContas(i, dados, &r);
+    if (sorteioContador)
+        return gerarDadosDoBlocoContador(i, dados, NULL, SEMENTE_SIMULACAO);
+    return gerarDadosDoBloco(i, dados, NULL, &r);
 }
 
 void rodarSimulacao() {
-    printf("Iniciando mineração de %d blocos...\n", TOTAL_BLOCOS_SIMULACAO);
+    printf("Iniciando mineração de %u blocos...\n", totalBlocosSimulacao);
     
     BlocoMinerado anterior;
     unsigned char dadosBuffer[184];
+    unsigned long long tSimulacao = rastroInicio();
     
     // --- BLOCO 1 (GÊNESIS) ---
     // Para o Gênesis, passamos NULL como carteira 
-    gerarDadosDoBloco(1, dadosBuffer, NULL, &r); 
+    gerarDadosSimulacao(1, dadosBuffer); 
     BlocoMinerado genesis = criarBlocoGenesis(dadosBuffer); 
     
     // Storage atualiza saldos automaticamente ao adicionar bloco
@@ -50,22 +104,74 @@ void rodarSimulacao() {
     printf("Bloco 1 (Gênesis) minerado.\n");
 
     // --- BLOCOS 2 até N ---
-    for (unsigned int i = 2; i <= TOTAL_BLOCOS_SIMULACAO; i++) {
-        gerarDadosDoBloco(i, dadosBuffer, NULL, &r);
+    // Progresso a cada 1% (no mínimo a cada 1000 blocos)
+    unsigned int intervaloProgresso = totalBlocosSimulacao / 100 > 1000 ? totalBlocosSimulacao / 100 : 1000;
+
+    for (unsigned int i = 2; i <= totalBlocosSimulacao; i++) {
+        unsigned long long t0 = rastroInicio();
+        gerarDadosSimulacao(i, dadosBuffer);
+        rastroFim("gerarDadosDoBloco", "mineracao", t0);
         
-        BlocoMinerado novo = criarProxBloco(anterior, i, dadosBuffer);
+        // Carteiras assinam antes da mineração; o bloco entra pela submissão, que confere o lote
+        unsigned char assinaturas[V1_MAX_TRANSACOES][ASSINATURA_LEN];
+        if (threadsAssinaturas) {
+            t0 = rastroInicio();
+            assinarBloco(dadosBuffer, contasDaCadeia() != 0, i, assinaturas);
+            rastroFim("assinarBloco", "mineracao", t0);
+        }
+
+        t0 = rastroInicio();
+        BlocoMinerado novo = criarProxBloco(anterior, i, dadosBuffer, contasDaCadeia() != 0);
+        rastroFim("minerarBloco", "mineracao", t0);
         
         // Storage atualiza saldos e estatísticas automaticamente
-        adicionarBloco(&novo);
+        if (threadsAssinaturas) {
+            t0 = rastroInicio();
+            int resultado = submeterBlocoAssinado(&novo, assinaturas);
+            rastroFim("verificarAssinaturas", "mineracao", t0);
+            if (resultado != SUBMISSAO_CONECTADO) {
+                fprintf(stderr, "ERRO: bloco %u recusado na submissão (código %d)\n", i, resultado);
+                return;
+            }
+        } else {
+            adicionarBloco(&novo);
+        }
         
         anterior = novo;
 
-        if (i % 1000 == 0) {
-            printf("Bloco %u minerado... (%.1f%%)\n", i, (float)i/TOTAL_BLOCOS_SIMULACAO*100);
+        if (__atomic_load_n(&pararMineracao, __ATOMIC_RELAXED)) {
+            rastroFim("rodarSimulacao", "mineracao", tSimulacao);
+            return;
+        }
+
+        if (i % intervaloProgresso == 0 && !threadIniciada) {
+            printf("Bloco %u minerado... (%.1f%%)\n", i, (float)i/totalBlocosSimulacao*100);
         }
     }
     
+    rastroFim("rodarSimulacao", "mineracao", tSimulacao);
     printf("Simulação concluída!\n");
+    if (threadsAssinaturas) {
+        EstatisticasAssinaturas est;
+        assinaturasEstatisticas(&est);
+        double porSegundo = est.msVerificacao > 0 ? est.verificadas / (est.msVerificacao / 1000.0) : 0;
+        printf("Assinaturas: %llu verificadas, %llu pelo cache, %llu rejeitadas | %.0f/s com %d threads (%.0f/s por núcleo)\n",
+               est.verificadas, est.emCache, est.rejeitadas, porSegundo, assinaturasThreads(),
+               porSegundo / assinaturasNucleos());
+    }
+}
+
+static void *executarMineracao(void *arg) {
+    (void)arg;
+    rastroNomearThread("mineracao");
+    rodarSimulacao();
+
+    // Exportação adiantada: a saída normal não precisa mais gerar o .txt
+    __atomic_store_n(&exportacaoAtiva, 1, __ATOMIC_RELEASE);
+    __atomic_store_n(&mineracaoAtiva, 0, __ATOMIC_RELEASE);
+    exportarTextoDaCadeia();
+    __atomic_store_n(&exportacaoAtiva, 0, __ATOMIC_RELEASE);
+    return NULL;
 }
 
 // MENU INTERATIVO
@@ -74,6 +180,10 @@ void exibirMenu() {
     printf("\n=========================================\n");
     printf("   MENU - BLOCKCHAIN SIMPLIFICADA\n");
     printf("=========================================\n");
+    if (__atomic_load_n(&mineracaoAtiva, __ATOMIC_ACQUIRE))
+        printf("[Mineração em segundo plano: %u/%u blocos]\n", obterTotalBlocos(), totalBlocosSimulacao);
+    else if (__atomic_load_n(&exportacaoAtiva, __ATOMIC_ACQUIRE))
+        printf("[Exportando o arquivo de texto em segundo plano]\n");
     printf("1. [a] Endereço com mais Bitcoins\n");
     printf("2. [b] Endereço que minerou mais blocos\n");
     printf("3. [c] Bloco com MAIS transações\n");
@@ -84,36 +194,371 @@ void exibirMenu() {
     printf("8. [h] Imprimir N blocos (ordenados por transações)\n");
     printf("9. [i] Buscar blocos por Nonce\n");
     printf("10. Gerar Histograma Hash\n");
+    printf("11. Verificar cadeia (cabeçalhos x blocos completos)\n");
+    printf("12. Histórico de transferências de um endereço\n");
+    printf("13. Saldo de um endereço em uma altura passada\n");
+    printf("14. Ranking de riqueza (top-N, posição, mediana, Gini)\n");
+    printf("15. Buscar bloco por hash (completo ou prefixo)\n");
+    printf("16. Contadores de execução (e dump em %s)\n", ARQUIVO_CONTADORES);
     printf("0. Sair\n");
     printf("-----------------------------------------\n");
     printf("Escolha uma opção: ");
 }
 
+// Maior endereço válido no formato da cadeia aberta
+static unsigned int ultimoEndereco() {
+    return contasDaCadeia() ? contasDaCadeia() - 1 : 255;
+}
+
 /* --- Adicionado para calcular tempo em ms --- */
 static double tempo_ms(struct timespec inicio, struct timespec fim) {
 	return (fim.tv_sec - inicio.tv_sec) * 1000.0 + (fim.tv_nsec - inicio.tv_nsec) / 1e6;
 }
 
-int main() {
-    signal(SIGINT, handleSigint);  
+// MODO LOTE (consultas de um arquivo, resultados em JSON lines)
+
+#define TAM_LINHA_LOTE 256
+#define MAX_RICOS 256
+
+// Blocos coletados por uma consulta (a saída só é montada depois da medição)
+typedef struct {
+    unsigned int *ids;
+    unsigned char *tx;
+    unsigned int qtd;
+    unsigned int capacidade;
+} ColetaBlocos;
+
+static void coletarBloco(BlocoMinerado *b, int qtdTx, void *contexto) {
+    ColetaBlocos *c = contexto;
+    if (c->qtd == c->capacidade) {
+        c->capacidade = c->capacidade == 0 ? 64 : c->capacidade * 2;
+        c->ids = realloc(c->ids, c->capacidade * sizeof(unsigned int));
+        c->tx = realloc(c->tx, c->capacidade);
+        if (!c->ids || !c->tx) {
+            fprintf(stderr, "Erro realloc: coletarBloco\n");
+            exit(1);
+        }
+    }
+    c->ids[c->qtd] = b->bloco.numero;
+    c->tx[c->qtd] = (unsigned char)qtdTx;
+    c->qtd++;
+}
+
+static void jsonTexto(FILE *f, const char *texto) {
+    fputc('"', f);
+    for (const char *c = texto; *c; c++) {
+        if (*c == '"' || *c == '\\') fprintf(f, "\\%c", *c);
+        else if ((unsigned char)*c < 0x20) fprintf(f, "\\u%04x", *c);
+        else fputc(*c, f);
+    }
+    fputc('"', f);
+}
+
+static void jsonListaBlocos(FILE *f, ColetaBlocos *c) {
+    fprintf(f, "{\"total\":%u,\"blocos\":[", c->qtd);
+    for (unsigned int i = 0; i < c->qtd; i++)
+        fprintf(f, "%s{\"id\":%u,\"tx\":%u}", i ? "," : "", c->ids[i], c->tx[i]);
+    fprintf(f, "]}");
+}
+
+/**
+ * Executa uma linha de consulta e escreve seu objeto JSON em 'f'.
+ * Só a execução da consulta entra no tempo; a formatação fica de fora.
+ * Retorna 1 se a consulta foi reconhecida e executada.
+ */
+static int executarConsultaLote(const char *linha, unsigned int numeroLinha, FILE *f) {
+    char comando[32];
+    unsigned int a = 0, b = 0;
+    int lidos = sscanf(linha, "%31s %u %u", comando, &a, &b);
+    struct timespec t_start, t_end;
+    const char *erro = NULL;
+
+    // Resultados possíveis (só um é usado por consulta)
+    ColetaBlocos coleta = {0};
+    BlocoMinerado bloco;
+    InstantaneoEstatisticas inst;
+    unsigned int enderecos[MAX_RICOS];
+    unsigned int valores[MAX_RICOS];
+    unsigned int saldosAltura[256];
+    unsigned int ids[MAX_RICOS];
+    unsigned long long totaisContadores[QTD_CONTADORES];
+    ProvaMerkle prova;
+    CabecalhoBloco cabecalho;
+    unsigned char folha[MERKLE_MAX_FOLHA];
+    unsigned int qtd = 0;
+    int valor = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &t_start);
+    if (strcmp(comando, "bloco") == 0 && lidos >= 2) {
+        if (!buscarBlocoPorId(a, &bloco)) erro = "bloco inexistente";
+    } else if (strcmp(comando, "nonce") == 0 && lidos >= 2) {
+        percorrerBlocosPorNonce(a, coletarBloco, &coleta);
+    } else if (strcmp(comando, "minerador") == 0 && lidos >= 3) {
+        percorrerBlocosMinerador(a, (int)b, coletarBloco, &coleta);
+    } else if (strcmp(comando, "transacoes") == 0 && lidos >= 2) {
+        percorrerBlocosPorTransacoes(a, coletarBloco, &coleta);
+    } else if (strcmp(comando, "ricos") == 0 && lidos >= 2) {
+        qtd = maioresSaldos(a > MAX_RICOS ? MAX_RICOS : a, enderecos, valores);
+    } else if ((strcmp(comando, "maxtx") == 0 || strcmp(comando, "mintx") == 0) && lidos >= 1) {
+        qtd = blocosRecorde(comando[1] == 'a', &valor, ids, MAX_RICOS);
+    } else if (strcmp(comando, "maiorminerador") == 0 && lidos >= 1) {
+        qtd = maioresMineradores(ids, MAX_RICOS, &b);
+    } else if (strcmp(comando, "media") == 0 && lidos >= 1) {
+        obterInstantaneo(&inst);
+    } else if (strcmp(comando, "contadores") == 0 && lidos >= 1) {
+        contadoresAgregar(totaisContadores);
+    } else if (strcmp(comando, "conta") == 0 && lidos >= 2) {
+        valor = (int)getSaldoConta(a);
+    } else if (strcmp(comando, "prova") == 0 && lidos >= 3) {
+        // Prova da folha b do bloco a, conferida contra a raiz do cabeçalho
+        valor = gerarProvaInclusao(a, (int)b, &prova, folha);
+        if (!valor || !buscarCabecalhoPorId(a, &cabecalho)) erro = "bloco ou folha inexistente";
+        else qtd = verificarProvaMerkle(folha, (size_t)valor, &prova, contasDaCadeia() != 0, cabecalho.raizDados);
+    } else if (strcmp(comando, "saldo") == 0 && lidos >= 2 && contasDaCadeia()) {
+        // v2: só o saldo no topo (os checkpoints cobrem os 256 endereços do v1)
+        if (a >= contasDaCadeia()) erro = "conta fora do espaço de contas";
+        else if (lidos >= 3 && b != obterTotalBlocos()) erro = "saldo histórico indisponível no formato v2";
+        else {
+            b = obterTotalBlocos();
+            valor = (int)getSaldoConta(a);
+        }
+    } else if (strcmp(comando, "saldo") == 0 && lidos >= 2 && a < 256) {
+        if (lidos < 3) b = obterTotalBlocos();
+        if (!saldosNaAltura(b, saldosAltura)) erro = "altura inexistente";
+        else valor = (int)saldosAltura[a];
+    } else {
+        erro = "consulta desconhecida ou argumentos faltando";
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t_end);
+
+    fprintf(f, "{\"linha\":%u,\"consulta\":", numeroLinha);
+    jsonTexto(f, linha);
+    fprintf(f, ",\"ok\":%s,\"ms\":%.4f,", erro ? "false" : "true", tempo_ms(t_start, t_end));
+
+    if (erro) {
+        fprintf(f, "\"erro\":");
+        jsonTexto(f, erro);
+    } else {
+        fprintf(f, "\"resultado\":");
+        if (strcmp(comando, "bloco") == 0) {
+            fprintf(f, "{\"numero\":%u,\"nonce\":%u,\"minerador\":%u,\"tx\":%d,\"hash\":\"", bloco.bloco.numero,
+                    bloco.bloco.nonce, mineradorDoBloco(&bloco), contagemTransacoes(bloco.bloco.numero));
+            for (int i = 0; i < SHA256_LEN; i++) fprintf(f, "%02x", bloco.hash[i]);
+            fprintf(f, "\"}");
+        } else if (strcmp(comando, "ricos") == 0) {
+            fprintf(f, "[");
+            for (unsigned int i = 0; i < qtd; i++)
+                fprintf(f, "%s{\"endereco\":%u,\"saldo\":%u}", i ? "," : "", enderecos[i], valores[i]);
+            fprintf(f, "]");
+        } else if (strcmp(comando, "maxtx") == 0 || strcmp(comando, "mintx") == 0) {
+            fprintf(f, "{\"transacoes\":%d,\"total\":%u,\"blocos\":[", valor, qtd);
+            for (unsigned int i = 0; i < qtd && i < MAX_RICOS; i++)
+                fprintf(f, "%s%u", i ? "," : "", ids[i]);
+            fprintf(f, "]}");
+        } else if (strcmp(comando, "maiorminerador") == 0) {
+            fprintf(f, "{\"blocos\":%u,\"total\":%u,\"enderecos\":[", b, qtd);
+            for (unsigned int i = 0; i < qtd && i < MAX_RICOS; i++)
+                fprintf(f, "%s%u", i ? "," : "", ids[i]);
+            fprintf(f, "]}");
+        } else if (strcmp(comando, "media") == 0) {
+            fprintf(f, "{\"totalTransacionado\":%llu,\"blocos\":%u,\"media\":%.4f}", inst.totalValorTransacionado,
+                    inst.totalBlocos, inst.totalBlocos ? (double)inst.totalValorTransacionado / inst.totalBlocos : 0.0);
+        } else if (strcmp(comando, "contadores") == 0) {
+            fprintf(f, "{");
+            for (int i = 0; i < QTD_CONTADORES; i++)
+                fprintf(f, "%s\"%s\":%llu", i ? "," : "", contadorNome((Contador)i), totaisContadores[i]);
+            fprintf(f, "}");
+        } else if (strcmp(comando, "conta") == 0) {
+            fprintf(f, "{\"conta\":%u,\"saldo\":%u}", a, (unsigned int)valor);
+        } else if (strcmp(comando, "prova") == 0) {
+            fprintf(f, "{\"bloco\":%u,\"folha\":%u,\"dados\":\"", a, b);
+            for (int i = 0; i < valor; i++) fprintf(f, "%02x", folha[i]);
+            fprintf(f, "\",\"irmaos\":[");
+            for (int k = 0; k < prova.qtdIrmaos; k++) {
+                fprintf(f, "%s\"", k ? "," : "");
+                for (int i = 0; i < SHA256_LEN; i++) fprintf(f, "%02x", prova.irmaos[k][i]);
+                fprintf(f, "\"");
+            }
+            fprintf(f, "],\"raiz\":\"");
+            for (int i = 0; i < SHA256_LEN; i++) fprintf(f, "%02x", cabecalho.raizDados[i]);
+            // No v1 a raiz do .hdr não entra na prova de trabalho: "confere" não autentica a folha
+            fprintf(f, "\",\"confere\":%s,\"raiz_autenticada\":%s}", qtd ? "true" : "false",
+                    contasDaCadeia() ? "true" : "false");
+        } else if (strcmp(comando, "saldo") == 0) {
+            fprintf(f, "{\"endereco\":%u,\"altura\":%u,\"saldo\":%u}", a, b, (unsigned int)valor);
+        } else {
+            jsonListaBlocos(f, &coleta);
+        }
+    }
+    fprintf(f, "}\n");
+
+    free(coleta.ids);
+    free(coleta.tx);
+    return erro == NULL;
+}
+
+/**
+ * Lê consultas (uma por linha; '#' inicia comentário) de 'arquivo' ou da
+ * entrada padrão ("-") e escreve uma linha JSON por consulta em 'saida'.
+ * Retorna quantas consultas falharam.
+ */
+static int executarLote(const char *arquivo, FILE *saida) {
+    FILE *entrada = strcmp(arquivo, "-") == 0 ? stdin : fopen(arquivo, "r");
+    if (!entrada) {
+        fprintf(stderr, "Erro ao abrir arquivo de consultas: %s\n", arquivo);
+        return 1;
+    }
+
+    char linha[TAM_LINHA_LOTE];
+    unsigned int numeroLinha = 0, executadas = 0;
+    int falhas = 0;
+    struct timespec t_start, t_end;
+
+    clock_gettime(CLOCK_MONOTONIC, &t_start);
+    while (fgets(linha, sizeof(linha), entrada)) {
+        numeroLinha++;
+        linha[strcspn(linha, "\r\n#")] = '\0';
+
+        // Linhas vazias e comentários não geram saída
+        char *inicio = linha + strspn(linha, " \t");
+        if (*inicio == '\0') continue;
+
+        if (!executarConsultaLote(inicio, numeroLinha, saida)) falhas++;
+        executadas++;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t_end);
+    fflush(saida);
+
+    fprintf(stderr, "Lote: %u consultas (%d com erro) em %.3f ms\n", executadas, falhas, tempo_ms(t_start, t_end));
+    if (entrada != stdin) fclose(entrada);
+    return falhas;
+}
+
+static int usoInvalido(const char *programa) {
+    fprintf(stderr, "Uso: %s [--blocos N] [--grande] [--philox] [--contas N] [--validacao-paralela T] [--assinaturas T] [--fp-nonce P] [--lote <arquivo de consultas | ->]\n", programa);
+    fprintf(stderr, "  --blocos N   tamanho da cadeia minerada (padrão %d)\n", TOTAL_BLOCOS_SIMULACAO);
+    fprintf(stderr, "  --grande     modo cadeia grande: sem histórico por endereço e sem exportar texto\n");
+    fprintf(stderr, "  --philox     sorteios de cada bloco por gerador de contador (gera outra cadeia)\n");
+    fprintf(stderr, "  --contas N   cadeia nova no formato v2 com N contas de 32 bits (até %u)\n", MAX_CONTAS_SIMULACAO);
+    fprintf(stderr, "  --validacao-paralela T  valida as transações de cada bloco por execução otimista em T threads\n");
+    fprintf(stderr, "  --assinaturas T  transações assinadas (Ed25519), verificadas em lote com T threads antes do ledger\n");
+    fprintf(stderr, "  --fp-nonce P taxa alvo de falso positivo do filtro de Bloom de nonces, entre 0 e 1 (ex: 0.001)\n");
+    return 1;
+}
+
+int main(int argc, char *argv[]) {
+    const char *arquivoLote = NULL;
+    int modoLote = 0;
+    FILE *saidaJson = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--lote") == 0 && i + 1 < argc) {
+            arquivoLote = argv[++i];
+            modoLote = 1;
+        } else if (strcmp(argv[i], "--blocos") == 0 && i + 1 < argc) {
+            char *fim;
+            unsigned long long n = strtoull(argv[++i], &fim, 10);
+            if (*fim != '\0' || n < 1 || n > MAX_BLOCOS_SIMULACAO)
+                return usoInvalido(argv[0]);
+            totalBlocosSimulacao = (unsigned int)n;
+        } else if (strcmp(argv[i], "--grande") == 0) {
+            cadeiaGrande = 1;
+            definirModoCadeiaGrande(1);
+        } else if (strcmp(argv[i], "--philox") == 0) {
+            sorteioContador = 1;
+        } else if (strcmp(argv[i], "--contas") == 0 && i + 1 < argc) {
+            char *fim;
+            unsigned long long n = strtoull(argv[++i], &fim, 10);
+            if (*fim != '\0' || n < 1 || n > MAX_CONTAS_SIMULACAO)
+                return usoInvalido(argv[0]);
+            qtdContas = (unsigned int)n;
+            definirContasV2(qtdContas);
+        } else if (strcmp(argv[i], "--validacao-paralela") == 0 && i + 1 < argc) {
+            char *fim;
+            long t = strtol(argv[++i], &fim, 10);
+            if (*fim != '\0' || t < 1 || t > 64)
+                return usoInvalido(argv[0]);
+            threadsValidacao = (int)t;
+        } else if (strcmp(argv[i], "--assinaturas") == 0 && i + 1 < argc) {
+            char *fim;
+            long t = strtol(argv[++i], &fim, 10);
+            if (*fim != '\0' || t < 1 || t > ASSINATURAS_MAX_THREADS)
+                return usoInvalido(argv[0]);
+            threadsAssinaturas = (int)t;
+        } else if (strcmp(argv[i], "--fp-nonce") == 0 && i + 1 < argc) {
+            char *fim;
+            double p = strtod(argv[++i], &fim);
+            if (*fim != '\0' || p <= 0.0 || p >= 1.0)
+                return usoInvalido(argv[0]);
+            taxaFalsoPositivo = p;
+        } else {
+            return usoInvalido(argv[0]);
+        }
+    }
+    if (modoLote) {
+        // JSON fica com a saída padrão original; mensagens do sistema vão para stderr
+        saidaJson = fdopen(dup(STDOUT_FILENO), "w");
+        dup2(STDERR_FILENO, STDOUT_FILENO);
+    }
+
+    if (getenv(VARIAVEL_RASTRO)) {
+        rastroIniciar(getenv(VARIAVEL_RASTRO));
+        rastroNomearThread("principal");
+    }
+
+    // Bloqueado antes de criar threads: todas herdam a máscara e só a de sinais recebe o Ctrl+C
+    pthread_t threadSinais;
+    sigemptyset(&sinaisEncerramento);
+    sigaddset(&sinaisEncerramento, SIGINT);
+    pthread_sigmask(SIG_BLOCK, &sinaisEncerramento, NULL);
+    pthread_create(&threadSinais, NULL, aguardarInterrupcao, NULL);
+    if (threadsValidacao)
+        definirValidacaoParalela(threadsValidacao);
+    if (threadsAssinaturas)
+        assinaturasIniciar(SEMENTE_SIMULACAO, threadsAssinaturas);
     inicializarEstado();
     inicializarStorage(ARQUIVO_BLOCKCHAIN);
+    if (taxaFalsoPositivo > 0.0)
+        definirTaxaFalsoPositivoNonce(taxaFalsoPositivo);   // Refaz o filtro com os nonces já carregados
     
     unsigned int totalBlocosDisco = obterTotalBlocos();
     
-    if (totalBlocosDisco < TOTAL_BLOCOS_SIMULACAO) {
+    if (totalBlocosDisco < totalBlocosSimulacao) {
         if (totalBlocosDisco > 0) {
-            printf("AVISO: Blockchain incompleta (%u/%d). Reiniciando para consistência.\n", 
-                   totalBlocosDisco, TOTAL_BLOCOS_SIMULACAO);
+            printf("AVISO: Blockchain incompleta (%u/%u). Reiniciando para consistência.\n", 
+                   totalBlocosDisco, totalBlocosSimulacao);
             finalizarStorage();
             remove(ARQUIVO_BLOCKCHAIN);
             inicializarStorage(ARQUIVO_BLOCKCHAIN);
         }
-        rodarSimulacao();
+
+        if (modoLote) {
+            rodarSimulacao();
+        } else {
+            mineracaoAtiva = 1;
+            threadIniciada = pthread_create(&threadMineracao, NULL, executarMineracao, NULL) == 0;
+
+            if (threadIniciada) {
+                printf("Mineração iniciada em segundo plano: o menu já responde com os blocos minerados até agora.\n");
+            } else {
+                mineracaoAtiva = 0;
+                rodarSimulacao();
+            }
+        }
     } 
     else {
         // Storage já reconstruiu tudo ao inicializar
         printf("Blockchain completa carregada: %u blocos.\n", totalBlocosDisco);
+        if (qtdContas && contasDaCadeia() != qtdContas)
+            printf("AVISO: --contas ignorado: a cadeia em disco segue o formato do seu gênesis.\n");
+    }
+
+    if (modoLote) {
+        int falhas = executarLote(arquivoLote, saidaJson);
+        fclose(saidaJson);
+        finalizarStorage();
+        rastroFinalizar();
+        return falhas ? 1 : 0;
     }
 
     // Menu Interativo
@@ -128,7 +573,7 @@ int main() {
 
         unsigned int num, nonce;
         int n;
-        unsigned char end;
+        unsigned int end;
 
         // Variáveis de medição de tempo por opção
         struct timespec t_start, t_end;
@@ -175,8 +620,8 @@ int main() {
                 printf("Tempo de execução: %.3f ms\n", tempo_ms(t_start, t_end));
                 break;
             case 7:
-                printf("Endereço do minerador (0-255): ");
-                scanf("%hhu", &end);
+                printf("Endereço do minerador (0-%u): ", ultimoEndereco());
+                scanf("%u", &end);
                 printf("Quantidade de blocos (N): ");
                 scanf("%d", &n);
                 clock_gettime(CLOCK_MONOTONIC, &t_start);
@@ -206,6 +651,101 @@ int main() {
                  clock_gettime(CLOCK_MONOTONIC, &t_end);
                  printf("Tempo de execução: %.3f ms\n", tempo_ms(t_start, t_end));
                  break;
+            case 11: {
+                unsigned int verificados;
+                double t_cab, t_completa;
+                int ok;
+
+                printf("\n--- Verificação da Cadeia ---\n");
+                clock_gettime(CLOCK_MONOTONIC, &t_start);
+                ok = verificarCadeiaPorCabecalhos(&verificados);
+                clock_gettime(CLOCK_MONOTONIC, &t_end);
+                t_cab = tempo_ms(t_start, t_end);
+                printf("Só cabeçalhos:  %s | %u blocos | %.3f ms\n", ok ? "VÁLIDA" : "INVÁLIDA", verificados, t_cab);
+
+                clock_gettime(CLOCK_MONOTONIC, &t_start);
+                ok = verificarCadeiaCompleta(&verificados);
+                clock_gettime(CLOCK_MONOTONIC, &t_end);
+                t_completa = tempo_ms(t_start, t_end);
+                printf("Blocos inteiros: %s | %u blocos | %.3f ms\n", ok ? "VÁLIDA" : "INVÁLIDA", verificados, t_completa);
+
+                if (t_cab > 0)
+                    printf("Ganho da verificação por cabeçalhos: %.1fx\n", t_completa / t_cab);
+                break;
+            }
+            case 12: {
+                unsigned int inicio, limite;
+                double t_indice, t_varredura;
+
+                printf("Endereço (0-%u): ", ultimoEndereco());
+                scanf("%u", &end);
+                printf("Começar da transferência nº (0 = mais antiga): ");
+                scanf("%u", &inicio);
+                printf("Quantidade por página: ");
+                scanf("%u", &limite);
+
+                clock_gettime(CLOCK_MONOTONIC, &t_start);
+                listarHistoricoEndereco(end, inicio, limite);
+                clock_gettime(CLOCK_MONOTONIC, &t_end);
+                t_indice = tempo_ms(t_start, t_end);
+                printf("Tempo de execução (índice): %.3f ms\n", t_indice);
+
+                // Comparação com a varredura completa dos blocos
+                clock_gettime(CLOCK_MONOTONIC, &t_start);
+                unsigned int achadas = varrerHistoricoEndereco(end, inicio, limite);
+                clock_gettime(CLOCK_MONOTONIC, &t_end);
+                t_varredura = tempo_ms(t_start, t_end);
+                printf("Varredura completa: %u transferências em %.3f ms", achadas, t_varredura);
+                if (t_indice > 0 && !cadeiaGrande)
+                    printf(" (índice %.1fx mais rápido)", t_varredura / t_indice);
+                printf("\nMemória do índice de histórico: %zu KB\n", memoriaHistorico() / 1024);
+                break;
+            }
+            case 13:
+                printf("Altura (número do bloco): ");
+                scanf("%u", &num);
+                printf("Endereço (0-%u): ", ultimoEndereco());
+                scanf("%u", &end);
+                clock_gettime(CLOCK_MONOTONIC, &t_start);
+                relatorioSaldoHistorico(end, num);
+                clock_gettime(CLOCK_MONOTONIC, &t_end);
+                printf("Tempo de execução: %.3f ms\n", tempo_ms(t_start, t_end));
+                break;
+            case 14:
+                printf("Quantidade no topo (N): ");
+                scanf("%u", &num);
+                printf("Endereço para consultar a posição (0-%u): ", ultimoEndereco());
+                scanf("%u", &end);
+                clock_gettime(CLOCK_MONOTONIC, &t_start);
+                relatorioRiqueza(num, end);
+                clock_gettime(CLOCK_MONOTONIC, &t_end);
+                printf("Tempo de execução: %.3f ms\n", tempo_ms(t_start, t_end));
+                break;
+            case 15: {
+                char hex[2 * SHA256_LEN + 1];
+
+                printf("Hash ou prefixo (hex): ");
+                scanf("%64s", hex);
+                clock_gettime(CLOCK_MONOTONIC, &t_start);
+                buscarBlocoPorHash(hex);
+                clock_gettime(CLOCK_MONOTONIC, &t_end);
+                printf("Tempo de execução: %.3f ms\n", tempo_ms(t_start, t_end));
+                break;
+            }
+            case 16: {
+                contadoresImprimir();
+
+                FILE *dump = fopen(ARQUIVO_CONTADORES, "w");
+                if (dump) {
+                    contadoresExportarJson(dump);
+                    fputc('\n', dump);
+                    fclose(dump);
+                    printf("Contadores gravados em %s\n", ARQUIVO_CONTADORES);
+                } else {
+                    printf("Erro ao criar %s\n", ARQUIVO_CONTADORES);
+                }
+                break;
+            }
             case 0:
                 clock_gettime(CLOCK_MONOTONIC, &t_start);
                 printf("Finalizando sistema...\n");
@@ -221,6 +761,14 @@ int main() {
     } while(opcao != 0);
 
     // Encerramento
+    if (threadIniciada) {
+        if (__atomic_load_n(&mineracaoAtiva, __ATOMIC_ACQUIRE))
+            printf("Aguardando a mineração terminar...\n");
+        else if (__atomic_load_n(&exportacaoAtiva, __ATOMIC_ACQUIRE))
+            printf("Aguardando a exportação em segundo plano terminar...\n");
+        pthread_join(threadMineracao, NULL);
+    }
     finalizarStorage();
+    rastroFinalizar();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,341 @@
+/*
+ * Mempool: transações pendentes com prioridade por taxa
+ *
+ * Posições fixas num vetor (lista de livres), cada pendente em duas listas
+ * duplamente encadeadas por índice:
+ *    - fila da sua taxa (256 filas, da mais antiga para a mais nova) e um
+ *      bitmap de filas não vazias: o modelo começa pela maior taxa ocupada
+ *      em O(256 / 64) e percorre só o que entra (ou é pulado, no máximo
+ *      MAX_PULADAS) no bloco, sem depender de quantas pendentes existem;
+ *    - saídas da mesma origem, por ordem de chegada: quando o saldo
+ *      projetado de um endereço fica negativo (resincronização), as
+ *      saídas mais novas dele são as removidas.
+ *
+ * Admissão, confirmação e remoção são O(1). Uma trava única protege tudo:
+ * cada operação segura a trava por poucas centenas de ns (o modelo, por
+ * alguns us), então vários geradores dividem o pool sem fila longa.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "mempool.h"
+#include "storage.h"
+
+#define NENHUMA 0xFFFFFFFFu
+#define QTD_TAXAS 256
+#define PALAVRAS_TAXAS (QTD_TAXAS / 64)
+#define NUM_ENDERECOS 256
+#define MINERADOR_OFFSET 183
+#define TRANSACAO_SIZE 3
+#define RECOMPENSA_BLOCO 50     // Mesma recompensa aplicada pelo storage a cada bloco
+#define MAX_PULADAS 4096        // Pendentes sem saldo ainda (dependem de entradas fora do modelo) antes de desistir
+
+typedef struct {
+    TransacaoPendente tx;
+    unsigned long long chegada;         // Ordem de admissão (0 = posição livre)
+    unsigned int prox, ant;             // Fila da taxa
+    unsigned int proxOrigem, antOrigem; // Saídas da mesma origem
+} EntradaMempool;
+
+static pthread_mutex_t travaMempool = PTHREAD_MUTEX_INITIALIZER;
+static EntradaMempool *entradas = NULL;
+static unsigned int livres = NENHUMA;               // Pilha de posições livres, encadeada por 'prox'
+static unsigned int inicioTaxa[QTD_TAXAS];
+static unsigned int fimTaxa[QTD_TAXAS];
+static uint64_t taxasOcupadas[PALAVRAS_TAXAS];
+static unsigned int inicioOrigem[NUM_ENDERECOS];
+static unsigned int fimOrigem[NUM_ENDERECOS];
+static unsigned long long proximaChegada = 1;
+
+// Ledger projetado = saldoCadeia + entradaPendente - saidaPendente (nunca negativo)
+static unsigned int saldoCadeia[NUM_ENDERECOS];
+static unsigned long long entradaPendente[NUM_ENDERECOS];
+static unsigned long long saidaPendente[NUM_ENDERECOS];
+
+static EstatisticasMempool estatisticas;
+
+static void inserirNasFilas(unsigned int i)
+{
+    EntradaMempool *e = &entradas[i];
+    unsigned char taxa = e->tx.taxa;
+
+    e->prox = NENHUMA;
+    e->ant = fimTaxa[taxa];
+    if (fimTaxa[taxa] != NENHUMA)
+        entradas[fimTaxa[taxa]].prox = i;
+    else
+        inicioTaxa[taxa] = i;
+    fimTaxa[taxa] = i;
+    taxasOcupadas[taxa >> 6] |= 1ULL << (taxa & 63);
+
+    unsigned char origem = e->tx.origem;
+    e->proxOrigem = NENHUMA;
+    e->antOrigem = fimOrigem[origem];
+    if (fimOrigem[origem] != NENHUMA)
+        entradas[fimOrigem[origem]].proxOrigem = i;
+    else
+        inicioOrigem[origem] = i;
+    fimOrigem[origem] = i;
+}
+
+static void removerEntrada(unsigned int i)
+{
+    EntradaMempool *e = &entradas[i];
+    unsigned char taxa = e->tx.taxa;
+
+    if (e->ant != NENHUMA)
+        entradas[e->ant].prox = e->prox;
+    else
+        inicioTaxa[taxa] = e->prox;
+    if (e->prox != NENHUMA)
+        entradas[e->prox].ant = e->ant;
+    else
+        fimTaxa[taxa] = e->ant;
+    if (inicioTaxa[taxa] == NENHUMA)
+        taxasOcupadas[taxa >> 6] &= ~(1ULL << (taxa & 63));
+
+    unsigned char origem = e->tx.origem;
+    if (e->antOrigem != NENHUMA)
+        entradas[e->antOrigem].proxOrigem = e->proxOrigem;
+    else
+        inicioOrigem[origem] = e->proxOrigem;
+    if (e->proxOrigem != NENHUMA)
+        entradas[e->proxOrigem].antOrigem = e->antOrigem;
+    else
+        fimOrigem[origem] = e->antOrigem;
+
+    e->chegada = 0;
+    e->prox = livres;
+    livres = i;
+    estatisticas.pendentes--;
+}
+
+// Validação contra o ledger projetado (não altera nada)
+static int verificarTransacao(const TransacaoPendente *tx)
+{
+    if (tx->valor == 0)
+        return MEMPOOL_INVALIDA;
+
+    unsigned long long cobertura = saldoCadeia[tx->origem] + entradaPendente[tx->origem];
+    if (tx->valor > cobertura)
+        return MEMPOOL_SALDO_INSUFICIENTE;
+    if (saidaPendente[tx->origem] + tx->valor > cobertura)
+        return MEMPOOL_CONFLITO;
+    return MEMPOOL_ACEITA;
+}
+
+static void reservarNoLedger(const TransacaoPendente *tx)
+{
+    saidaPendente[tx->origem] += tx->valor;
+    entradaPendente[tx->destino] += tx->valor;
+}
+
+// Esvazia o pool e adota os saldos da cadeia (aloca as posições na primeira chamada)
+void mempoolInicializar(const unsigned int saldosCadeia[256])
+{
+    pthread_mutex_lock(&travaMempool);
+    if (entradas == NULL)
+        entradas = verifica_malloc(MEMPOOL_CAPACIDADE * sizeof(EntradaMempool), "mempoolInicializar");
+
+    livres = NENHUMA;
+    for (unsigned int i = MEMPOOL_CAPACIDADE; i-- > 0;)
+    {
+        entradas[i].chegada = 0;
+        entradas[i].prox = livres;
+        livres = i;
+    }
+    for (int t = 0; t < QTD_TAXAS; t++)
+        inicioTaxa[t] = fimTaxa[t] = NENHUMA;
+    memset(taxasOcupadas, 0, sizeof(taxasOcupadas));
+    for (int a = 0; a < NUM_ENDERECOS; a++)
+        inicioOrigem[a] = fimOrigem[a] = NENHUMA;
+    proximaChegada = 1;
+
+    memcpy(saldoCadeia, saldosCadeia, sizeof(saldoCadeia));
+    memset(entradaPendente, 0, sizeof(entradaPendente));
+    memset(saidaPendente, 0, sizeof(saidaPendente));
+    memset(&estatisticas, 0, sizeof(estatisticas));
+    pthread_mutex_unlock(&travaMempool);
+}
+
+// Retorna MEMPOOL_ACEITA ou o motivo da rejeição
+int mempoolAdmitir(const TransacaoPendente *tx)
+{
+    pthread_mutex_lock(&travaMempool);
+    int resultado = verificarTransacao(tx);
+    if (resultado == MEMPOOL_ACEITA && livres == NENHUMA)
+        resultado = MEMPOOL_CHEIO;
+
+    if (resultado == MEMPOOL_ACEITA)
+    {
+        unsigned int i = livres;
+        livres = entradas[i].prox;
+        entradas[i].tx = *tx;
+        entradas[i].chegada = proximaChegada++;
+        inserirNasFilas(i);
+        reservarNoLedger(tx);
+        estatisticas.pendentes++;
+        estatisticas.aceitas++;
+    }
+    else
+        estatisticas.rejeitadas[resultado]++;
+    pthread_mutex_unlock(&travaMempool);
+    return resultado;
+}
+
+// Aplica a pendente 'i' no rascunho de saldos e a acrescenta ao modelo, se a origem cobrir
+static int acrescentarAoModelo(unsigned int i, unsigned int saldo[], ModeloBloco *modelo)
+{
+    const TransacaoPendente *tx = &entradas[i].tx;
+    if (saldo[tx->origem] < tx->valor)
+        return 0;
+    saldo[tx->origem] -= tx->valor;
+    saldo[tx->destino] += tx->valor;
+
+    unsigned int k = modelo->qtdTransacoes++;
+    modelo->dados[k * TRANSACAO_SIZE] = tx->origem;
+    modelo->dados[k * TRANSACAO_SIZE + 1] = tx->destino;
+    modelo->dados[k * TRANSACAO_SIZE + 2] = tx->valor;
+    modelo->entradas[k] = i;
+    modelo->chegadas[k] = entradas[i].chegada;
+    return 1;
+}
+
+/**
+ * Monta o próximo bloco com até 61 pendentes, da maior taxa para a menor
+ * (mais antiga primeiro dentro da mesma taxa). Cada escolhida é aplicada
+ * num rascunho dos saldos da cadeia (já com a recompensa do minerador), na
+ * ordem em que ficará no bloco. Quem depende de uma entrada de taxa menor é
+ * pulado e tentado de novo no fim, depois dela; se ainda não couber, fica
+ * para o próximo bloco. Nada sai do pool: só mempoolConfirmarModelo remove.
+ */
+unsigned int mempoolMontarModelo(unsigned char minerador, ModeloBloco *modelo)
+{
+    unsigned int saldo[NUM_ENDERECOS];
+    unsigned int puladas[MAX_PULADAS];
+    unsigned int qtdPuladas = 0;
+    int completo = 0;
+
+    memset(modelo->dados, 0, DATA_SIZE);
+    modelo->dados[MINERADOR_OFFSET] = minerador;
+    modelo->qtdTransacoes = 0;
+
+    pthread_mutex_lock(&travaMempool);
+    memcpy(saldo, saldoCadeia, sizeof(saldo));
+    saldo[minerador] += RECOMPENSA_BLOCO;
+
+    for (int palavra = PALAVRAS_TAXAS - 1; palavra >= 0 && !completo; palavra--)
+    {
+        uint64_t ocupadas = taxasOcupadas[palavra];
+        while (ocupadas != 0 && !completo)
+        {
+            int bit = 63 - __builtin_clzll(ocupadas);
+            ocupadas &= ~(1ULL << bit);
+
+            for (unsigned int i = inicioTaxa[palavra * 64 + bit]; i != NENHUMA; i = entradas[i].prox)
+            {
+                if (modelo->qtdTransacoes == MEMPOOL_MAX_TRANSACOES || qtdPuladas == MAX_PULADAS)
+                {
+                    completo = 1;
+                    break;
+                }
+                if (!acrescentarAoModelo(i, saldo, modelo))
+                    puladas[qtdPuladas++] = i;
+            }
+        }
+    }
+
+    for (unsigned int j = 0; j < qtdPuladas && modelo->qtdTransacoes < MEMPOOL_MAX_TRANSACOES; j++)
+        acrescentarAoModelo(puladas[j], saldo, modelo);
+    pthread_mutex_unlock(&travaMempool);
+    return modelo->qtdTransacoes;
+}
+
+/**
+ * O bloco do modelo foi conectado: suas transações passam de pendentes para
+ * a cadeia. O ledger projetado não muda (além da recompensa), então as
+ * demais pendentes continuam válidas sem revalidar. Se a cadeia mudou de
+ * outro jeito (reorganização, bloco de fora), use mempoolResincronizar.
+ */
+void mempoolConfirmarModelo(const ModeloBloco *modelo)
+{
+    pthread_mutex_lock(&travaMempool);
+    saldoCadeia[modelo->dados[MINERADOR_OFFSET]] += RECOMPENSA_BLOCO;
+    for (unsigned int k = 0; k < modelo->qtdTransacoes; k++)
+    {
+        const unsigned char *t = &modelo->dados[k * TRANSACAO_SIZE];
+        saldoCadeia[t[0]] -= t[2];
+        saldoCadeia[t[1]] += t[2];
+
+        // Já removida por uma resincronização: a posição pode ter outra transação
+        unsigned int i = modelo->entradas[k];
+        if (entradas[i].chegada != modelo->chegadas[k])
+            continue;
+        saidaPendente[t[0]] -= t[2];
+        entradaPendente[t[1]] -= t[2];
+        removerEntrada(i);
+        estatisticas.confirmadas++;
+    }
+    pthread_mutex_unlock(&travaMempool);
+}
+
+static long long saldoProjetado(unsigned char endereco)
+{
+    return (long long)saldoCadeia[endereco] + (long long)entradaPendente[endereco] - (long long)saidaPendente[endereco];
+}
+
+/**
+ * Adota novos saldos da cadeia (depois de reorganização ou bloco que não
+ * veio do modelo). Endereços com saldo projetado negativo perdem as saídas
+ * pendentes mais novas até cobrir; cada remoção tira uma entrada do
+ * destino, que pode ficar negativo e entrar na próxima passada.
+ */
+void mempoolResincronizar(const unsigned int saldosCadeia[256])
+{
+    pthread_mutex_lock(&travaMempool);
+    memcpy(saldoCadeia, saldosCadeia, sizeof(saldoCadeia));
+    memset(entradaPendente, 0, sizeof(entradaPendente));
+    memset(saidaPendente, 0, sizeof(saidaPendente));
+    for (int a = 0; a < NUM_ENDERECOS; a++)
+        for (unsigned int i = inicioOrigem[a]; i != NENHUMA; i = entradas[i].proxOrigem)
+            reservarNoLedger(&entradas[i].tx);
+
+    int removeu;
+    do
+    {
+        removeu = 0;
+        for (int a = 0; a < NUM_ENDERECOS; a++)
+        {
+            while (saldoProjetado((unsigned char)a) < 0)
+            {
+                unsigned int i = fimOrigem[a];
+                saidaPendente[a] -= entradas[i].tx.valor;
+                entradaPendente[entradas[i].tx.destino] -= entradas[i].tx.valor;
+                removerEntrada(i);
+                estatisticas.removidasResincronizacao++;
+                removeu = 1;
+            }
+        }
+    } while (removeu);
+    pthread_mutex_unlock(&travaMempool);
+}
+
+void mempoolEstatisticas(EstatisticasMempool *saida)
+{
+    pthread_mutex_lock(&travaMempool);
+    *saida = estatisticas;
+    pthread_mutex_unlock(&travaMempool);
+}
+
+void mempoolLiberar()
+{
+    pthread_mutex_lock(&travaMempool);
+    free(entradas);
+    entradas = NULL;
+    livres = NENHUMA;
+    estatisticas.pendentes = 0;
+    pthread_mutex_unlock(&travaMempool);
+}
@@ -0,0 +1,60 @@
+#ifndef MEMPOOL_H
+#define MEMPOOL_H
+
+#include "structs.h"
+
+/**
+ * Pool de transações pendentes (mempool)
+ *
+ * Geradores de transações admitem em paralelo (uma trava curta por
+ * admissão); o minerador monta o modelo do próximo bloco a partir das de
+ * maior taxa e, depois de conectar o bloco, confirma o modelo.
+ *
+ * Ledger projetado: saldo na cadeia + entradas pendentes - saídas pendentes.
+ * Uma transação só entra se a origem continua com saldo projetado >= 0
+ * (ninguém gasta mais do que tem ou vai receber); a ordem dentro do bloco é
+ * decidida pelo modelo, que aplica cada escolhida sobre os saldos da cadeia.
+ * A taxa é só prioridade: não é gravada no bloco nem cobrada.
+ */
+#define MEMPOOL_CAPACIDADE (1u << 18)
+#define MEMPOOL_MAX_TRANSACOES 61       // Transações num bloco (183 bytes / 3)
+
+// Resultado de mempoolAdmitir
+#define MEMPOOL_ACEITA 0
+#define MEMPOOL_INVALIDA 1              // Valor zero (no bloco, seria lida como vaga)
+#define MEMPOOL_SALDO_INSUFICIENTE 2    // Valor acima do saldo na cadeia + entradas pendentes
+#define MEMPOOL_CONFLITO 3              // Cabe no saldo, mas não junto das saídas já pendentes da origem
+#define MEMPOOL_CHEIO 4
+
+typedef struct {
+    unsigned char origem;
+    unsigned char destino;
+    unsigned char valor;
+    unsigned char taxa;                 // Prioridade: maior taxa entra primeiro no modelo
+} TransacaoPendente;
+
+// Modelo do próximo bloco: 'dados' vai direto para criarProxBloco
+typedef struct {
+    unsigned char dados[DATA_SIZE];
+    unsigned int qtdTransacoes;
+    unsigned int entradas[MEMPOOL_MAX_TRANSACOES];              // Posições no pool
+    unsigned long long chegadas[MEMPOOL_MAX_TRANSACOES];        // Confere que a posição não foi reaproveitada
+} ModeloBloco;
+
+typedef struct {
+    unsigned int pendentes;
+    unsigned long long aceitas;
+    unsigned long long rejeitadas[MEMPOOL_CHEIO + 1];           // Por motivo (índice = código)
+    unsigned long long confirmadas;
+    unsigned long long removidasResincronizacao;
+} EstatisticasMempool;
+
+void mempoolInicializar(const unsigned int saldosCadeia[256]);
+int mempoolAdmitir(const TransacaoPendente *tx);
+unsigned int mempoolMontarModelo(unsigned char minerador, ModeloBloco *modelo);
+void mempoolConfirmarModelo(const ModeloBloco *modelo);
+void mempoolResincronizar(const unsigned int saldosCadeia[256]);
+void mempoolEstatisticas(EstatisticasMempool *saida);
+void mempoolLiberar();
+
+#endif
@@ -0,0 +1,221 @@
+/*
+ * Árvore Merkle das transações do bloco e provas de inclusão
+ *
+ * Folhas: cada slot de transação do formato (61 de 3 bytes no v1, 15 de
+ * 12 bytes no v2) + a do minerador. Prefixos 0x00 (folha) e 0x01 (nó
+ * interno) separam os domínios, evitando que um nó interno seja
+ * apresentado como folha. Nó sem par em um nível sobe sem ser re-hasheado.
+ *
+ * Blocos quentes: as árvores montadas para provas ficam num cache de
+ * mapeamento direto indexado pelo hash do bloco. O hash cobre 'data',
+ * então uma entrada com o mesmo hash nunca fica desatualizada (nem depois
+ * de uma reorganização) e não precisa de invalidação.
+ */
+
+#include <string.h>
+#include <pthread.h>
+#include <openssl/sha.h>
+#include "merkle.h"
+#include "formato.h"
+#include "contadores.h"
+
+#define PREFIXO_FOLHA 0x00
+#define PREFIXO_NO 0x01
+#define CACHE_ARVORES 256               // ~1 MB; o índice vem dos bytes 1-2 do hash (o byte 0 é sempre 0)
+
+typedef struct {
+    pthread_mutex_t trava;
+    unsigned char hash[SHA256_LEN];
+    int v2;
+    int ocupada;
+    ArvoreMerkle arvore;
+} EntradaArvore;
+
+static EntradaArvore cacheArvores[CACHE_ARVORES];
+static pthread_once_t inicializado = PTHREAD_ONCE_INIT;
+
+// Slots vazios são a maioria no fim do vetor: hash calculado uma vez só
+static unsigned char folhaVazia[SHA256_LEN];
+static unsigned char folhaVaziaV2[SHA256_LEN];
+
+static void hashFolha(const unsigned char *bytes, size_t tamanho, unsigned char saida[SHA256_LEN])
+{
+    unsigned char prefixo = PREFIXO_FOLHA;
+    SHA256_CTX ctx;
+    SHA256_Init(&ctx);
+    SHA256_Update(&ctx, &prefixo, 1);
+    SHA256_Update(&ctx, bytes, tamanho);
+    SHA256_Final(saida, &ctx);
+}
+
+static void hashNo(const unsigned char esq[SHA256_LEN], const unsigned char dir[SHA256_LEN], unsigned char saida[SHA256_LEN])
+{
+    unsigned char prefixo = PREFIXO_NO;
+    SHA256_CTX ctx;
+    SHA256_Init(&ctx);
+    SHA256_Update(&ctx, &prefixo, 1);
+    SHA256_Update(&ctx, esq, SHA256_LEN);
+    SHA256_Update(&ctx, dir, SHA256_LEN);
+    SHA256_Final(saida, &ctx);
+}
+
+static void inicializar()
+{
+    static const unsigned char zeros[V2_TRANSACAO_SIZE] = {0};
+    hashFolha(zeros, V1_TRANSACAO_SIZE, folhaVazia);
+    hashFolha(zeros, V2_TRANSACAO_SIZE, folhaVaziaV2);
+    for (int i = 0; i < CACHE_ARVORES; i++)
+        pthread_mutex_init(&cacheArvores[i].trava, NULL);
+}
+
+int merkleQtdFolhas(int v2)
+{
+    return v2 ? MERKLE_FOLHAS_V2 : MERKLE_FOLHAS;
+}
+
+// Bytes da folha 'indice' (slot ou minerador); retorna o tamanho (0 = índice inválido)
+int merkleFolha(const unsigned char data[DATA_SIZE], int v2, int indice, unsigned char folha[MERKLE_MAX_FOLHA])
+{
+    int qtdTransacoes = formatoMaxTransacoes(v2);
+    int tamanhoTx = v2 ? V2_TRANSACAO_SIZE : V1_TRANSACAO_SIZE;
+
+    if (indice < 0 || indice > qtdTransacoes)
+        return 0;
+    if (indice == qtdTransacoes)
+    {
+        int tamanho = v2 ? 4 : 1;
+        memcpy(folha, &data[v2 ? V2_MINERADOR_OFFSET : V1_MINERADOR_OFFSET], tamanho);
+        return tamanho;
+    }
+    memcpy(folha, &data[indice * tamanhoTx], tamanhoTx);
+    return tamanhoTx;
+}
+
+void montarArvoreMerkle(const unsigned char data[DATA_SIZE], int v2, ArvoreMerkle *arvore)
+{
+    static const unsigned char zeros[V2_TRANSACAO_SIZE] = {0};
+    int qtdTransacoes = formatoMaxTransacoes(v2);
+    int tamanhoTx = v2 ? V2_TRANSACAO_SIZE : V1_TRANSACAO_SIZE;
+
+    pthread_once(&inicializado, inicializar);
+    for (int i = 0; i < qtdTransacoes; i++)
+    {
+        const unsigned char *tx = &data[i * tamanhoTx];
+        if (memcmp(tx, zeros, tamanhoTx) == 0)
+            memcpy(arvore->nos[i], v2 ? folhaVaziaV2 : folhaVazia, SHA256_LEN);
+        else
+            hashFolha(tx, tamanhoTx, arvore->nos[i]);
+    }
+    if (v2)
+        hashFolha(&data[V2_MINERADOR_OFFSET], 4, arvore->nos[qtdTransacoes]);
+    else
+        hashFolha(&data[V1_MINERADOR_OFFSET], 1, arvore->nos[qtdTransacoes]);
+
+    // Cada nível é escrito logo depois do anterior
+    int inicio = 0, qtd = qtdTransacoes + 1, proximo = qtd;
+    arvore->qtdFolhas = qtd;
+    while (qtd > 1)
+    {
+        for (int i = 0; i < qtd; i += 2)
+        {
+            if (i + 1 < qtd)
+                hashNo(arvore->nos[inicio + i], arvore->nos[inicio + i + 1], arvore->nos[proximo]);
+            else
+                memcpy(arvore->nos[proximo], arvore->nos[inicio + i], SHA256_LEN);
+            proximo++;
+        }
+        inicio += qtd;
+        qtd = (qtd + 1) / 2;
+    }
+    arvore->qtdNos = proximo;
+}
+
+void calcularRaizMerkle(const unsigned char data[DATA_SIZE], int v2, unsigned char raiz[SHA256_LEN])
+{
+    ArvoreMerkle arvore;
+    montarArvoreMerkle(data, v2, &arvore);
+    memcpy(raiz, arvore.nos[arvore.qtdNos - 1], SHA256_LEN);
+}
+
+// PROVAS DE INCLUSÃO
+
+// Irmãos do caminho da folha até a raiz; retorna 0 se o índice não existe
+int gerarProvaMerkle(const ArvoreMerkle *arvore, int indice, ProvaMerkle *prova)
+{
+    if (indice < 0 || indice >= arvore->qtdFolhas)
+        return 0;
+
+    prova->indice = (unsigned char)indice;
+    prova->qtdFolhas = (unsigned char)arvore->qtdFolhas;
+    prova->qtdIrmaos = 0;
+
+    int inicio = 0, qtd = arvore->qtdFolhas, i = indice;
+    while (qtd > 1)
+    {
+        if ((i ^ 1) < qtd)
+            memcpy(prova->irmaos[prova->qtdIrmaos++], arvore->nos[inicio + (i ^ 1)], SHA256_LEN);
+        inicio += qtd;
+        qtd = (qtd + 1) / 2;
+        i >>= 1;
+    }
+    return 1;
+}
+
+/**
+ * Refaz o caminho a partir dos bytes da folha e compara com a raiz do
+ * cabeçalho. A posição de cada irmão (esquerda ou direita) sai do índice,
+ * então uma prova não serve para outra folha. A quantidade de folhas vem do
+ * formato da cadeia, não da prova: quem prova não escolhe o formato da árvore.
+ */
+int verificarProvaMerkle(const unsigned char *folha, size_t tamanho, const ProvaMerkle *prova, int v2, const unsigned char raiz[SHA256_LEN])
+{
+    unsigned char h[SHA256_LEN];
+    int qtd = merkleQtdFolhas(v2), i = prova->indice, usados = 0;
+
+    if (prova->qtdFolhas != qtd || i >= qtd || tamanho > MERKLE_MAX_FOLHA)
+        return 0;
+
+    hashFolha(folha, tamanho, h);
+    while (qtd > 1)
+    {
+        if ((i ^ 1) < qtd)
+        {
+            if (usados >= prova->qtdIrmaos)
+                return 0;
+            if (i & 1)
+                hashNo(prova->irmaos[usados], h, h);
+            else
+                hashNo(h, prova->irmaos[usados], h);
+            usados++;
+        }
+        qtd = (qtd + 1) / 2;
+        i >>= 1;
+    }
+    return usados == prova->qtdIrmaos && memcmp(h, raiz, SHA256_LEN) == 0;
+}
+
+/**
+ * Prova da folha 'indice' do bloco, com a árvore do cache (montada e
+ * guardada na primeira prova do bloco). Retorna 0 se o índice não existe.
+ */
+int provaDoBloco(const BlocoMinerado *b, int v2, int indice, ProvaMerkle *prova, unsigned char raiz[SHA256_LEN])
+{
+    pthread_once(&inicializado, inicializar);
+    EntradaArvore *e = &cacheArvores[(b->hash[1] | b->hash[2] << 8) & (CACHE_ARVORES - 1)];
+
+    pthread_mutex_lock(&e->trava);
+    if (e->ocupada && e->v2 == v2 && memcmp(e->hash, b->hash, SHA256_LEN) == 0)
+        contadorSomar(CONTADOR_ARVORES_EM_CACHE, 1);
+    else
+    {
+        montarArvoreMerkle(b->bloco.data, v2, &e->arvore);
+        memcpy(e->hash, b->hash, SHA256_LEN);
+        e->v2 = v2;
+        e->ocupada = 1;
+        contadorSomar(CONTADOR_ARVORES_MONTADAS, 1);
+    }
+    int ok = gerarProvaMerkle(&e->arvore, indice, prova);
+    memcpy(raiz, e->arvore.nos[e->arvore.qtdNos - 1], SHA256_LEN);
+    pthread_mutex_unlock(&e->trava);
+    return ok;
+}
@@ -0,0 +1,44 @@
+#ifndef MERKLE_H
+#define MERKLE_H
+
+#include "structs.h"
+
+/**
+ * Árvore Merkle das transações de um bloco
+ *
+ * Uma folha por slot de transação e uma do minerador (a última):
+ *    v1: 61 transações de 3 bytes + minerador (1 byte) = 62 folhas
+ *    v2: 15 transações de 12 bytes + minerador (4 bytes) = 16 folhas
+ * A raiz vai no cabeçalho (.hdr) e, no v2, na prova de trabalho do bloco.
+ * Uma prova de inclusão leva só os irmãos do caminho até a raiz (no máximo
+ * 6), então quem tem o cabeçalho confere uma transação sem receber os 184
+ * bytes do bloco.
+ */
+#define MERKLE_FOLHAS 62                // Máximo de folhas (formato v1)
+#define MERKLE_FOLHAS_V2 16
+#define MERKLE_MAX_IRMAOS 6             // ceil(log2(62))
+#define MERKLE_MAX_NOS 128              // Todos os níveis de 62 folhas (124 nós)
+#define MERKLE_MAX_FOLHA 12             // Bytes da maior folha (transação v2)
+
+typedef struct {
+    unsigned char nos[MERKLE_MAX_NOS][SHA256_LEN];  // Níveis concatenados, das folhas à raiz
+    int qtdFolhas;
+    int qtdNos;                                     // A raiz é nos[qtdNos - 1]
+} ArvoreMerkle;
+
+typedef struct {
+    unsigned char indice;               // Folha provada (slot; o minerador é qtdFolhas - 1)
+    unsigned char qtdFolhas;
+    unsigned char qtdIrmaos;            // Nó sem par sobe sem irmão: pode ser menor que a altura
+    unsigned char irmaos[MERKLE_MAX_IRMAOS][SHA256_LEN];
+} ProvaMerkle;
+
+int merkleQtdFolhas(int v2);
+int merkleFolha(const unsigned char data[DATA_SIZE], int v2, int indice, unsigned char folha[MERKLE_MAX_FOLHA]);
+void montarArvoreMerkle(const unsigned char data[DATA_SIZE], int v2, ArvoreMerkle *arvore);
+void calcularRaizMerkle(const unsigned char data[DATA_SIZE], int v2, unsigned char raiz[SHA256_LEN]);
+int gerarProvaMerkle(const ArvoreMerkle *arvore, int indice, ProvaMerkle *prova);
+int verificarProvaMerkle(const unsigned char *folha, size_t tamanho, const ProvaMerkle *prova, int v2, const unsigned char raiz[SHA256_LEN]);
+int provaDoBloco(const BlocoMinerado *b, int v2, int indice, ProvaMerkle *prova, unsigned char raiz[SHA256_LEN]);
+
+#endif
@@ -0,0 +1,76 @@
+/*
+ * Tabela de metadados por bloco
+ *
+ * Substitui os nós espalhados por bloco (um nó de nonce, um nó de minerador,
+ * nós das listas de recordes e o cache de contagem à parte) por colunas
+ * paginadas: 20 bytes por bloco, sem cabeçalho de malloc nem ponteiro
+ * por entrada. Os índices de nonce e minerador e os recordes são derivados
+ * destas colunas pelo storage.
+ *
+ * Um escritor: só ele reserva páginas e publica a quantidade. Leitores
+ * carregam o ponteiro da página com acquire e só consultam IDs até a
+ * quantidade publicada. Páginas só são liberadas em metadadosInicializar,
+ * via rcuAposentar.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "metadados.h"
+#include "sincronizacao.h"
+
+PaginaMetadados *paginasMetadados[METADADOS_MAX_PAGINAS];
+
+static unsigned int quantidadeBlocos = 0;  // Acessada só com __atomic_*
+static unsigned int qtdPaginas = 0;
+
+// Esvazia a tabela (as páginas só são liberadas quando não houver leitores)
+void metadadosInicializar()
+{
+    __atomic_store_n(&quantidadeBlocos, 0, __ATOMIC_RELEASE);
+    for (unsigned int i = 0; i < qtdPaginas; i++)
+    {
+        rcuAposentar(paginasMetadados[i]);
+        __atomic_store_n(&paginasMetadados[i], NULL, __ATOMIC_RELEASE);
+    }
+    qtdPaginas = 0;
+}
+
+// Garante a página do bloco e a devolve para o escritor preencher as colunas
+PaginaMetadados *metadadosReservar(unsigned int idBloco)
+{
+    unsigned int pagina = (idBloco - 1) >> METADADOS_PAGINA_BITS;
+
+    while (qtdPaginas <= pagina)
+    {
+        PaginaMetadados *nova = calloc(1, sizeof(PaginaMetadados));
+        if (nova == NULL)
+        {
+            fprintf(stderr, "Erro malloc: metadadosReservar\n");
+            exit(1);
+        }
+        __atomic_store_n(&paginasMetadados[qtdPaginas], nova, __ATOMIC_RELEASE);
+        qtdPaginas++;
+    }
+    return paginasMetadados[pagina];
+}
+
+// Torna visíveis os blocos [1, quantidade] (também encurta, ao desconectar o topo)
+void metadadosPublicar(unsigned int quantidade)
+{
+    __atomic_store_n(&quantidadeBlocos, quantidade, __ATOMIC_RELEASE);
+}
+
+unsigned int metadadosQuantidade()
+{
+    return __atomic_load_n(&quantidadeBlocos, __ATOMIC_ACQUIRE);
+}
+
+unsigned int metadadosPaginas()
+{
+    return qtdPaginas;
+}
+
+size_t metadadosMemoria()
+{
+    return (size_t)qtdPaginas * sizeof(PaginaMetadados);
+}
@@ -0,0 +1,50 @@
+#ifndef METADADOS_H
+#define METADADOS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Tabela de metadados por bloco (estrutura de vetores, indexada pelo ID)
+ *
+ * Cada página guarda METADADOS_POR_PAGINA blocos consecutivos com uma coluna
+ * contígua por campo: uma varredura que só olha uma coluna (minerador,
+ * contagem de transações) percorre bytes vizinhos, sem seguir ponteiros.
+ * As páginas são alocadas sob demanda e nunca mudam de lugar; a página é
+ * publicada antes da quantidade de blocos que a torna visível.
+ */
+#define METADADOS_PAGINA_BITS 16                            // 64K blocos por página
+#define METADADOS_POR_PAGINA (1u << METADADOS_PAGINA_BITS)
+#define METADADOS_MAX_PAGINAS (1u << (32 - METADADOS_PAGINA_BITS))
+
+typedef struct {
+    uint64_t prefixoHash[METADADOS_POR_PAGINA];     // Chave do índice por hash (8 bytes após o 00)
+    unsigned int nonce[METADADOS_POR_PAGINA];
+    unsigned int proxNonce[METADADOS_POR_PAGINA];   // Bloco anterior no mesmo slot da tabela de nonces (0 = fim)
+    unsigned short valor[METADADOS_POR_PAGINA];     // BTC transferidos (até 61 x 255)
+    unsigned char qtdTx[METADADOS_POR_PAGINA];      // Transações válidas
+    unsigned char minerador[METADADOS_POR_PAGINA];
+} PaginaMetadados;
+
+extern PaginaMetadados *paginasMetadados[METADADOS_MAX_PAGINAS];
+
+void metadadosInicializar();
+PaginaMetadados *metadadosReservar(unsigned int idBloco);
+void metadadosPublicar(unsigned int quantidade);
+unsigned int metadadosQuantidade();
+unsigned int metadadosPaginas();
+size_t metadadosMemoria();
+
+// Página do bloco (existe para todo ID até metadadosQuantidade)
+static inline PaginaMetadados *metadadosPagina(unsigned int idBloco)
+{
+    return __atomic_load_n(&paginasMetadados[(idBloco - 1) >> METADADOS_PAGINA_BITS], __ATOMIC_ACQUIRE);
+}
+
+// Posição do bloco dentro das colunas da sua página
+static inline unsigned int metadadosPosicao(unsigned int idBloco)
+{
+    return (idBloco - 1) & (METADADOS_POR_PAGINA - 1);
+}
+
+#endif
@@ -0,0 +1,401 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "mtwister.h"
+#include "philox.h"
+#include "structs.h"
+#include "miner.h"
+#include "transactions.h"
+#include "storage.h"
+#include "ledger.h"
+#include "merkle.h"
+
+// Microbenchmarks dos caminhos quentes, com aquecimento, repetições e saída JSON
+
+#define ARQUIVO_MICRO "microbenchmark.bin"
+#define ARQUIVO_MICRO_TXT "microbenchmark_export.txt"
+#define ARQUIVO_JSON_PADRAO "microbenchmark.json"
+#define BLOCOS_CADEIA 5000
+#define MAX_REPETICOES 1000
+#define BLOCOS_QUENTES 64           // Blocos cujas árvores ficam no cache durante o caso quente
+#define PROVAS_PREPARADAS 256
+#define CONEXAO_AQUECIMENTO 10
+#define CONEXAO_REPETICOES 100
+#define CONEXAO_OPERACOES 50
+#define BLOCOS_EXTENSAO ((CONEXAO_AQUECIMENTO + CONEXAO_REPETICOES) * CONEXAO_OPERACOES)
+
+typedef struct {
+    const char *nome;
+    unsigned int aquecimento;       // Repetições descartadas (caches, páginas, branch predictor)
+    unsigned int repeticoes;        // Repetições medidas (cada uma vira uma amostra)
+    unsigned int operacoes;         // Operações por repetição (amostra = tempo / operações)
+    void (*rodar)(unsigned int operacoes);
+} Microbenchmark;
+
+typedef struct {
+    double mediana, p99, minimo, media;
+} Resumo;
+
+static MTRand rBench;
+static unsigned int totalCadeia = 0;
+static unsigned int nonces[BLOCOS_CADEIA];
+static volatile unsigned int sumidouro;     // Impede o compilador de descartar os resultados
+
+// Provas prontas (com a raiz do cabeçalho) para medir só a verificação
+static ProvaMerkle provas[PROVAS_PREPARADAS];
+static unsigned char folhas[PROVAS_PREPARADAS][MERKLE_MAX_FOLHA];
+static int tamanhosFolha[PROVAS_PREPARADAS];
+static unsigned char raizes[PROVAS_PREPARADAS][SHA256_LEN];
+
+// Blocos minerados sobre o topo da cadeia, conectados um a um pelo caso de conexão
+static BlocoMinerado extensao[BLOCOS_EXTENSAO];
+static unsigned int proximaExtensao = 0;
+
+static double tempo_ms(struct timespec inicio, struct timespec fim) {
+    return (fim.tv_sec - inicio.tv_sec) * 1000.0 + (fim.tv_nsec - inicio.tv_nsec) / 1e6;
+}
+
+static void removerArquivosMicro() {
+    remove(ARQUIVO_MICRO);
+    remove("microbenchmark.hdr");
+    remove("microbenchmark.txt");
+    remove("microbenchmark.idx");
+    remove(ARQUIVO_MICRO_TXT);
+}
+
+// CASOS
+
+static void rodarCalcularHash(unsigned int n) {
+    BlocoNaoMinerado b;
+    unsigned char hash[SHA256_LEN];
+    memset(&b, 0, sizeof(b));
+    b.numero = genRandLong(&rBench);
+
+    for (unsigned int i = 0; i < n; i++) {
+        b.nonce = i;
+        calcularHash(&b, hash);
+        sumidouro += hash[0];
+    }
+}
+
+static void rodarMinerarBloco(unsigned int n) {
+    BlocoNaoMinerado b;
+    unsigned char hash[SHA256_LEN];
+    memset(&b, 0, sizeof(b));
+
+    for (unsigned int i = 0; i < n; i++) {
+        b.numero = genRandLong(&rBench);
+        minerarBloco(&b, 0, hash);
+        sumidouro += b.nonce;
+    }
+}
+
+static void rodarGerarDados(unsigned int n) {
+    unsigned char dados[DATA_SIZE];
+    for (unsigned int i = 0; i < n; i++)
+        sumidouro += gerarDadosDoBloco(2 + i, dados, NULL, &rBench);
+}
+
+static void rodarGenRandLong(unsigned int n) {
+    unsigned int acumulado = 0;
+    for (unsigned int i = 0; i < n; i++)
+        acumulado += genRandLong(&rBench);
+    sumidouro += acumulado;
+}
+
+// Mesma sequência do genRandLong, pedida em lotes de 'lote' palavras (ns por palavra)
+static void gerarEmLotes(unsigned int n, unsigned int lote) {
+    static uint32_t saida[STATE_VECTOR_LENGTH * 4];
+    unsigned int acumulado = 0;
+    for (unsigned int i = 0; i < n; i += lote) {
+        unsigned int qtd = n - i < lote ? n - i : lote;
+        genRandLongArray(&rBench, saida, qtd);
+        acumulado += saida[qtd - 1];
+    }
+    sumidouro += acumulado;
+}
+
+static void rodarGenRandLongArray16(unsigned int n) {
+    gerarEmLotes(n, 16);
+}
+
+static void rodarGenRandLongArray624(unsigned int n) {
+    gerarEmLotes(n, STATE_VECTOR_LENGTH);
+}
+
+static void rodarGenRandLongArray2496(unsigned int n) {
+    gerarEmLotes(n, STATE_VECTOR_LENGTH * 4);
+}
+
+// Acesso direto: cada sorteio é uma avaliação do Philox (4 palavras, 3 descartadas)
+static void rodarPhiloxSorteio(unsigned int n) {
+    unsigned int acumulado = 0;
+    for (unsigned int i = 0; i < n; i++)
+        acumulado += philoxSorteio(42, i >> 10, i & 1023);
+    sumidouro += acumulado;
+}
+
+static void rodarPhiloxPreencher(unsigned int n) {
+    static uint32_t saida[STATE_VECTOR_LENGTH];
+    unsigned int acumulado = 0;
+    for (unsigned int i = 0; i < n; i += STATE_VECTOR_LENGTH) {
+        unsigned int qtd = n - i < STATE_VECTOR_LENGTH ? n - i : STATE_VECTOR_LENGTH;
+        philoxPreencher(42, i, 0, saida, qtd);
+        acumulado += saida[qtd - 1];
+    }
+    sumidouro += acumulado;
+}
+
+static void rodarGerarDadosPhilox(unsigned int n) {
+    unsigned char dados[DATA_SIZE];
+    for (unsigned int i = 0; i < n; i++)
+        sumidouro += gerarDadosDoBlocoContador(2 + i, dados, NULL, 42);
+}
+
+// Versão consistente dos saldos e lista dos endereços com saldo, sem varrer os 256
+static void rodarLedgerAdquirir(unsigned int n) {
+    unsigned char candidatos[LEDGER_ENDERECOS];
+    for (unsigned int i = 0; i < n; i++) {
+        VersaoLedger *v = ledgerAdquirir();
+        sumidouro += ledgerEnderecosNaoZero(v, candidatos) + ledgerSaldo(v, (unsigned char)i);
+        ledgerLiberar(v);
+    }
+}
+
+// Empatados no recorde saem de uma varredura da coluna de contagem (1 byte por bloco)
+static void rodarBlocosRecorde(unsigned int n) {
+    unsigned int ids[16];
+    int valor;
+    for (unsigned int i = 0; i < n; i++)
+        sumidouro += blocosRecorde(i & 1, &valor, ids, 16);
+}
+
+static void contarBloco(BlocoMinerado *b, int qtdTx, void *contexto) {
+    (void)b;
+    (void)qtdTx;
+    (*(unsigned int *)contexto)++;
+}
+
+// Metade das buscas acerta um nonce da cadeia, metade é nonce aleatório (quase sempre ausente)
+static void rodarBuscarNonce(unsigned int n) {
+    unsigned int encontrados = 0;
+    for (unsigned int i = 0; i < n; i++) {
+        unsigned int nonce = (i & 1) ? nonces[genRandLong(&rBench) % totalCadeia] : genRandLong(&rBench);
+        percorrerBlocosPorNonce(nonce, contarBloco, &encontrados);
+    }
+    sumidouro += encontrados;
+}
+
+static void rodarLerAleatorio(unsigned int n) {
+    BlocoMinerado b;
+    for (unsigned int i = 0; i < n; i++) {
+        buscarBlocoPorId(1 + genRandLong(&rBench) % totalCadeia, &b);
+        sumidouro += b.bloco.nonce;
+    }
+}
+
+static void rodarLerSequencial(unsigned int n) {
+    BlocoMinerado b;
+    unsigned int inicio = 1 + genRandLong(&rBench) % (totalCadeia - n + 1);
+    for (unsigned int i = 0; i < n; i++) {
+        buscarBlocoPorId(inicio + i, &b);
+        sumidouro += b.bloco.nonce;
+    }
+}
+
+static void rodarMontarArvore(unsigned int n) {
+    BlocoMinerado b;
+    ArvoreMerkle arvore;
+    buscarBlocoPorId(2 + genRandLong(&rBench) % (totalCadeia - 1), &b);
+    for (unsigned int i = 0; i < n; i++) {
+        montarArvoreMerkle(b.bloco.data, 0, &arvore);
+        sumidouro += arvore.nos[arvore.qtdNos - 1][1];
+    }
+}
+
+// Leitura do bloco + prova; 'blocos' consecutivos a partir do 2 (quente: cabem no cache de árvores)
+static void gerarProvas(unsigned int n, unsigned int blocos) {
+    ProvaMerkle prova;
+    unsigned char folha[MERKLE_MAX_FOLHA];
+    for (unsigned int i = 0; i < n; i++) {
+        unsigned int id = 2 + genRandLong(&rBench) % blocos;
+        sumidouro += gerarProvaInclusao(id, (int)(genRandLong(&rBench) % MERKLE_FOLHAS), &prova, folha) + prova.qtdIrmaos;
+    }
+}
+
+static void rodarProvaQuente(unsigned int n) {
+    gerarProvas(n, BLOCOS_QUENTES);
+}
+
+static void rodarProvaFria(unsigned int n) {
+    gerarProvas(n, totalCadeia - 1);
+}
+
+static void rodarVerificarProva(unsigned int n) {
+    for (unsigned int i = 0; i < n; i++) {
+        unsigned int p = i % PROVAS_PREPARADAS;
+        sumidouro += verificarProvaMerkle(folhas[p], (size_t)tamanhosFolha[p], &provas[p], 0, raizes[p]);
+    }
+}
+
+static void rodarReconstruirIndices(unsigned int n) {
+    for (unsigned int i = 0; i < n; i++)
+        recarregarIndicesDoDisco();
+}
+
+static void rodarExportarTexto(unsigned int n) {
+    for (unsigned int i = 0; i < n; i++)
+        exportarParaTexto(ARQUIVO_MICRO_TXT);
+}
+
+/**
+ * Conexão pelo caminho público (adicionarBloco) de blocos já minerados:
+ * inserção na tabela de nonces e no filtro, índice por hash, colunas de
+ * metadados e gravação em lote. Os blocos não têm transações, então o
+ * ledger quase não pesa. Cresce a cadeia: fica por último na tabela.
+ */
+static void rodarConectarBloco(unsigned int n) {
+    for (unsigned int i = 0; i < n && proximaExtensao < BLOCOS_EXTENSAO; i++)
+        adicionarBloco(&extensao[proximaExtensao++]);
+    sumidouro += obterTotalBlocos();
+}
+
+static const Microbenchmark casos[] = {
+    {"calcularHash",               200, 500,  1000,  rodarCalcularHash},
+    {"minerarBloco",               20,  200,  1,     rodarMinerarBloco},
+    {"gerarDadosDoBloco",          50,  500,  100,   rodarGerarDados},
+    {"genRandLong",                50,  500,  10000, rodarGenRandLong},
+    {"genRandLongArray lote 16",   50,  500,  10000, rodarGenRandLongArray16},
+    {"genRandLongArray lote 624",  50,  500,  10000, rodarGenRandLongArray624},
+    {"genRandLongArray lote 2496", 50,  500,  10000, rodarGenRandLongArray2496},
+    {"philoxSorteio",              50,  500,  10000, rodarPhiloxSorteio},
+    {"philoxPreencher lote 624",   50,  500,  10000, rodarPhiloxPreencher},
+    {"gerarDadosDoBloco philox",   50,  500,  100,   rodarGerarDadosPhilox},
+    {"ledgerAdquirir",             50,  500,  1000,  rodarLedgerAdquirir},
+    {"blocosRecorde",              10,  200,  100,   rodarBlocosRecorde},
+    {"buscarNonce",                50,  500,  100,   rodarBuscarNonce},
+    {"lerBlocoPorId aleatorio",    50,  500,  100,   rodarLerAleatorio},
+    {"lerBlocoPorId sequencial",   50,  500,  100,   rodarLerSequencial},
+    {"montarArvoreMerkle",         50,  500,  100,   rodarMontarArvore},
+    {"provaInclusao quente",       50,  500,  1000,  rodarProvaQuente},
+    {"provaInclusao fria",         50,  500,  100,   rodarProvaFria},
+    {"verificarProvaMerkle",       50,  500,  1000,  rodarVerificarProva},
+    {"reconstruirIndicesDoDisco",  2,   20,   1,     rodarReconstruirIndices},
+    {"exportarParaTexto",          1,   10,   1,     rodarExportarTexto},
+    {"adicionarBloco (conexao)",  CONEXAO_AQUECIMENTO, CONEXAO_REPETICOES, CONEXAO_OPERACOES, rodarConectarBloco},
+};
+
+#define QTD_CASOS (sizeof(casos) / sizeof(casos[0]))
+
+// MEDIÇÃO
+
+static int compararDouble(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static Resumo medir(const Microbenchmark *caso) {
+    static double amostras[MAX_REPETICOES];
+    struct timespec t_start, t_end;
+    Resumo r = {0};
+
+    for (unsigned int i = 0; i < caso->aquecimento; i++)
+        caso->rodar(caso->operacoes);
+
+    for (unsigned int i = 0; i < caso->repeticoes; i++) {
+        clock_gettime(CLOCK_MONOTONIC, &t_start);
+        caso->rodar(caso->operacoes);
+        clock_gettime(CLOCK_MONOTONIC, &t_end);
+        amostras[i] = tempo_ms(t_start, t_end) * 1e6 / caso->operacoes;    // ns por operação
+        r.media += amostras[i];
+    }
+
+    unsigned int n = caso->repeticoes;
+    qsort(amostras, n, sizeof(double), compararDouble);
+    r.minimo = amostras[0];
+    r.mediana = amostras[n / 2];
+    r.p99 = amostras[(unsigned int)(n * 0.99)];
+    r.media /= n;
+    return r;
+}
+
+static void prepararCadeia() {
+    MTRand r = seedRand(1234567);
+    unsigned char dados[DATA_SIZE];
+
+    gerarDadosDoBloco(1, dados, NULL, &r);
+    BlocoMinerado anterior = criarBlocoGenesis(dados);
+    adicionarBloco(&anterior);
+    nonces[0] = anterior.bloco.nonce;
+    for (unsigned int i = 2; i <= BLOCOS_CADEIA; i++) {
+        gerarDadosDoBloco(i, dados, NULL, &r);
+        BlocoMinerado novo = criarProxBloco(anterior, i, dados, 0);
+        adicionarBloco(&novo);
+        nonces[i - 1] = novo.bloco.nonce;
+        anterior = novo;
+    }
+    totalCadeia = obterTotalBlocos();
+
+    // Extensão sem transações: só o minerador varia, como nos ramos do benchmark de reorganização
+    memset(dados, 0, sizeof(dados));
+    for (unsigned int i = 0; i < BLOCOS_EXTENSAO; i++) {
+        dados[DATA_SIZE - 1] = (unsigned char)i;
+        extensao[i] = criarProxBloco(anterior, totalCadeia + 1 + i, dados, 0);
+        anterior = extensao[i];
+    }
+
+    for (unsigned int p = 0; p < PROVAS_PREPARADAS; p++) {
+        CabecalhoBloco cab;
+        unsigned int id = 2 + genRandLong(&r) % (totalCadeia - 1);
+        tamanhosFolha[p] = gerarProvaInclusao(id, (int)(genRandLong(&r) % MERKLE_FOLHAS), &provas[p], folhas[p]);
+        buscarCabecalhoPorId(id, &cab);
+        memcpy(raizes[p], cab.raizDados, SHA256_LEN);
+    }
+}
+
+/**
+ * Uso: ./microbenchmark [arquivo.json]
+ * A tabela vai para a saída padrão e o JSON para o arquivo (padrão microbenchmark.json),
+ * para comparar resultados entre commits.
+ */
+int main(int argc, char *argv[]) {
+    const char *arquivoJson = argc > 1 ? argv[1] : ARQUIVO_JSON_PADRAO;
+    Resumo resumos[QTD_CASOS];
+
+    rBench = seedRand(42);
+    removerArquivosMicro();
+    inicializarStorage(ARQUIVO_MICRO);
+
+    printf("Minerando cadeia de %d blocos para os casos de storage...\n", BLOCOS_CADEIA);
+    prepararCadeia();
+
+    for (size_t c = 0; c < QTD_CASOS; c++)
+        resumos[c] = medir(&casos[c]);
+
+    printf("\n%-28s %-8s %-8s %-14s %-14s %-14s %-14s\n", "Caso", "Repet.", "Ops", "mediana (ns)", "p99 (ns)",
+           "min (ns)", "media (ns)");
+    for (size_t c = 0; c < QTD_CASOS; c++)
+        printf("%-28s %-8u %-8u %-14.1f %-14.1f %-14.1f %-14.1f\n", casos[c].nome, casos[c].repeticoes,
+               casos[c].operacoes, resumos[c].mediana, resumos[c].p99, resumos[c].minimo, resumos[c].media);
+
+    FILE *json = fopen(arquivoJson, "w");
+    if (!json) {
+        perror("Erro ao criar arquivo JSON");
+    } else {
+        fprintf(json, "{\"blocos\":%u,\"unidade\":\"ns/op\",\"casos\":[\n", totalCadeia);
+        for (size_t c = 0; c < QTD_CASOS; c++)
+            fprintf(json, "  {\"nome\":\"%s\",\"aquecimento\":%u,\"repeticoes\":%u,\"operacoes\":%u,"
+                    "\"mediana\":%.2f,\"p99\":%.2f,\"min\":%.2f,\"media\":%.2f}%s\n",
+                    casos[c].nome, casos[c].aquecimento, casos[c].repeticoes, casos[c].operacoes, resumos[c].mediana,
+                    resumos[c].p99, resumos[c].minimo, resumos[c].media, c + 1 < QTD_CASOS ? "," : "");
+        fprintf(json, "]}\n");
+        fclose(json);
+        printf("\nResultados em %s\n", arquivoJson);
+    }
+
+    finalizarStorage();
+    removerArquivosMicro();
+    return 0;
+}
@@ -5,6 +5,9 @@
 #include "mtwister.h"
 #include "miner.h"
 #include "structs.h"
+#include "merkle.h"
+#include "formato.h"
+#include "contadores.h"
 
 #define SHA256_LEN 32
 
@@ -18,19 +21,92 @@ void calcularHash(BlocoNaoMinerado *b, unsigned char hash[SHA256_LEN]){
     SHA256_Update(&ctx, &b->hashAnterior, SHA256_LEN);
 
     SHA256_Final(hash, &ctx);
+    contadorSomar(CONTADOR_HASHES, 1);
 }
 
-void minerarBloco(BlocoNaoMinerado *b, unsigned char hash [SHA256_LEN]){
+/**
+ * Estado intermediário do SHA-256 após numero|nonce|data.
+ * Os 4 + 4 + 184 = 192 bytes fecham exatamente 3 blocos de compressão,
+ * então o estado interno já compromete todo o conteúdo do bloco.
+ */
+void calcularEstadoParcial(BlocoNaoMinerado *b, unsigned char estado[SHA256_LEN]){
+    SHA256_CTX ctx;
+    SHA256_Init(&ctx);
+
+    SHA256_Update(&ctx, &b->numero, sizeof(b->numero));
+    SHA256_Update(&ctx, &b->nonce, sizeof(b->nonce));
+    SHA256_Update(&ctx, &b->data, sizeof(b->data));
+
+    memcpy(estado, ctx.h, SHA256_LEN);
+}
+
+/**
+ * Termina o hash a partir do estado intermediário: uma única compressão
+ * sobre hashAnterior + padding. Resultado idêntico a calcularHash.
+ */
+void finalizarHashParcial(const unsigned char estado[SHA256_LEN], const unsigned char hashAnterior[SHA256_LEN], unsigned char hash[SHA256_LEN]){
+    SHA256_CTX ctx;
+    SHA256_Init(&ctx);
+
+    memcpy(ctx.h, estado, SHA256_LEN);
+    ctx.Nl = (sizeof(unsigned int) * 2 + DATA_SIZE) * 8; // 192 bytes já processados
+    ctx.Nh = 0;
+    ctx.num = 0;
+
+    SHA256_Update(&ctx, hashAnterior, SHA256_LEN);
+    SHA256_Final(hash, &ctx);
+    contadorSomar(CONTADOR_HASHES, 1);
+}
+
+/**
+ * Hash do formato v2: numero | nonce | raiz Merkle de 'data' | hashAnterior
+ * (72 bytes). A raiz entra na prova de trabalho, então o cabeçalho, que a
+ * guarda, autentica as provas de inclusão sem os 184 bytes do bloco.
+ */
+void calcularHashComRaiz(unsigned int numero, unsigned int nonce, const unsigned char raiz[SHA256_LEN], const unsigned char hashAnterior[SHA256_LEN], unsigned char hash[SHA256_LEN]){
+    SHA256_CTX ctx;
+    SHA256_Init(&ctx);
+
+    SHA256_Update(&ctx, &numero, sizeof(numero));
+    SHA256_Update(&ctx, &nonce, sizeof(nonce));
+    SHA256_Update(&ctx, raiz, SHA256_LEN);
+    SHA256_Update(&ctx, hashAnterior, SHA256_LEN);
+
+    SHA256_Final(hash, &ctx);
+    contadorSomar(CONTADOR_HASHES, 1);
+}
+
+// Hash do bloco pela regra do formato da cadeia (v1: numero|nonce|data|hashAnterior)
+void calcularHashFormato(BlocoNaoMinerado *b, int v2, unsigned char hash[SHA256_LEN]){
+    if (!v2){
+        calcularHash(b, hash);
+        return;
+    }
+    unsigned char raiz[SHA256_LEN];
+    calcularRaizMerkle(b->data, 1, raiz);
+    calcularHashComRaiz(b->numero, b->nonce, raiz, b->hashAnterior, hash);
+}
+
+// No v2 a raiz é calculada uma vez: cada nonce custa um SHA-256 de 72 bytes
+void minerarBloco(BlocoNaoMinerado *b, int v2, unsigned char hash [SHA256_LEN]){
+    unsigned char raiz[SHA256_LEN];
+    if (v2)
+        calcularRaizMerkle(b->data, 1, raiz);
     b->nonce = 0;
 
     while(1){
-        calcularHash(b, hash);
+        if (v2)
+            calcularHashComRaiz(b->numero, b->nonce, raiz, b->hashAnterior, hash);
+        else
+            calcularHash(b, hash);
         // Verificação de 00
         if (hash[0] == 0){
             break;
         }
         b->nonce++;
     }
+    contadorSomar(CONTADOR_TENTATIVAS_NONCE, (unsigned long long)b->nonce + 1);
+    contadorSomar(CONTADOR_BLOCOS_MINERADOS, 1);
 }
 
 void atualizarHashAnt(BlocoNaoMinerado *prox, unsigned char hashAnterior[SHA256_LEN]){
@@ -49,12 +125,13 @@ BlocoMinerado criarBlocoGenesis(unsigned char dados[]){
     BlocoMinerado blocoFinal;
     blocoFinal.bloco = bg;
 
-    minerarBloco(&blocoFinal.bloco, blocoFinal.hash);
+    // O gênesis v2 traz a marca do formato nos próprios dados
+    minerarBloco(&blocoFinal.bloco, formatoContasDoGenesis(bg.data) != 0, blocoFinal.hash);
 
     return blocoFinal;
 }
 
-BlocoMinerado criarProxBloco(BlocoMinerado ant, unsigned int num, unsigned char dados[]){
+BlocoMinerado criarProxBloco(BlocoMinerado ant, unsigned int num, unsigned char dados[], int v2){
     BlocoNaoMinerado novo;
     memset(&novo, 0, sizeof(novo));
 
@@ -68,7 +145,7 @@ BlocoMinerado criarProxBloco(BlocoMinerado ant, unsigned int num, unsigned char
     BlocoMinerado final;
     final.bloco = novo;
 
-    minerarBloco(&final.bloco, final.hash);
+    minerarBloco(&final.bloco, v2, final.hash);
 
     return final;
 }
@@ -6,9 +6,13 @@
 
 // Protótipos das funções
 void calcularHash(BlocoNaoMinerado *b, unsigned char hash[SHA256_LEN]);
-void minerarBloco(BlocoNaoMinerado *b, unsigned char hash [SHA256_LEN]);
+void calcularEstadoParcial(BlocoNaoMinerado *b, unsigned char estado[SHA256_LEN]);
+void finalizarHashParcial(const unsigned char estado[SHA256_LEN], const unsigned char hashAnterior[SHA256_LEN], unsigned char hash[SHA256_LEN]);
+void calcularHashComRaiz(unsigned int numero, unsigned int nonce, const unsigned char raiz[SHA256_LEN], const unsigned char hashAnterior[SHA256_LEN], unsigned char hash[SHA256_LEN]);
+void calcularHashFormato(BlocoNaoMinerado *b, int v2, unsigned char hash[SHA256_LEN]);
+void minerarBloco(BlocoNaoMinerado *b, int v2, unsigned char hash [SHA256_LEN]);
 void atualizarHashAnt(BlocoNaoMinerado *prox, unsigned char hashAnterior[SHA256_LEN]);
 BlocoMinerado criarBlocoGenesis(unsigned char dados[]);
-BlocoMinerado criarProxBloco(BlocoMinerado ant, unsigned int num, unsigned char dados[]);
+BlocoMinerado criarProxBloco(BlocoMinerado ant, unsigned int num, unsigned char dados[], int v2);
 
 #endif
\ No newline at end of file
@@ -10,12 +10,48 @@
 
 #define UPPER_MASK		0x80000000
 #define LOWER_MASK		0x7fffffff
+#define MATRIX_A		0x9908b0df
 #define TEMPERING_MASK_B	0x9d2c5680
 #define TEMPERING_MASK_C	0xefc60000
 
 #include <stdint.h>
+#include <string.h>
 #include "mtwister.h"
 
+/* The state is regenerated and tempered 624 words at a time. With AVX2
+ * (-mavx2 or -march=native) 8 words go through each step at once, with
+ * SSE2 (the x86-64 baseline) 4; other targets use the scalar loops only.
+ * Every lane computes exactly the scalar recurrence, so the output
+ * sequence does not depend on the path taken.
+ */
+#if defined(__AVX2__)
+#include <immintrin.h>
+typedef __m256i vec_t;
+#define VEC_WORDS		8
+#define VEC_LOAD(p)		_mm256_loadu_si256((const __m256i*)(p))
+#define VEC_STORE(p, v)		_mm256_storeu_si256((__m256i*)(p), (v))
+#define VEC_SET1(x)		_mm256_set1_epi32((int32_t)(x))
+#define VEC_AND(a, b)		_mm256_and_si256((a), (b))
+#define VEC_OR(a, b)		_mm256_or_si256((a), (b))
+#define VEC_XOR(a, b)		_mm256_xor_si256((a), (b))
+#define VEC_SRL(a, n)		_mm256_srli_epi32((a), (n))
+#define VEC_SLL(a, n)		_mm256_slli_epi32((a), (n))
+#define VEC_EQ(a, b)		_mm256_cmpeq_epi32((a), (b))
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+typedef __m128i vec_t;
+#define VEC_WORDS		4
+#define VEC_LOAD(p)		_mm_loadu_si128((const __m128i*)(p))
+#define VEC_STORE(p, v)		_mm_storeu_si128((__m128i*)(p), (v))
+#define VEC_SET1(x)		_mm_set1_epi32((int32_t)(x))
+#define VEC_AND(a, b)		_mm_and_si128((a), (b))
+#define VEC_OR(a, b)		_mm_or_si128((a), (b))
+#define VEC_XOR(a, b)		_mm_xor_si128((a), (b))
+#define VEC_SRL(a, n)		_mm_srli_epi32((a), (n))
+#define VEC_SLL(a, n)		_mm_slli_epi32((a), (n))
+#define VEC_EQ(a, b)		_mm_cmpeq_epi32((a), (b))
+#endif
+
 inline static void m_seedRand(MTRand* rand, uint32_t seed) {
   /* set initial seeds to mt[STATE_VECTOR_LENGTH] using the generator
    * from Line 25 of Table 1 in: Donald Knuth, "The Art of Computer
@@ -27,6 +63,79 @@ inline static void m_seedRand(MTRand* rand, uint32_t seed) {
   }
 }
 
+#define N_MINUS_M		(STATE_VECTOR_LENGTH-STATE_VECTOR_M)
+
+inline static uint32_t m_twistWord(uint32_t cur, uint32_t next, uint32_t far) {
+  uint32_t y = (cur & UPPER_MASK) | (next & LOWER_MASK);
+  return far ^ (y >> 1) ^ (-(y & 0x1) & MATRIX_A);
+}
+
+inline static uint32_t m_temper(uint32_t y) {
+  y ^= (y >> 11);
+  y ^= (y << 7) & TEMPERING_MASK_B;
+  y ^= (y << 15) & TEMPERING_MASK_C;
+  y ^= (y >> 18);
+  return y;
+}
+
+#ifdef VEC_WORDS
+/* far ^ (y >> 1) ^ (MATRIX_A if y is odd), lane by lane */
+inline static vec_t m_twistVec(vec_t cur, vec_t next, vec_t far) {
+  vec_t y = VEC_OR(VEC_AND(cur, VEC_SET1(UPPER_MASK)), VEC_AND(next, VEC_SET1(LOWER_MASK)));
+  vec_t odd = VEC_EQ(VEC_AND(y, VEC_SET1(0x1)), VEC_SET1(0x1));
+  return VEC_XOR(VEC_XOR(far, VEC_SRL(y, 1)), VEC_AND(odd, VEC_SET1(MATRIX_A)));
+}
+#endif
+
+/* Regenerates mt[] in place and refills tempered[]. */
+static void m_nextState(MTRand* rand) {
+  uint32_t* mt = rand->mt;
+  int32_t kk = 0;
+
+  if(rand->index >= STATE_VECTOR_LENGTH+1 || rand->index < 0) {
+    m_seedRand(rand, 4357);
+  }
+
+  /* mt[kk+M] is still the old word here, and so is mt[kk+1..kk+VEC_WORDS]
+   * since the whole vector is loaded before it is stored */
+#ifdef VEC_WORDS
+  for(; kk+VEC_WORDS<=N_MINUS_M; kk+=VEC_WORDS) {
+    VEC_STORE(&mt[kk], m_twistVec(VEC_LOAD(&mt[kk]), VEC_LOAD(&mt[kk+1]), VEC_LOAD(&mt[kk+STATE_VECTOR_M])));
+  }
+#endif
+  for(; kk<N_MINUS_M; kk++) {
+    mt[kk] = m_twistWord(mt[kk], mt[kk+1], mt[kk+STATE_VECTOR_M]);
+  }
+
+  /* mt[kk-(N-M)] was already regenerated (N-M > VEC_WORDS) and mt[N-1]
+   * is only overwritten last, so the next words are still the old ones */
+#ifdef VEC_WORDS
+  for(; kk+VEC_WORDS<=STATE_VECTOR_LENGTH-1; kk+=VEC_WORDS) {
+    VEC_STORE(&mt[kk], m_twistVec(VEC_LOAD(&mt[kk]), VEC_LOAD(&mt[kk+1]), VEC_LOAD(&mt[kk-N_MINUS_M])));
+  }
+#endif
+  for(; kk<STATE_VECTOR_LENGTH-1; kk++) {
+    mt[kk] = m_twistWord(mt[kk], mt[kk+1], mt[kk-N_MINUS_M]);
+  }
+  mt[STATE_VECTOR_LENGTH-1] = m_twistWord(mt[STATE_VECTOR_LENGTH-1], mt[0], mt[STATE_VECTOR_M-1]);
+
+  kk = 0;
+#ifdef VEC_WORDS
+  for(; kk+VEC_WORDS<=STATE_VECTOR_LENGTH; kk+=VEC_WORDS) {
+    vec_t y = VEC_LOAD(&mt[kk]);
+    y = VEC_XOR(y, VEC_SRL(y, 11));
+    y = VEC_XOR(y, VEC_AND(VEC_SLL(y, 7), VEC_SET1(TEMPERING_MASK_B)));
+    y = VEC_XOR(y, VEC_AND(VEC_SLL(y, 15), VEC_SET1(TEMPERING_MASK_C)));
+    y = VEC_XOR(y, VEC_SRL(y, 18));
+    VEC_STORE(&rand->tempered[kk], y);
+  }
+#endif
+  for(; kk<STATE_VECTOR_LENGTH; kk++) {
+    rand->tempered[kk] = m_temper(mt[kk]);
+  }
+  rand->index = 0;
+}
+
 /**
 * Creates a new random number generator from a given seed.
 */
@@ -40,33 +149,31 @@ MTRand seedRand(uint32_t seed) {
  * Generates a pseudo-randomly generated long.
  */
 uint32_t genRandLong(MTRand* rand) {
-
-  uint32_t y;
-  static uint32_t mag[2] = {0x0, 0x9908b0df}; /* mag[x] = x * 0x9908b0df for x = 0,1 */
   if(rand->index >= STATE_VECTOR_LENGTH || rand->index < 0) {
-    /* generate STATE_VECTOR_LENGTH words at a time */
-    int32_t kk;
-    if(rand->index >= STATE_VECTOR_LENGTH+1 || rand->index < 0) {
-      m_seedRand(rand, 4357);
-    }
-    for(kk=0; kk<STATE_VECTOR_LENGTH-STATE_VECTOR_M; kk++) {
-      y = (rand->mt[kk] & UPPER_MASK) | (rand->mt[kk+1] & LOWER_MASK);
-      rand->mt[kk] = rand->mt[kk+STATE_VECTOR_M] ^ (y >> 1) ^ mag[y & 0x1];
+    m_nextState(rand);
+  }
+  return rand->tempered[rand->index++];
+}
+
+/**
+ * Fills out[0..n-1] with the next n longs, exactly as n calls to
+ * genRandLong would, copying from the tempered state in bulk.
+ */
+void genRandLongArray(MTRand* rand, uint32_t* out, size_t n) {
+  while(n > 0) {
+    size_t chunk;
+    if(rand->index >= STATE_VECTOR_LENGTH || rand->index < 0) {
+      m_nextState(rand);
     }
-    for(; kk<STATE_VECTOR_LENGTH-1; kk++) {
-      y = (rand->mt[kk] & UPPER_MASK) | (rand->mt[kk+1] & LOWER_MASK);
-      rand->mt[kk] = rand->mt[kk+(STATE_VECTOR_M-STATE_VECTOR_LENGTH)] ^ (y >> 1) ^ mag[y & 0x1];
+    chunk = (size_t)(STATE_VECTOR_LENGTH - rand->index);
+    if(chunk > n) {
+      chunk = n;
     }
-    y = (rand->mt[STATE_VECTOR_LENGTH-1] & UPPER_MASK) | (rand->mt[0] & LOWER_MASK);
-    rand->mt[STATE_VECTOR_LENGTH-1] = rand->mt[STATE_VECTOR_M-1] ^ (y >> 1) ^ mag[y & 0x1];
-    rand->index = 0;
+    memcpy(out, &rand->tempered[rand->index], chunk * sizeof(uint32_t));
+    rand->index += (int32_t)chunk;
+    out += chunk;
+    n -= chunk;
   }
-  y = rand->mt[rand->index++];
-  y ^= (y >> 11);
-  y ^= (y << 7) & TEMPERING_MASK_B;
-  y ^= (y << 15) & TEMPERING_MASK_C;
-  y ^= (y >> 18);
-  return y;
 }
 
 /**
@@ -1,6 +1,7 @@
 #ifndef __MTWISTER_H
 #define __MTWISTER_H
 
+#include <stddef.h>
 #include <stdint.h>
 
 #define STATE_VECTOR_LENGTH 624
@@ -8,11 +9,13 @@
 
 typedef struct tagMTRand {
   uint32_t mt[STATE_VECTOR_LENGTH];
+  uint32_t tempered[STATE_VECTOR_LENGTH]; /* outputs of the current state, tempered in bulk */
   int32_t index;
 } MTRand;
 
 MTRand seedRand(uint32_t seed);
 uint32_t genRandLong(MTRand* rand);
+void genRandLongArray(MTRand* rand, uint32_t* out, size_t n);
 double genRand(MTRand* rand);
 
 #endif /* #ifndef __MTWISTER_H */
\ No newline at end of file
@@ -0,0 +1,77 @@
+/*
+ * Philox4x32-10
+ *
+ * Contador de 128 bits = (grupo de 4 sorteios, bloco, 0, 0) e chave de 64
+ * bits = semente. Dez rodadas de multiplicação 32x32->64 e XOR com a chave,
+ * que avança por constantes de Weyl a cada rodada. As duas palavras
+ * livres do contador ficam para futuros fluxos independentes (outra
+ * finalidade de sorteio sobre o mesmo bloco).
+ */
+
+#include "philox.h"
+
+#define PHILOX_M0 0xD2511F53u
+#define PHILOX_M1 0xCD9E8D57u
+#define PHILOX_W0 0x9E3779B9u
+#define PHILOX_W1 0xBB67AE85u
+#define PHILOX_RODADAS 10
+
+void philoxGerar(uint64_t semente, uint32_t bloco, uint32_t contador, uint32_t saida[4])
+{
+    uint32_t c0 = contador, c1 = bloco, c2 = 0, c3 = 0;
+    uint32_t k0 = (uint32_t)semente, k1 = (uint32_t)(semente >> 32);
+
+    for (int i = 0; i < PHILOX_RODADAS; i++)
+    {
+        uint64_t p0 = (uint64_t)PHILOX_M0 * c0;
+        uint64_t p1 = (uint64_t)PHILOX_M1 * c2;
+        c0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0;
+        c1 = (uint32_t)p1;
+        c2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+        c3 = (uint32_t)p0;
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+    saida[0] = c0;
+    saida[1] = c1;
+    saida[2] = c2;
+    saida[3] = c3;
+}
+
+// Acesso direto a um sorteio, sem passar pelos anteriores
+uint32_t philoxSorteio(uint64_t semente, uint32_t bloco, uint32_t indice)
+{
+    uint32_t palavras[4];
+    philoxGerar(semente, bloco, indice >> 2, palavras);
+    return palavras[indice & 3];
+}
+
+// Sorteios [inicio, inicio + n) do bloco; cada grupo de 4 é independente (paralelizável)
+void philoxPreencher(uint64_t semente, uint32_t bloco, uint32_t inicio, uint32_t *saida, size_t n)
+{
+    uint32_t palavras[4];
+    size_t i = 0;
+
+    // Início desalinhado: completa o grupo corrente
+    if (inicio & 3)
+    {
+        philoxGerar(semente, bloco, inicio >> 2, palavras);
+        for (uint32_t j = inicio & 3; j < 4 && i < n; j++)
+            saida[i++] = palavras[j];
+    }
+    for (uint32_t contador = (inicio + 3) >> 2; n - i >= 4; contador++, i += 4)
+        philoxGerar(semente, bloco, contador, &saida[i]);
+    if (i < n)
+    {
+        philoxGerar(semente, bloco, (uint32_t)((inicio + i) >> 2), palavras);
+        for (uint32_t j = 0; i < n; j++)
+            saida[i++] = palavras[j];
+    }
+}
+
+void philoxIniciarFluxo(FluxoPhilox *f, uint64_t semente, uint32_t bloco)
+{
+    f->semente = semente;
+    f->bloco = bloco;
+    f->indice = 0;
+}
@@ -0,0 +1,42 @@
+#ifndef PHILOX_H
+#define PHILOX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Gerador baseado em contador (Philox4x32-10, Salmon et al., SC'11)
+ *
+ * Cada sorteio é uma função pura de (semente, bloco, índice do sorteio): não
+ * há estado que passe de um bloco para o outro, então os sorteios de qualquer
+ * bloco podem ser gerados em qualquer thread, em qualquer ordem, ou gerados
+ * de novo depois. Uma avaliação do Philox devolve 4 palavras, os sorteios
+ * 4c a 4c+3 do bloco.
+ */
+typedef struct {
+    uint64_t semente;
+    uint32_t bloco;
+    uint32_t indice;            // Próximo sorteio do fluxo
+    uint32_t palavras[4];       // Saída do contador indice / 4
+} FluxoPhilox;
+
+void philoxGerar(uint64_t semente, uint32_t bloco, uint32_t contador, uint32_t saida[4]);
+uint32_t philoxSorteio(uint64_t semente, uint32_t bloco, uint32_t indice);
+void philoxPreencher(uint64_t semente, uint32_t bloco, uint32_t inicio, uint32_t *saida, size_t n);
+void philoxIniciarFluxo(FluxoPhilox *f, uint64_t semente, uint32_t bloco);
+
+// Próximo sorteio do bloco (o mesmo que philoxSorteio(semente, bloco, indice))
+static inline uint32_t philoxProximo(FluxoPhilox *f)
+{
+    if ((f->indice & 3) == 0)
+        philoxGerar(f->semente, f->bloco, f->indice >> 2, f->palavras);
+    return f->palavras[f->indice++ & 3];
+}
+
+// Inteiro em [0, limite) por multiplicação e deslocamento: sem divisão, usa os bits altos do sorteio
+static inline uint32_t sorteioLimitado(uint32_t x, uint32_t limite)
+{
+    return (uint32_t)(((uint64_t)x * limite) >> 32);
+}
+
+#endif
@@ -0,0 +1,305 @@
+/*
+ * Estrutura de estatística de ordem sobre os saldos (Treap em vetor)
+ *
+ * Um nó por endereço, ordenado pela chave (saldo, endereço). Cada nó guarda
+ * o tamanho da subárvore, a soma dos saldos e a soma ponderada pela posição
+ * (Σ i·x_i, com i = posição crescente dentro da subárvore). Com isso:
+ *    - k-ésimo maior/menor, posição de um endereço, mediana: O(log n)
+ *    - coeficiente de Gini: O(1) lendo a raiz
+ *    - atualizar o saldo de um endereço: O(log n) (remove + reinsere)
+ * Prioridades vêm de um hash do endereço: a árvore tem altura O(log n)
+ * esperada e o resultado é determinístico.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "ranking.h"
+
+#define NULO 0xFFFFFFFFu
+
+typedef struct {
+    unsigned int saldo;
+    unsigned int prioridade;
+    unsigned int esq, dir;
+    unsigned int tamanho;           // Nós na subárvore
+    unsigned long long soma;        // Σ saldos da subárvore
+    unsigned long long ponderada;   // Σ (posição crescente) * saldo na subárvore
+} NoRanking;
+
+static NoRanking *nos = NULL;
+static unsigned int qtdNos = 0;
+static unsigned int raiz = NULO;
+
+static unsigned int hashPrioridade(unsigned int x)
+{
+    x ^= x >> 16;
+    x *= 0x7feb352dU;
+    x ^= x >> 15;
+    x *= 0x846ca68bU;
+    x ^= x >> 16;
+    return x;
+}
+
+// Chave (saldo, endereço): a < b ?
+static int menorQue(unsigned int a, unsigned int b)
+{
+    if (nos[a].saldo != nos[b].saldo)
+        return nos[a].saldo < nos[b].saldo;
+    return a < b;
+}
+
+static void recalcular(unsigned int n)
+{
+    NoRanking *no = &nos[n];
+    unsigned int tamEsq = 0;
+    unsigned long long somaEsq = 0, pondEsq = 0;
+    unsigned long long somaDir = 0, pondDir = 0;
+    unsigned int tamDir = 0;
+
+    if (no->esq != NULO)
+    {
+        tamEsq = nos[no->esq].tamanho;
+        somaEsq = nos[no->esq].soma;
+        pondEsq = nos[no->esq].ponderada;
+    }
+    if (no->dir != NULO)
+    {
+        tamDir = nos[no->dir].tamanho;
+        somaDir = nos[no->dir].soma;
+        pondDir = nos[no->dir].ponderada;
+    }
+
+    no->tamanho = tamEsq + 1 + tamDir;
+    no->soma = somaEsq + no->saldo + somaDir;
+    // Elementos da direita são deslocados por (tamEsq + 1) posições
+    no->ponderada = pondEsq + (unsigned long long)(tamEsq + 1) * no->saldo
+                  + pondDir + (unsigned long long)(tamEsq + 1) * somaDir;
+}
+
+// Divide 't' em (< chave de 'n') e (>= chave de 'n')
+static void dividir(unsigned int t, unsigned int n, unsigned int *menores, unsigned int *maiores)
+{
+    if (t == NULO)
+    {
+        *menores = *maiores = NULO;
+        return;
+    }
+    if (menorQue(t, n))
+    {
+        dividir(nos[t].dir, n, &nos[t].dir, maiores);
+        *menores = t;
+    }
+    else
+    {
+        dividir(nos[t].esq, n, menores, &nos[t].esq);
+        *maiores = t;
+    }
+    recalcular(t);
+}
+
+// Junta duas árvores em que todas as chaves de 'a' são menores que as de 'b'
+static unsigned int juntar(unsigned int a, unsigned int b)
+{
+    if (a == NULO) return b;
+    if (b == NULO) return a;
+
+    if (nos[a].prioridade > nos[b].prioridade)
+    {
+        nos[a].dir = juntar(nos[a].dir, b);
+        recalcular(a);
+        return a;
+    }
+    nos[b].esq = juntar(a, nos[b].esq);
+    recalcular(b);
+    return b;
+}
+
+static unsigned int inserir(unsigned int t, unsigned int n)
+{
+    unsigned int menores, maiores;
+    dividir(t, n, &menores, &maiores);
+    return juntar(juntar(menores, n), maiores);
+}
+
+static unsigned int remover(unsigned int t, unsigned int n)
+{
+    if (t == NULO)
+        return NULO;
+    if (t == n)
+        return juntar(nos[t].esq, nos[t].dir);
+
+    if (menorQue(n, t))
+        nos[t].esq = remover(nos[t].esq, n);
+    else
+        nos[t].dir = remover(nos[t].dir, n);
+    recalcular(t);
+    return t;
+}
+
+void rankingInicializar(unsigned int qtdEnderecos)
+{
+    rankingConstruir(NULL, qtdEnderecos);
+}
+
+/**
+ * Monta a árvore de uma vez a partir dos saldos (NULL = todos zerados).
+ * A forma do treap depende só das chaves e prioridades, então o resultado
+ * é o mesmo de aplicar rankingAtualizar bloco a bloco.
+ */
+void rankingConstruir(const unsigned int *saldosIniciais, unsigned int qtdEnderecos)
+{
+    rankingLimpar();
+
+    nos = malloc(qtdEnderecos * sizeof(NoRanking));
+    if (!nos)
+    {
+        fprintf(stderr, "Erro malloc: rankingConstruir\n");
+        exit(1);
+    }
+    qtdNos = qtdEnderecos;
+
+    for (unsigned int i = 0; i < qtdEnderecos; i++)
+    {
+        nos[i].saldo = saldosIniciais ? saldosIniciais[i] : 0;
+        nos[i].prioridade = hashPrioridade(i);
+        nos[i].esq = nos[i].dir = NULO;
+        recalcular(i);
+        raiz = inserir(raiz, i);
+    }
+}
+
+void rankingAtualizar(unsigned int endereco, unsigned int saldo)
+{
+    if (endereco >= qtdNos || nos[endereco].saldo == saldo)
+        return;
+
+    raiz = remover(raiz, endereco);
+    nos[endereco].saldo = saldo;
+    nos[endereco].esq = nos[endereco].dir = NULO;
+    recalcular(endereco);
+    raiz = inserir(raiz, endereco);
+}
+
+unsigned int rankingQuantidade()
+{
+    return qtdNos;
+}
+
+// Endereço na posição k (1 = menor saldo). Retorna NULO se k estiver fora do intervalo.
+unsigned int rankingKesimoMenor(unsigned int k, unsigned int *saldo)
+{
+    unsigned int t = raiz;
+    if (k < 1 || k > qtdNos)
+        return NULO;
+
+    while (t != NULO)
+    {
+        unsigned int tamEsq = nos[t].esq != NULO ? nos[nos[t].esq].tamanho : 0;
+        if (k <= tamEsq)
+            t = nos[t].esq;
+        else if (k == tamEsq + 1)
+        {
+            if (saldo) *saldo = nos[t].saldo;
+            return t;
+        }
+        else
+        {
+            k -= tamEsq + 1;
+            t = nos[t].dir;
+        }
+    }
+    return NULO;
+}
+
+// Endereço na posição k do ranking de riqueza (1 = mais rico)
+unsigned int rankingKesimoMaior(unsigned int k, unsigned int *saldo)
+{
+    if (k < 1 || k > qtdNos)
+        return NULO;
+    return rankingKesimoMenor(qtdNos - k + 1, saldo);
+}
+
+// Posição do endereço no ranking de riqueza (1 = mais rico)
+unsigned int rankingPosicao(unsigned int endereco)
+{
+    if (endereco >= qtdNos)
+        return 0;
+
+    unsigned int t = raiz;
+    unsigned int maiores = 0;
+
+    while (t != NULO && t != endereco)
+    {
+        if (menorQue(endereco, t))
+        {
+            maiores += 1 + (nos[t].dir != NULO ? nos[nos[t].dir].tamanho : 0);
+            t = nos[t].esq;
+        }
+        else
+            t = nos[t].dir;
+    }
+    if (nos[endereco].dir != NULO)
+        maiores += nos[nos[endereco].dir].tamanho;
+    return maiores + 1;
+}
+
+// Quantos endereços têm exatamente 'saldo'
+unsigned int rankingContarIguais(unsigned int saldo)
+{
+    // Conta chaves < (saldo, 0) e < (saldo + 1, 0) descendo a árvore
+    unsigned int limites[2] = {saldo, saldo + 1};
+    unsigned int abaixo[2] = {0, 0};
+
+    for (int j = 0; j < 2; j++)
+    {
+        unsigned int t = raiz;
+        if (j == 1 && saldo == 0xFFFFFFFFu)
+        {
+            abaixo[1] = qtdNos;
+            break;
+        }
+        while (t != NULO)
+        {
+            if (nos[t].saldo < limites[j])
+            {
+                abaixo[j] += 1 + (nos[t].esq != NULO ? nos[nos[t].esq].tamanho : 0);
+                t = nos[t].dir;
+            }
+            else
+                t = nos[t].esq;
+        }
+    }
+    return abaixo[1] - abaixo[0];
+}
+
+double rankingMediana()
+{
+    unsigned int a = 0, b = 0;
+    if (qtdNos == 0)
+        return 0.0;
+
+    rankingKesimoMenor((qtdNos + 1) / 2, &a);
+    rankingKesimoMenor(qtdNos / 2 + 1, &b);
+    return (a + (double)b) / 2.0;
+}
+
+/**
+ * G = 2·Σ(i·x_i) / (n·Σx) - (n + 1) / n, com x em ordem crescente.
+ * 0 = todos com o mesmo saldo, próximo de 1 = tudo em um só endereço.
+ */
+double rankingGini()
+{
+    if (raiz == NULO || nos[raiz].soma == 0)
+        return 0.0;
+
+    double n = (double)nos[raiz].tamanho;
+    return (2.0 * (double)nos[raiz].ponderada) / (n * (double)nos[raiz].soma) - (n + 1.0) / n;
+}
+
+void rankingLimpar()
+{
+    free(nos);
+    nos = NULL;
+    qtdNos = 0;
+    raiz = NULO;
+}
@@ -0,0 +1,16 @@
+#ifndef RANKING_H
+#define RANKING_H
+
+void rankingInicializar(unsigned int qtdEnderecos);
+void rankingConstruir(const unsigned int *saldosIniciais, unsigned int qtdEnderecos);
+void rankingAtualizar(unsigned int endereco, unsigned int saldo);
+unsigned int rankingQuantidade();
+unsigned int rankingKesimoMenor(unsigned int k, unsigned int *saldo);
+unsigned int rankingKesimoMaior(unsigned int k, unsigned int *saldo);
+unsigned int rankingPosicao(unsigned int endereco);
+unsigned int rankingContarIguais(unsigned int saldo);
+double rankingMediana();
+double rankingGini();
+void rankingLimpar();
+
+#endif
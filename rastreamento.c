@@ -0,0 +1,200 @@
+/*
+ * Rastreamento de fases (Chrome trace-event JSON)
+ *
+ * Cada thread grava seus eventos num buffer próprio, formado por blocos de
+ * tamanho fixo encadeados: o caminho quente é ler o relógio e preencher uma
+ * posição do bloco atual, sem trava e sem atomics de RMW. Um bloco novo só
+ * é alocado a cada EVENTOS_POR_BLOCO eventos. Os buffers das threads ficam
+ * numa lista global (inserção com CAS) que só é percorrida ao gravar o
+ * arquivo. A quantidade de eventos e o encadeamento dos blocos são
+ * publicados com store-release, então a gravação vê eventos completos mesmo
+ * com threads ainda ativas (o que vier depois fica de fora).
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "rastreamento.h"
+
+#define EVENTOS_POR_BLOCO 8192
+
+typedef struct {
+    const char *nome;
+    const char *categoria;
+    unsigned long long inicio;      // ns (CLOCK_MONOTONIC)
+    unsigned long long duracao;     // ns
+} EventoRastro;
+
+typedef struct BlocoEventos {
+    EventoRastro eventos[EVENTOS_POR_BLOCO];
+    unsigned int qtd;               // Publicado com release pelo dono
+    struct BlocoEventos *prox;
+} BlocoEventos;
+
+typedef struct BufferThread {
+    unsigned int tid;
+    const char *nome;
+    BlocoEventos *primeiro;
+    BlocoEventos *atual;            // Só a thread dona acessa
+    struct BufferThread *prox;
+} BufferThread;
+
+static int rastroAtivo = 0;                         // Acessado só com __atomic_*
+static char *arquivoRastro = NULL;
+static BufferThread *listaBuffers = NULL;           // Acessada só com __atomic_*
+static unsigned int proximoTid = 1;
+static _Thread_local BufferThread *bufferDaThread = NULL;
+
+static unsigned long long agoraNs()
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (unsigned long long)t.tv_sec * 1000000000ULL + (unsigned long long)t.tv_nsec;
+}
+
+static BlocoEventos *novoBlocoEventos()
+{
+    BlocoEventos *b = malloc(sizeof(BlocoEventos));
+    if (b == NULL)
+    {
+        fprintf(stderr, "Erro malloc: novoBlocoEventos\n");
+        exit(1);
+    }
+    b->qtd = 0;
+    b->prox = NULL;
+    return b;
+}
+
+static BufferThread *registrarThread()
+{
+    BufferThread *t = malloc(sizeof(BufferThread));
+    if (t == NULL)
+    {
+        fprintf(stderr, "Erro malloc: registrarThread\n");
+        exit(1);
+    }
+    t->tid = __atomic_fetch_add(&proximoTid, 1, __ATOMIC_RELAXED);
+    t->nome = NULL;
+    t->primeiro = t->atual = novoBlocoEventos();
+
+    t->prox = __atomic_load_n(&listaBuffers, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&listaBuffers, &t->prox, t, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+        ;
+    bufferDaThread = t;
+    return t;
+}
+
+void rastroIniciar(const char *arquivo)
+{
+    free(arquivoRastro);
+    arquivoRastro = malloc(strlen(arquivo) + 1);
+    if (arquivoRastro == NULL)
+    {
+        fprintf(stderr, "Erro malloc: rastroIniciar\n");
+        exit(1);
+    }
+    strcpy(arquivoRastro, arquivo);
+    __atomic_store_n(&rastroAtivo, 1, __ATOMIC_RELEASE);
+}
+
+void rastroNomearThread(const char *nome)
+{
+    if (!__atomic_load_n(&rastroAtivo, __ATOMIC_ACQUIRE))
+        return;
+    BufferThread *t = bufferDaThread ? bufferDaThread : registrarThread();
+    __atomic_store_n(&t->nome, nome, __ATOMIC_RELEASE);
+}
+
+unsigned long long rastroInicio()
+{
+    if (!__atomic_load_n(&rastroAtivo, __ATOMIC_RELAXED))
+        return 0;
+    return agoraNs();
+}
+
+void rastroFim(const char *nome, const char *categoria, unsigned long long inicio)
+{
+    if (inicio == 0)
+        return;
+    unsigned long long fim = agoraNs();
+
+    BufferThread *t = bufferDaThread ? bufferDaThread : registrarThread();
+    BlocoEventos *b = t->atual;
+    if (b->qtd == EVENTOS_POR_BLOCO)
+    {
+        BlocoEventos *novo = novoBlocoEventos();
+        __atomic_store_n(&b->prox, novo, __ATOMIC_RELEASE);
+        t->atual = b = novo;
+    }
+
+    EventoRastro *e = &b->eventos[b->qtd];
+    e->nome = nome;
+    e->categoria = categoria;
+    e->inicio = inicio;
+    e->duracao = fim - inicio;
+    __atomic_store_n(&b->qtd, b->qtd + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * Grava todos os eventos em Chrome trace-event JSON (eventos "X", tempos em
+ * microssegundos relativos ao primeiro evento) e desliga o rastreamento.
+ * Os buffers não são liberados: threads ainda ativas podem estar usando-os.
+ */
+void rastroFinalizar()
+{
+    if (!__atomic_exchange_n(&rastroAtivo, 0, __ATOMIC_ACQ_REL))
+        return;
+
+    FILE *f = fopen(arquivoRastro, "w");
+    if (f == NULL)
+    {
+        fprintf(stderr, "Erro ao criar arquivo de rastro: %s\n", arquivoRastro);
+        return;
+    }
+
+    // Origem do tempo: o evento mais antigo de todas as threads
+    unsigned long long origem = ~0ULL;
+    unsigned long long totalEventos = 0;
+    BufferThread *lista = __atomic_load_n(&listaBuffers, __ATOMIC_ACQUIRE);
+    for (BufferThread *t = lista; t != NULL; t = t->prox)
+    {
+        for (BlocoEventos *b = t->primeiro; b != NULL; b = __atomic_load_n(&b->prox, __ATOMIC_ACQUIRE))
+        {
+            // Trechos aninhados terminam antes do externo: o mais antigo pode estar em qualquer posição
+            unsigned int qtd = __atomic_load_n(&b->qtd, __ATOMIC_ACQUIRE);
+            for (unsigned int i = 0; i < qtd; i++)
+                if (b->eventos[i].inicio < origem)
+                    origem = b->eventos[i].inicio;
+        }
+    }
+    if (origem == ~0ULL)
+        origem = 0;
+
+    fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    int primeiro = 1;
+    for (BufferThread *t = lista; t != NULL; t = t->prox)
+    {
+        const char *nome = __atomic_load_n(&t->nome, __ATOMIC_ACQUIRE);
+        fprintf(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                primeiro ? "" : ",\n", t->tid, nome ? nome : "thread");
+        primeiro = 0;
+
+        for (BlocoEventos *b = t->primeiro; b != NULL; b = __atomic_load_n(&b->prox, __ATOMIC_ACQUIRE))
+        {
+            unsigned int qtd = __atomic_load_n(&b->qtd, __ATOMIC_ACQUIRE);
+            for (unsigned int i = 0; i < qtd; i++)
+            {
+                EventoRastro *e = &b->eventos[i];
+                fprintf(f, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                        e->nome, e->categoria, t->tid, (e->inicio - origem) / 1000.0, e->duracao / 1000.0);
+            }
+            totalEventos += qtd;
+        }
+    }
+    fprintf(f, "\n]}\n");
+    fclose(f);
+
+    fprintf(stderr, "Rastro gravado em %s (%llu eventos)\n", arquivoRastro, totalEventos);
+}
@@ -0,0 +1,21 @@
+#ifndef RASTREAMENTO_H
+#define RASTREAMENTO_H
+
+/**
+ * Linha do tempo no formato Chrome trace-event (chrome://tracing, Perfetto).
+ * Desligado por padrão: rastroInicio devolve 0 e rastroFim volta sem fazer nada.
+ *
+ * Uso de um trecho (span):
+ *     unsigned long long t0 = rastroInicio();
+ *     ...
+ *     rastroFim("flushBuffer", "storage", t0);
+ *
+ * 'nome' e 'categoria' precisam ser strings estáticas (só o ponteiro é guardado).
+ */
+void rastroIniciar(const char *arquivo);
+void rastroFinalizar();
+void rastroNomearThread(const char *nome);
+unsigned long long rastroInicio();
+void rastroFim(const char *nome, const char *categoria, unsigned long long inicio);
+
+#endif
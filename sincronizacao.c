@@ -0,0 +1,110 @@
+/*
+ * Primitivas de leitura concorrente (seqlock e publicação estilo RCU)
+ *
+ * Usadas pelo storage para que consultas rodem em outra thread enquanto a
+ * mineração adiciona blocos:
+ *    - Seqlock: estatísticas pequenas (saldos, contadores, buffer de escrita)
+ *      são copiadas pelo leitor sem trava; a cópia se repete se houve escrita.
+ *    - RCU: listas encadeadas são publicadas com store-release e lidas com
+ *      load-acquire; nós removidos vão para uma lista de aposentados e só são
+ *      liberados quando o contador de leitores ativos chega a zero.
+ * Só a thread escritora chama rcuAposentar e rcuSincronizar.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sched.h>
+#include "sincronizacao.h"
+
+typedef struct NoAposentado {
+    void *ptr;
+    struct NoAposentado *prox;
+} NoAposentado;
+
+static unsigned int leitoresAtivos = 0;     // Acessado só com __atomic_*
+static NoAposentado *aposentados = NULL;    // Exclusivo do escritor
+static size_t qtdAposentados = 0;
+
+void seqlockEscritaInicio(Seqlock *s)
+{
+    __atomic_store_n(&s->sequencia, s->sequencia + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+void seqlockEscritaFim(Seqlock *s)
+{
+    __atomic_store_n(&s->sequencia, s->sequencia + 1, __ATOMIC_RELEASE);
+}
+
+unsigned int seqlockLeituraInicio(const Seqlock *s)
+{
+    unsigned int seq;
+    // Escrita em andamento: cede a CPU (o escritor pode ter sido preemptado no meio dela)
+    while ((seq = __atomic_load_n(&s->sequencia, __ATOMIC_ACQUIRE)) & 1)
+        sched_yield();
+    return seq;
+}
+
+int seqlockLeituraRepetir(const Seqlock *s, unsigned int inicio)
+{
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&s->sequencia, __ATOMIC_RELAXED) != inicio;
+}
+
+void rcuLeituraInicio()
+{
+    __atomic_fetch_add(&leitoresAtivos, 1, __ATOMIC_SEQ_CST);
+}
+
+void rcuLeituraFim()
+{
+    __atomic_fetch_sub(&leitoresAtivos, 1, __ATOMIC_RELEASE);
+}
+
+// Adia o free(ptr) até o próximo período sem leitores
+void rcuAposentar(void *ptr)
+{
+    if (ptr == NULL)
+        return;
+
+    NoAposentado *no = malloc(sizeof(NoAposentado));
+    if (!no)
+    {
+        fprintf(stderr, "Erro malloc: rcuAposentar\n");
+        exit(1);
+    }
+    no->ptr = ptr;
+    no->prox = aposentados;
+    aposentados = no;
+    qtdAposentados++;
+}
+
+/**
+ * Libera tudo que foi aposentado se nenhum leitor está ativo agora. Um
+ * leitor que entrar depois já não alcança os ponteiros aposentados (eles
+ * foram desligados antes), então zero leitores é um período de graça.
+ */
+void rcuSincronizar()
+{
+    if (aposentados == NULL)
+        return;
+
+    // Ordena as trocas de ponteiro antes da leitura do contador
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&leitoresAtivos, __ATOMIC_SEQ_CST) != 0)
+        return;
+
+    while (aposentados != NULL)
+    {
+        NoAposentado *prox = aposentados->prox;
+        free(aposentados->ptr);
+        free(aposentados);
+        aposentados = prox;
+    }
+    qtdAposentados = 0;
+}
+
+size_t rcuPendentes()
+{
+    return qtdAposentados;
+}
@@ -0,0 +1,31 @@
+#ifndef SINCRONIZACAO_H
+#define SINCRONIZACAO_H
+
+#include <stddef.h>
+
+/**
+ * Seqlock: um escritor, vários leitores que nunca bloqueiam o escritor.
+ * O leitor copia os dados e repete se a sequência mudou (ou era ímpar,
+ * escrita em andamento) durante a cópia.
+ */
+typedef struct {
+    unsigned int sequencia;     // Par = estável, ímpar = escrita em andamento
+} Seqlock;
+
+void seqlockEscritaInicio(Seqlock *s);
+void seqlockEscritaFim(Seqlock *s);
+unsigned int seqlockLeituraInicio(const Seqlock *s);
+int seqlockLeituraRepetir(const Seqlock *s, unsigned int inicio);
+
+/**
+ * Publicação estilo RCU: leitores marcam a seção de leitura; o escritor
+ * troca ponteiros e "aposenta" a memória antiga, que só é liberada quando
+ * não há nenhum leitor ativo.
+ */
+void rcuLeituraInicio();
+void rcuLeituraFim();
+void rcuAposentar(void *ptr);
+void rcuSincronizar();
+size_t rcuPendentes();
+
+#endif
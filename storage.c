@@ -2,33 +2,101 @@
  * 
  * TRADE-OFFS DE DESEMPENHO/MEMÓRIA:
  * 
- * Hash Table (2^14 slots): ~64KB de ponteiros
+ * Tabela de metadados: colunas por bloco (nonce, minerador, contagem, valor, prefixo do hash)
+ *    - Pro: 20 bytes por bloco, sem nós nem ponteiros; varrer uma coluna é sequencial
+ *    - Contra: Páginas de 64K blocos (até 1.25 MB alocados além do necessário)
+ * 
+ * Hash Table (2^14 slots): ~64KB de IDs, encadeada pela coluna proxNonce
  *    - Pro: Busca O(1) por nonce em média
  *    - Contra: Memória fixa mesmo se poucos nonces únicos
  * 
- * Índice Mineradores: Array de 256 listas
- *    - Pro: Acesso direto O(1) por endereço
- *    - Contra: 256 ponteiros sempre alocados 
+ * Filtro de Bloom na frente da Hash Table de Nonces
+ *    - Pro: Nonces ausentes são rejeitados sem percorrer a lista do slot
+ *    - Contra: ~10 bits por nonce (para 1% de falso positivo)
+ * 
+ * Blocos por minerador: varredura da coluna de mineradores
+ *    - Pro: Nenhuma memória além de 1 byte por bloco
+ *    - Contra: N primeiros blocos custam ~256·N bytes lidos (pior caso: a coluna toda)
  * 
- * Listas de Recordes: Dinâmicas para MAX/MIN transações
- *    - Pro: Sem limite de empates, libera automaticamente
- *    - Contra: "Overhead" de alocação por nó
+ * Recordes MAX/MIN de transações: só o valor; os empatados saem da coluna de contagem
+ *    - Pro: Sem listas nem retenção de listas antigas para desfazer
+ *    - Contra: Relatório de recordes lê a coluna inteira (1 byte por bloco)
  * 
  * Buffer de escrita: 16 blocos
  *    - Pro: Reduz I/O em 16x 
+ * 
+ * Histórico por endereço: listas invertidas com deltas em varint
+ *    - Pro: Consulta paginada proporcional ao resultado
+ *    - Contra: ~2 bytes por transferência (x2: origem e destino)
+ * 
+ * Ranking de saldos: Treap em vetor (um nó por endereço)
+ *    - Pro: Top-N, posição, mediana em O(log n) e Gini em O(1)
+ *    - Contra: ~40 bytes por endereço e O(log n) por saldo alterado
+ * 
+ * Checkpoints de saldo a cada K blocos (deltas zigzag/varint)
+ *    - Pro: Saldo em qualquer altura em O(K) em vez de O(altura)
+ *    - Contra: ~300 bytes por checkpoint (K menor = mais memória)
+ * 
+ * Índice por hash (.idx): diretório radix de vetores ordenados
+ *    - Pro: Bloco pelo hash completo ou prefixo em poucos acessos
+ *    - Contra: 16 bytes por bloco; salvo no disco para não refazer na carga
+ * 
+ * Modo cadeia grande: sem histórico por endereço e sem exportação em texto
+ *    - Pro: Memória por bloco limitada (sem termo proporcional às transações)
+ *    - Contra: Histórico de um endereço só por varredura completa do disco
+ * 
+ * Registros de desfazer: anel com os últimos 1024 blocos
+ *    - Pro: Desconecta o topo em O(profundidade) para reorganizações
+ *    - Contra: ~32 bytes por bloco do anel
+ * 
+ * Contas v2 (formato de contas largas): vetor denso paginado + conjunto com saldo
+ *    - Pro: Saldo de qualquer conta em O(1); relatórios custam O(contas com saldo)
+ *    - Contra: 12 bytes por conta das páginas tocadas (4096 contas por página)
+ * 
+ * Arquivo de cabeçalhos (.hdr): 136 bytes por bloco
+ *    - Pro: Verificação da cadeia sem ler os 184 bytes de dados
+ *    - Contra: Uma escrita extra por flush e 53% a mais de disco
+ * 
+ * Leitura concorrente com a mineração (um escritor, vários leitores)
+ *    - Seqlock: saldos, contadores, recordes, filtro e buffer de escrita
+ *    - RCU: páginas da tabela de metadados e cabeças da tabela de nonces
+ *      são publicadas com release e a memória antiga só é liberada sem leitores
+ *    - Trava de índices: histórico, checkpoints, ranking e índice por hash
+ *      mudam no lugar; suas consultas seguram a trava e atrasam o escritor
  */
 
+#define _FILE_OFFSET_BITS 64    // Offsets de 64 bits também em plataformas 32 bits (100M blocos = 25 GB)
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
+#include <pthread.h>
 #include <openssl/sha.h>
 #include "storage.h"
 #include "structs.h"
+#include "miner.h"
+#include "headers.h"
+#include "historico.h"
+#include "checkpoint.h"
+#include "ranking.h"
+#include "sincronizacao.h"
+#include "bloom.h"
+#include "hashindex.h"
+#include "contadores.h"
+#include "rastreamento.h"
+#include "metadados.h"
+#include "ledger.h"
+#include "formato.h"
+#include "contas.h"
+#include "execucao.h"
+#include "merkle.h"
 
 // CONSTANTES -> Uso de Static como "private" do arquivo
 
 #define READ_LOTE 256       // Quantidade de blocos lidos por vez do disco
 #define BUFFER_SIZE 16      // Blocos em memória antes de flush no disco
+#define TAM_NOME_ARQUIVO 256
+#define LOTE_RELATORIO 64   // Blocos lidos por vez ao percorrer relatórios
 
 // Hash Table de Nonces (2^14 = 16384 slots)
 #define HASH_BITS 14
@@ -36,139 +104,290 @@
 #define SHIFT_AMOUNT (32 - HASH_BITS)
 #define KNUTH_CONST 2654435761u  // Constante de Knuth para hash multiplicativo
 
+// Filtro de Bloom de Nonces
+#define BLOOM_CAPACIDADE_INICIAL 32768  // Nonces previstos (dobra quando lota)
+#define BLOOM_TAXA_PADRAO 0.01          // 1% de falso positivo
+
 // Estrutura do Bloco
 #define MINERADOR_OFFSET 183    // Posição fixa do minerador no vetor data
 #define TRANSACAO_SIZE 3        // Cada transação = 3 bytes (origem, destino, valor)
 #define MAX_TRANSACOES 61       // Máximo de transações por bloco
 #define NUM_ENDERECOS 256       // Total de endereços possíveis (0-255)
 
-// Cache de contagem 
-#define CACHE_INICIAL 1000      // Capacidade inicial do cache
-#define CACHE_CRESCIMENTO 2     // Fator de crescimento quando cheio
+// Desfazer (reorganização)
+#define PROFUNDIDADE_MAX_REORG 1024 // Blocos do topo que podem ser desconectados
 
 // ESTRUTURAS AUXILIARES
 
+/**
+ * Tudo que é preciso para desconectar um bloco do topo sem reconstruir os índices.
+ * As transações aplicadas ficam em 'txValidas' (bit i = slot i) e são
+ * revertidas relendo o próprio bloco; o valor transferido está na tabela de metadados.
+ */
+typedef struct {
+    unsigned int idBloco;
+    unsigned long long txValidas;        // Slots cujas transações foram aplicadas
+    unsigned int maiorQtdMineradaAnterior;
+    int maxAnterior, minAnterior;        // Recordes antes do bloco
+} RegistroDesfazer;
+
 // VARIÁVEIS GLOBAIS 
 
-static NoHash *tabelaNonce[TAM_HASH];               // Hash table para busca por nonce O(1)
-static NoMinerador *indiceMinerador[NUM_ENDERECOS]; // Início de cada lista de minerador
-static NoMinerador *fimMinerador[NUM_ENDERECOS];    // Fim de cada lista (inserção O(1))
+static unsigned int tabelaNonce[TAM_HASH];         // Último bloco de cada slot (0 = vazio); o resto via proxNonce
+static FiltroBloom filtroNonce;                     // Rejeita nonces ausentes antes da tabela
+static double taxaFalsoPositivoNonce = BLOOM_TAXA_PADRAO;
+static unsigned long long consultasNonce = 0;       // Buscas por nonce
+static unsigned long long rejeitadasBloom = 0;      // Resolvidas só pelo filtro
+static unsigned long long falsosPositivosBloom = 0; // Filtro disse "talvez" e a lista não tinha
 
 static unsigned int saldos[NUM_ENDERECOS];          // Saldo atual de cada carteira
 static unsigned int blocosMinerados[NUM_ENDERECOS]; // Contador de blocos por minerador
 static unsigned long long totalValorTransacionado = 0; // Soma de todos os valores (para média)
 
-static unsigned int maiorSaldoAtual = 0;            // Cache do maior saldo
 static unsigned int maiorQtdMinerada = 0;           // Cache da maior qtd minerada
 
 static int maxTransacoesGlobal = -1;                // Recorde de MAX transações 
-static NoRecorde *listaMaxTx = NULL;                // Lista de blocos com MAX transações
-static int minTransacoesGlobal = 1000;              // Recorde de MIN transações 
-static NoRecorde *listaMinTx = NULL;                // Lista de blocos com MIN transações
+static int minTransacoesGlobal = 1000;              // Recorde de MIN transações (sem o gênesis)
 
 static FILE *arquivoAtual = NULL;
+static FILE *arquivoCabecalhos = NULL;
+static char nomeArquivoBin[TAM_NOME_ARQUIVO];
+static char nomeArquivoHdr[TAM_NOME_ARQUIVO];
+static char nomeArquivoTxt[TAM_NOME_ARQUIVO];
+static char nomeArquivoIdx[TAM_NOME_ARQUIVO];
+static int indiceHashCarregado = 0;     // 1 = .idx lido do disco, não precisa reinserir
+static int indiceHashAlterado = 0;      // Índice por hash mudou desde a última carga ou gravação do .idx
+static unsigned long long versaoCadeia = 0;         // Muda a cada bloco conectado ou desconectado (__atomic_*)
+static unsigned long long versaoExportada = ~0ULL;  // Versão que o .txt no disco descreve (__atomic_*)
+static unsigned long long truncamentosDisco = 0;    // Muda a cada truncamento do .bin/.hdr na reorganização (__atomic_*)
+static int exportacaoCancelada = 0;     // Encerramento rápido pediu para abandonar a exportação (__atomic_*)
 static BlocoMinerado buffer[BUFFER_SIZE];
 static int contadorBuffer = 0;
 static Estatisticas stats;
 
-static unsigned char *cacheContagemTx = NULL;  
-static unsigned int cacheTamanho = 0;           
-static unsigned int cacheCapacidade = 0;        
+static int modoCadeiaGrande = 0;        // Sem histórico por endereço e sem exportar texto
+static int reconstruindoIndices = 0;    // Ranking e ledger versionado são montados uma vez, no fim
+static unsigned int contasPedidas = 0;  // Formato de uma cadeia nova (0 = v1)
+static unsigned int contasV2 = 0;       // Contas da cadeia aberta (0 = formato v1, endereços de 1 byte)
+static int validacaoParalela = 0;       // Validade das transações pela execução otimista (pool de execucao.c)
+
+static RegistroDesfazer registrosDesfazer[PROFUNDIDADE_MAX_REORG]; // Anel indexado por (id - 1) % P
+static unsigned int qtdDesfazer = 0;                               // Registros válidos no topo
+
+static pthread_mutex_t travaIndices = PTHREAD_MUTEX_INITIALIZER;   // Escritor + consultas a índices mutáveis
+static Seqlock seqEstado;                                          // Estatísticas, recordes, filtro e buffer
 
 // PROTÓTIPOS INTERNOS
 static int lerBlocoPorId(unsigned int id, BlocoMinerado *saida);
-static void liberarListaRecorde(NoRecorde **lista);
-static void adicionarRecorde(NoRecorde **lista, unsigned int idBloco);
-static void expandirCacheTx();
-static void adicionarAoCache(unsigned int idBloco, unsigned char qtdTx);
 void imprimirBlocoCompleto(BlocoMinerado *b);
 
 // FUNÇÕES AUXILIARES
 
-// Libera todos os nós de uma lista de recordes
-static void liberarListaRecorde(NoRecorde **lista) 
+// Contagem de transações lida da tabela de metadados (0 para bloco inexistente)
+static unsigned char obterContagemTx(unsigned int idBloco) 
 {
-    NoRecorde *atual = *lista;
+    if (idBloco == 0 || idBloco > metadadosQuantidade())
+    {
+        contadorSomar(CONTADOR_CACHE_TX_FALHAS, 1);
+        return 0;
+    }
+    contadorSomar(CONTADOR_CACHE_TX_ACERTOS, 1);
+
+    rcuLeituraInicio();
+    unsigned char qtd = metadadosPagina(idBloco)->qtdTx[metadadosPosicao(idBloco)];
+    rcuLeituraFim();
+    return qtd;
+}
+
+/**
+ * Varre a coluna de contagem de 'ultimo' até 'primeiro' (do mais recente ao
+ * mais antigo) atrás dos blocos com exatamente 'qtdTx' transações.
+ * Copia até 'maxIds' IDs e retorna o total encontrado.
+ */
+static unsigned int varrerContagem(unsigned int primeiro, unsigned int ultimo, int qtdTx, unsigned int *ids, unsigned int maxIds) 
+{
+    unsigned int total = 0;
 
-    while (atual != NULL) 
+    if (primeiro == 0 || qtdTx < 0 || qtdTx > MAX_TRANSACOES) 
+        return 0;
+
+    rcuLeituraInicio();
+    unsigned int id = ultimo;
+    while (id >= primeiro) 
     {
-        NoRecorde *temp = atual;
-        atual = atual->prox;
-        free(temp);
+        // Uma página por vez: o laço interno só toca bytes vizinhos
+        PaginaMetadados *pagina = metadadosPagina(id);
+        unsigned int inicioPagina = id - metadadosPosicao(id);
+        unsigned int parada = inicioPagina > primeiro ? inicioPagina : primeiro;
+
+        for (; id >= parada; id--) 
+        {
+            if (pagina->qtdTx[id - inicioPagina] == qtdTx) 
+            {
+                if (total < maxIds) ids[total] = id;
+                total++;
+            }
+        }
     }
-    *lista = NULL;
+    rcuLeituraFim();
+    return total;
+}
+
+int contagemTransacoes(unsigned int idBloco) 
+{
+    return obterContagemTx(idBloco);
 }
 
-// Adiciona um bloco à lista de recordes (inserção no início = O(1))
-static void adicionarRecorde(NoRecorde **lista, unsigned int idBloco) 
+// CONTAGEM E ESTATÍSTICAS
+
+
+// Abre o registro de desfazer do bloco; no anel cheio, descarta o mais antigo
+static RegistroDesfazer *novoRegistroDesfazer(unsigned int idBloco) 
 {
-    NoRecorde *novo = verifica_malloc(sizeof(NoRecorde), "adicionarRecorde");
+    RegistroDesfazer *r = &registrosDesfazer[(idBloco - 1) % PROFUNDIDADE_MAX_REORG];
+
+    if (qtdDesfazer < PROFUNDIDADE_MAX_REORG) 
+        qtdDesfazer++;
 
-    novo->idBloco = idBloco;
-    novo->prox = *lista;
-    *lista = novo;
+    memset(r, 0, sizeof(*r));
+    r->idBloco = idBloco;
+    return r;
 }
 
-// Expande o cache quando necessário
-static void expandirCacheTx() 
+// Contagem e valor na tabela de metadados e recordes de transações (os dois formatos)
+static void registrarContagemBloco(unsigned int idBloco, RegistroDesfazer *desfazer, int txNoBloco, unsigned long long valorBloco)
 {
-    unsigned int novaCapacidade = cacheCapacidade == 0 ? CACHE_INICIAL : cacheCapacidade * CACHE_CRESCIMENTO;
+    // O bloco fica visível em conectarAosIndices; o valor satura na coluna de 16 bits
+    PaginaMetadados *pagina = metadadosPagina(idBloco);
+    pagina->qtdTx[metadadosPosicao(idBloco)] = (unsigned char)txNoBloco;
+    pagina->valor[metadadosPosicao(idBloco)] = (unsigned short)(valorBloco > 0xFFFF ? 0xFFFF : valorBloco);
     
-    unsigned char *novoCache = realloc(cacheContagemTx, novaCapacidade * sizeof(unsigned char));
+    // Recordes: só o valor muda; os empatados são achados na coluna de contagem
+    desfazer->maxAnterior = maxTransacoesGlobal;
+    desfazer->minAnterior = minTransacoesGlobal;
+    if (txNoBloco > maxTransacoesGlobal) 
+        maxTransacoesGlobal = txNoBloco;
+    if (idBloco > 1 && txNoBloco < minTransacoesGlobal) 
+        minTransacoesGlobal = txNoBloco;
+}
 
-    if (!novoCache) 
-    {
-        fprintf(stderr, "Erro ao expandir cache de transações\n");
-        exit(1);
-    }
-    
-    // Inicializa novas posições com 0
-    memset(novoCache + cacheCapacidade, 0, (novaCapacidade - cacheCapacidade) * sizeof(unsigned char));
-    
-    cacheContagemTx = novoCache;
-    cacheCapacidade = novaCapacidade;
+static unsigned int saldoDoVetor(unsigned int conta, void *contexto) 
+{
+    return ((unsigned int *)contexto)[conta];
 }
 
-// Adiciona contagem no cache
-static void adicionarAoCache(unsigned int idBloco, unsigned char qtdTx) 
+static unsigned int saldoDaConta(unsigned int conta, void *contexto) 
 {
-    // Expande se necessário
-    while (idBloco > cacheCapacidade)
-        expandirCacheTx();
-    
-    cacheContagemTx[idBloco - 1] = qtdTx;
-    if (idBloco > cacheTamanho) 
-        cacheTamanho = idBloco;
+    (void)contexto;
+    return contasSaldo(conta);
 }
 
-// Pega contagem do cache
-static unsigned char obterContagemDoCache(unsigned int idBloco) 
+/**
+ * Validade de cada slot do bloco pela execução otimista, sobre os saldos
+ * já com a recompensa. Retorna 0 se a validação paralela está desligada
+ * (cada transação é conferida em série, no laço de aplicação).
+ */
+static int validarEmParalelo(BlocoMinerado *b, unsigned long long *validasPorSlot) 
 {
-    if (idBloco == 0 || idBloco > cacheTamanho)
+    if (!validacaoParalela || b->bloco.numero <= 1) 
         return 0;
-    return cacheContagemTx[idBloco - 1];
+
+    int v2 = contasV2 != 0;
+    TransacaoConta txs[EXECUCAO_MAX_TX];
+    unsigned char slots[EXECUCAO_MAX_TX];
+    int qtd = 0;
+
+    for (int slot = 0; slot < formatoMaxTransacoes(v2); slot++) 
+    {
+        int tipo = formatoLerTransacao(b->bloco.data, v2, slot, &txs[qtd]);
+        if (tipo < 0) break;
+        if (tipo > 0) slots[qtd++] = (unsigned char)slot;
+    }
+
+    ResultadoExecucao res;
+    executarOtimista(txs, qtd, v2 ? contasV2 : NUM_ENDERECOS, v2 ? saldoDaConta : saldoDoVetor, saldos, &res);
+
+    *validasPorSlot = 0;
+    for (int i = 0; i < qtd; i++) 
+    {
+        if (res.validas & (1ULL << i)) 
+            *validasPorSlot |= 1ULL << slots[i];
+    }
+    return 1;
 }
 
-// CONTAGEM E ESTATÍSTICAS
+/**
+ * Bloco no formato v2: recompensa e transferências sobre o estado de contas.
+ * Ranking, histórico, checkpoints e ledger versionado são índices dos 256
+ * endereços do formato v1 e não entram aqui.
+ */
+static void atualizarEstatisticasContas(BlocoMinerado *b, RegistroDesfazer *desfazer)
+{
+    unsigned int minerador = formatoMinerador(b->bloco.data, 1);
+    unsigned long long valorBloco = 0;
+    int txNoBloco = 0;
+
+    contasCreditar(minerador, 50);
+    desfazer->maiorQtdMineradaAnterior = maiorQtdMinerada;
+    unsigned int minerados = contasSomarMinerado(minerador, 1);
+    if (minerados > maiorQtdMinerada) 
+        maiorQtdMinerada = minerados;
+
+    unsigned long long validas;
+    int paralela = validarEmParalelo(b, &validas);
+
+    TransacaoConta tx;
+    for (int slot = 0; b->bloco.numero > 1 && slot < V2_MAX_TRANSACOES; slot++) 
+    {
+        if (formatoLerTransacao(b->bloco.data, 1, slot, &tx) < 0) 
+            break;
+        int valida = paralela ? (int)((validas >> slot) & 1) : tx.destino < contasV2 && contasSaldo(tx.origem) >= tx.valor;
+        if (!valida) 
+        {
+            fprintf(stderr, "AVISO: Tx inválida no bloco %u (conta %u tem %u, tentou %u para %u)\n", b->bloco.numero, tx.origem, contasSaldo(tx.origem), tx.valor, tx.destino);
+            continue;
+        }
+        contasDebitar(tx.origem, tx.valor);
+        contasCreditar(tx.destino, tx.valor);
+        totalValorTransacionado += tx.valor;
+        valorBloco += tx.valor;
+        txNoBloco++;
+        desfazer->txValidas |= 1ULL << slot;
+    }
 
+    registrarContagemBloco(b->bloco.numero, desfazer, txNoBloco, valorBloco);
+}
 
 // Atualiza todas as estatísticas quando um bloco entra no sistema
-static void atualizarEstatisticasGlobais(BlocoMinerado *b)
+static void atualizarEstatisticasGlobais(BlocoMinerado *b, RegistroDesfazer *desfazer)
 {
+    if (contasV2) 
+    {
+        atualizarEstatisticasContas(b, desfazer);
+        return;
+    }
+
     unsigned char minerador = b->bloco.data[MINERADOR_OFFSET];
+    unsigned int valorBloco = 0;
     
+    // Endereços com saldo alterado neste bloco (atualizados no ranking no final)
+    unsigned char alterados[1 + 2 * MAX_TRANSACOES];
+    int qtdAlterados = 0;
+
     // Recompensa do minerador (+50 BTC)
     saldos[minerador] += 50;
     blocosMinerados[minerador]++;
+    alterados[qtdAlterados++] = minerador;
     
-    // Atualiza caches de máximos
-    if (saldos[minerador] > maiorSaldoAtual) 
-        maiorSaldoAtual = saldos[minerador];
+    // Atualiza cache de máximo minerado
+    desfazer->maiorQtdMineradaAnterior = maiorQtdMinerada;
     if (blocosMinerados[minerador] > maiorQtdMinerada) 
         maiorQtdMinerada = blocosMinerados[minerador];
 
-    // Processa transações
+    // Processa transações (a validade pode vir da execução otimista; a aplicação é sempre em ordem)
     int txNoBloco = 0;
+    unsigned long long validas;
+    int paralela = validarEmParalelo(b, &validas);
     if (b->bloco.numero > 1) 
     {
         for (int i = 0; i < MINERADOR_OFFSET; i += TRANSACAO_SIZE) 
@@ -179,12 +398,22 @@ static void atualizarEstatisticasGlobais(BlocoMinerado *b)
 
             if (valor > 0) 
             {
-                if (saldos[origem] >= valor) 
+                if (paralela ? (validas >> (i / TRANSACAO_SIZE)) & 1 : saldos[origem] >= valor) 
                 {
                     saldos[origem] -= valor;
                     saldos[destino] += valor;
                     totalValorTransacionado += valor;
                     txNoBloco++;
+                    alterados[qtdAlterados++] = origem;
+                    alterados[qtdAlterados++] = destino;
+                    desfazer->txValidas |= 1ULL << (i / TRANSACAO_SIZE);
+                    valorBloco += valor;
+
+                    if (!modoCadeiaGrande) 
+                    {
+                        historicoRegistrar(origem, b->bloco.numero, (unsigned char)(i / TRANSACAO_SIZE), DIRECAO_SAIDA);
+                        historicoRegistrar(destino, b->bloco.numero, (unsigned char)(i / TRANSACAO_SIZE), DIRECAO_ENTRADA);
+                    }
                 } 
                 else 
                     fprintf(stderr, "AVISO: Tx inválida no bloco %u (origem %d tem %u, tentou %u)\n", b->bloco.numero, origem, saldos[origem], valor);
@@ -194,31 +423,23 @@ static void atualizarEstatisticasGlobais(BlocoMinerado *b)
         }
     }
     
-    // Armazena contagem no cache
-    adicionarAoCache(b->bloco.numero, (unsigned char)txNoBloco);
-    
-    // Atualiza recordes de MAX transações
-    if (txNoBloco > maxTransacoesGlobal) 
-    {
-        liberarListaRecorde(&listaMaxTx);
-        maxTransacoesGlobal = txNoBloco;
-        adicionarRecorde(&listaMaxTx, b->bloco.numero);
-    } 
-    else if (txNoBloco == maxTransacoesGlobal && maxTransacoesGlobal >= 0) 
-        adicionarRecorde(&listaMaxTx, b->bloco.numero);
-    
-    // Atualiza recordes de MIN transações 
-    if (b->bloco.numero > 1) 
+    // Reposiciona no ranking só quem mudou (repetidos são ignorados pelo ranking).
+    // Na reconstrução o ranking é montado uma vez, no fim, a partir dos saldos
+    if (!reconstruindoIndices) 
     {
-        if (txNoBloco < minTransacoesGlobal) 
-        {
-            liberarListaRecorde(&listaMinTx);
-            minTransacoesGlobal = txNoBloco;
-            adicionarRecorde(&listaMinTx, b->bloco.numero);
-        } 
-        else if (txNoBloco == minTransacoesGlobal) 
-            adicionarRecorde(&listaMinTx, b->bloco.numero);
+        for (int i = 0; i < qtdAlterados; i++) 
+            rankingAtualizar(alterados[i], saldos[alterados[i]]);
     }
+
+    // Nova versão do ledger: copia só as páginas desses endereços
+    if (!reconstruindoIndices) 
+        ledgerPublicar(alterados, qtdAlterados, saldos, b->bloco.numero);
+
+    registrarContagemBloco(b->bloco.numero, desfazer, txNoBloco, valorBloco);
+
+    // Checkpoint de saldos a cada K blocos
+    if (b->bloco.numero % INTERVALO_CHECKPOINT == 0) 
+        checkpointRegistrar(saldos);
 }
 
 // FUNÇÕES DE HASH TABLE E ÍNDICES
@@ -228,180 +449,322 @@ static unsigned int hashFunction(unsigned int nonce)
     return (nonce * KNUTH_CONST) >> SHIFT_AMOUNT;
 }
 
-static void inserirNonce(unsigned int nonce, unsigned int idBloco) 
+// Recria o filtro com nova capacidade/taxa a partir dos nonces já na tabela
+static void reconstruirFiltroNonce(unsigned int capacidade) 
+{
+    // Bits antigos só são liberados quando nenhuma consulta os estiver lendo
+    rcuAposentar(filtroNonce.bits);
+    filtroNonce.bits = NULL;
+    bloomCriar(&filtroNonce, capacidade, taxaFalsoPositivoNonce);
+
+    for (int i = 0; i < TAM_HASH; i++) 
+    {
+        for (unsigned int id = tabelaNonce[i]; id != 0; ) 
+        {
+            PaginaMetadados *pagina = metadadosPagina(id);
+            bloomInserir(&filtroNonce, pagina->nonce[metadadosPosicao(id)]);
+            id = pagina->proxNonce[metadadosPosicao(id)];
+        }
+    }
+}
+
+// Sem trava: só o escritor insere. O bloco entra na frente do slot, então proxNonce sempre aponta para um ID menor
+static void inserirNonce(PaginaMetadados *pagina, unsigned int nonce, unsigned int idBloco) 
 {
     unsigned int pos = hashFunction(nonce);
-    NoHash *novo = verifica_malloc(sizeof(NoHash), "inserirNonce");
-    novo->nonce = nonce;
-    novo->idBloco = idBloco;
-    novo->prox = tabelaNonce[pos];
-    tabelaNonce[pos] = novo;
+    pagina->nonce[metadadosPosicao(idBloco)] = nonce;
+    pagina->proxNonce[metadadosPosicao(idBloco)] = tabelaNonce[pos];
+    __atomic_store_n(&tabelaNonce[pos], idBloco, __ATOMIC_RELEASE);
+
+    // Filtro lotado: dobra a capacidade para manter a taxa de falso positivo
+    if (filtroNonce.elementos >= filtroNonce.capacidade) 
+        reconstruirFiltroNonce(filtroNonce.capacidade * 2);
+    bloomInserir(&filtroNonce, nonce);
 }
 
-static void inserirMinerador(unsigned char endereco, unsigned int idBloco) 
+// Caminho único de entrada de um bloco nos índices (mineração e carga do disco)
+static void conectarAosIndices(BlocoMinerado *b, unsigned int idBloco, int inserirHash) 
 {
-    NoMinerador *novo = verifica_malloc(sizeof(NoMinerador), "inserirMinerador");
-    novo->idBloco = idBloco;
-    novo->prox = NULL;
+    RegistroDesfazer *desfazer = novoRegistroDesfazer(idBloco);
+    PaginaMetadados *pagina = metadadosReservar(idBloco);
+    unsigned int pos = metadadosPosicao(idBloco);
+
+    unsigned long long t0 = rastroInicio();
+    pagina->minerador[pos] = (unsigned char)formatoMinerador(b->bloco.data, contasV2 != 0);   // No v2, byte baixo (pré-filtro)
+    pagina->prefixoHash[pos] = prefixoDoHash(b->hash);
+    inserirNonce(pagina, b->bloco.nonce, idBloco);
+    if (inserirHash) 
+    {
+        indiceHashInserir(pagina->prefixoHash[pos], idBloco);
+        indiceHashAlterado = 1;
+    }
+    rastroFim("indices", "storage", t0);
 
-    if (indiceMinerador[endereco] == NULL)
-        indiceMinerador[endereco] = novo;
-    else 
-        fimMinerador[endereco]->prox = novo;
-    
-    fimMinerador[endereco] = novo;
+    t0 = rastroInicio();
+    atualizarEstatisticasGlobais(b, desfazer);
+    rastroFim("ledger", "storage", t0);
+
+    // Colunas completas: o bloco passa a valer para as varreduras
+    metadadosPublicar(idBloco);
 }
 
 
 // FUNÇÕES DE ARQUIVO
 
+// Troca a extensão de 'base' (ex: blockchain.bin -> blockchain.hdr)
+static void derivarNomeArquivo(const char *base, const char *extensao, char *saida)
+{
+    snprintf(saida, TAM_NOME_ARQUIVO, "%s", base);
+    char *ponto = strrchr(saida, '.');
+    if (ponto != NULL && strchr(ponto, '/') == NULL)
+        *ponto = '\0';
+    strncat(saida, extensao, TAM_NOME_ARQUIVO - strlen(saida) - 1);
+}
+
+static void escreverCabecalhos(BlocoMinerado *blocos, int qtd)
+{
+    CabecalhoBloco cabecalhos[BUFFER_SIZE];
+
+    for (int i = 0; i < qtd; i++)
+        montarCabecalho(&blocos[i], contasV2 != 0, &cabecalhos[i]);
+
+    fseeko(arquivoCabecalhos, 0, SEEK_END);
+    fwrite(cabecalhos, sizeof(CabecalhoBloco), qtd, arquivoCabecalhos);
+    contadorSomar(CONTADOR_CHAMADAS_FWRITE, 1);
+    contadorSomar(CONTADOR_BYTES_ESCRITOS, (unsigned long long)qtd * sizeof(CabecalhoBloco));
+}
+
 static void flushBuffer() {
     if (contadorBuffer > 0 && arquivoAtual != NULL) 
     {
-        fseek(arquivoAtual, 0, SEEK_END);
+        unsigned long long t0 = rastroInicio();
+        fseeko(arquivoAtual, 0, SEEK_END);
         fwrite(buffer, sizeof(BlocoMinerado), contadorBuffer, arquivoAtual);
         fflush(arquivoAtual);
+        contadorSomar(CONTADOR_FLUSHES_BUFFER, 1);
+        contadorSomar(CONTADOR_CHAMADAS_FWRITE, 1);
+        contadorSomar(CONTADOR_BYTES_ESCRITOS, (unsigned long long)contadorBuffer * sizeof(BlocoMinerado));
+
+        // Cabeçalhos só depois dos blocos: o .hdr nunca fica à frente do .bin
+        if (arquivoCabecalhos != NULL) 
+        {
+            escreverCabecalhos(buffer, contadorBuffer);
+            fflush(arquivoCabecalhos);
+        }
         contadorBuffer = 0;
+        rastroFim("flushBuffer", "io", t0);
     }
 }
 
-static int lerBlocoPorId(unsigned int id, BlocoMinerado *saida) {
-
-    if (id < 1 || id > stats.totalBlocos) 
-        return 0;
-    
-    unsigned int blocosPersistidos = stats.totalBlocos - contadorBuffer;
+// Leitura posicional de 'qtd' blocos consecutivos já persistidos (uma chamada pread por trecho)
+static int lerTrechoDoDisco(unsigned int inicio, unsigned int qtd, BlocoMinerado *saida) 
+{
+    size_t restante = (size_t)qtd * sizeof(BlocoMinerado);
+    off_t offset = (off_t)(inicio - 1) * sizeof(BlocoMinerado);
+    char *destino = (char *)saida;
 
-    if (id > blocosPersistidos) 
+    while (restante > 0) 
     {
-        *saida = buffer[id - blocosPersistidos - 1];
-        return 1;
+        ssize_t lidos = pread(fileno(arquivoAtual), destino, restante, offset);
+        contadorSomar(CONTADOR_CHAMADAS_PREAD, 1);
+        if (lidos <= 0) 
+            return 0;
+        contadorSomar(CONTADOR_BYTES_LIDOS, (unsigned long long)lidos);
+        destino += lidos;
+        offset += lidos;
+        restante -= (size_t)lidos;
     }
-    
-    long offset = (long)(id - 1) * sizeof(BlocoMinerado);
+    return 1;
+}
 
-    if (fseek(arquivoAtual, offset, SEEK_SET) != 0) 
-        return 0;
-    if (fread(saida, sizeof(BlocoMinerado), 1, arquivoAtual) != 1) 
-        return 0;
+static int lerBlocoPorId(unsigned int id, BlocoMinerado *saida) {
+    return lerIntervaloBlocos(id, id, saida) == 1;
+}
 
+// Cabeçalho já gravado no .hdr (só blocos persistidos)
+static int lerCabecalhoDoDisco(unsigned int id, CabecalhoBloco *saida) 
+{
+    off_t offset = (off_t)(id - 1) * sizeof(CabecalhoBloco);
+    ssize_t lidos = pread(fileno(arquivoCabecalhos), saida, sizeof(CabecalhoBloco), offset);
+    contadorSomar(CONTADOR_CHAMADAS_PREAD, 1);
+    if (lidos != (ssize_t)sizeof(CabecalhoBloco)) 
+        return 0;
+    contadorSomar(CONTADOR_BYTES_LIDOS, sizeof(CabecalhoBloco));
     return 1;
 }
 
+// Quantidade de registros de 'tamanhoRegistro' bytes em um arquivo aberto
+static unsigned int contarRegistros(FILE *arq, size_t tamanhoRegistro)
+{
+    fseeko(arq, 0, SEEK_END);
+    off_t tamanho = ftello(arq);
+    return tamanho < 0 ? 0 : (unsigned int)(tamanho / (off_t)tamanhoRegistro);
+}
+
 static void reconstruirIndicesDoDisco() 
 {
     BlocoMinerado lote[READ_LOTE];
     size_t blocosLidos;
     unsigned int idCalculado = 1;
 
+    // .hdr desatualizado (versão antiga ou queda entre as duas escritas): refaz junto
+    int refazerCabecalhos = contarRegistros(arquivoCabecalhos, sizeof(CabecalhoBloco)) != contarRegistros(arquivoAtual, sizeof(BlocoMinerado));
+    if (refazerCabecalhos) 
+    {
+        fclose(arquivoCabecalhos);
+        arquivoCabecalhos = fopen(nomeArquivoHdr, "wb+");
+        if (!arquivoCabecalhos) 
+        {
+            perror("Erro ao recriar arquivo de cabeçalhos");
+            exit(1);
+        }
+    }
+
     rewind(arquivoAtual);
+    reconstruindoIndices = 1;
+    unsigned long long tTotal = rastroInicio();
+    unsigned long long tLeitura = rastroInicio();
 
     while ((blocosLidos = fread(lote, sizeof(BlocoMinerado), READ_LOTE, arquivoAtual)) > 0) 
     {
+        rastroFim("fread", "io", tLeitura);
+        contadorSomar(CONTADOR_CHAMADAS_FREAD, 1);
+        contadorSomar(CONTADOR_BYTES_LIDOS, blocosLidos * sizeof(BlocoMinerado));
         for (size_t i = 0; i < blocosLidos; i++) 
         {
-            inserirNonce(lote[i].bloco.nonce, idCalculado);
-            inserirMinerador(lote[i].bloco.data[MINERADOR_OFFSET], idCalculado);
-            atualizarEstatisticasGlobais(&lote[i]);
+            conectarAosIndices(&lote[i], idCalculado, !indiceHashCarregado);
             stats.totalBlocos = idCalculado;
             idCalculado++;
         }
-    }
-    printf("Sistema restaurado: %u blocos. Saldo máximo: %u BTC.\n", stats.totalBlocos, maiorSaldoAtual);
-}
 
-static void resetarIndices() 
-{
-    // Limpa Hash Table de Nonces
-    for (int i = 0; i < TAM_HASH; i++) 
-    {
-        NoHash *atual = tabelaNonce[i];
-        while (atual != NULL) 
+        if (refazerCabecalhos) 
         {
-            NoHash *temp = atual;
-            atual = atual->prox;
-            free(temp);
+            for (size_t i = 0; i < blocosLidos; i += BUFFER_SIZE) 
+                escreverCabecalhos(&lote[i], blocosLidos - i < BUFFER_SIZE ? (int)(blocosLidos - i) : BUFFER_SIZE);
         }
-        tabelaNonce[i] = NULL;
+        tLeitura = rastroInicio();
     }
-    
-    // Limpa Índice de Mineradores
-    for (int i = 0; i < NUM_ENDERECOS; i++) 
+    reconstruindoIndices = 0;
+    if (!contasV2) 
+        rankingConstruir(saldos, NUM_ENDERECOS);
+    ledgerReiniciar(saldos, stats.totalBlocos);
+    rastroFim("reconstruirIndicesDoDisco", "storage", tTotal);
+
+    if (refazerCabecalhos) 
+    {
+        fflush(arquivoCabecalhos);
+        printf("Arquivo de cabeçalhos reconstruído (%s).\n", nomeArquivoHdr);
+    }
+    unsigned int saldoMaximo = 0;
+    if (contasV2) 
     {
-        NoMinerador *atual = indiceMinerador[i];
-        while (atual != NULL) 
+        for (unsigned int i = 0; i < contasComSaldo(); i++) 
         {
-            NoMinerador *temp = atual;
-            atual = atual->prox;
-            free(temp);
+            unsigned int saldo = contasSaldo(contasComSaldoEm(i));
+            if (saldo > saldoMaximo) saldoMaximo = saldo;
         }
-        indiceMinerador[i] = NULL;
-        fimMinerador[i] = NULL;
+        printf("Formato v2: %u contas, %u com saldo (%zu KB de estado).\n", contasV2, contasComSaldo(), contasMemoria() / 1024);
     }
+    else 
+        rankingKesimoMaior(1, &saldoMaximo);
+    printf("Sistema restaurado: %u blocos. Saldo máximo: %u BTC.\n", stats.totalBlocos, saldoMaximo);
+}
+
+static void resetarIndices() 
+{
+    // Esvazia a Hash Table de Nonces e a tabela de metadados (páginas só são liberadas sem leitores)
+    memset(tabelaNonce, 0, sizeof(tabelaNonce));
+    metadadosInicializar();
     
-    // Limpa listas de recordes
-    liberarListaRecorde(&listaMaxTx);
-    liberarListaRecorde(&listaMinTx);
-    
-    // Limpa cache de contagem
-    if (cacheContagemTx != NULL) 
-    {
-        free(cacheContagemTx);
-        cacheContagemTx = NULL;
-    }
-    cacheTamanho = 0;
-    cacheCapacidade = 0;
+    // Índice por hash vazio
+    indiceHashInicializar();
+    indiceHashCarregado = 0;
+    indiceHashAlterado = 0;
+
+    // Recria o filtro de nonces vazio
+    bloomLiberar(&filtroNonce);
+    bloomCriar(&filtroNonce, BLOOM_CAPACIDADE_INICIAL, taxaFalsoPositivoNonce);
+    consultasNonce = 0;
+    rejeitadasBloom = 0;
+    falsosPositivosBloom = 0;
+
+    // Limpa histórico por endereço e checkpoints de saldo
+    historicoLimpar();
+    checkpointLimpar();
+
+    // Limpa registros de desfazer
+    qtdDesfazer = 0;
     
     // Zera financeiro
     memset(saldos, 0, sizeof(saldos));
     memset(blocosMinerados, 0, sizeof(blocosMinerados));
     totalValorTransacionado = 0;
-    maiorSaldoAtual = 0;
+    contasInicializar(contasV2);
+    if (contasV2) 
+        rankingLimpar();
+    else 
+        rankingInicializar(NUM_ENDERECOS);
+    ledgerReiniciar(saldos, 0);
     maiorQtdMinerada = 0;
     maxTransacoesGlobal = -1;
     minTransacoesGlobal = 1000;
     
     stats.totalBlocos = 0;
     contadorBuffer = 0;
+
+    // Sem leitores ativos aqui: libera o que ficou aposentado
+    rcuSincronizar();
 }
 
-void exportarParaTexto(const char* nomeArquivoTxt) 
+/**
+ * Gera o relatório em texto da cadeia até a altura atual. Escreve num
+ * arquivo temporário e só renomeia no fim, então um encerramento no meio
+ * nunca deixa um .txt pela metade. Lê os blocos sem a trava (pode rodar em
+ * segundo plano com o menu ativo). Retorna 0 se falhou ou foi cancelada.
+ */
+int exportarParaTexto(const char* nomeArquivoTxt) 
 {
+    char nomeTemporario[TAM_NOME_ARQUIVO + 8];
+    snprintf(nomeTemporario, sizeof(nomeTemporario), "%s.tmp", nomeArquivoTxt);
+
     printf("Gerando arquivo de texto (%s)... ", nomeArquivoTxt);
-    
-    FILE *arqBin = fopen("blockchain.bin", "rb"); // Abre o binário atual
-    if (!arqBin) 
-    {
-        printf("Erro ao abrir binário para exportação.\n");
-        return;
-    }
+    unsigned long long t0 = rastroInicio();
 
-    FILE *arqTxt = fopen(nomeArquivoTxt, "w");
+    FILE *arqTxt = fopen(nomeTemporario, "w");
     if (!arqTxt) 
     {
         printf("Erro ao criar arquivo de texto.\n");
-        fclose(arqBin);
-        return;
+        return 0;
     }
 
     // Lê blocos em lotes de 100 para eficiência
     const int TAM_LOTE = 100;
     BlocoMinerado bufferLote[TAM_LOTE];
-    size_t lidos;
+    unsigned int lidos;
+    unsigned int proximo = 1;
+    unsigned int total = obterTotalBlocos();   // Blocos que chegarem durante a exportação ficam de fora
+    int cancelada = 0;
+    int v2 = contasV2 != 0;
 
     fprintf(arqTxt, "=== RELATÓRIO DA BLOCKCHAIN ===\n");
-    fprintf(arqTxt, "Total de Blocos: %u\n\n", stats.totalBlocos);
+    fprintf(arqTxt, "Total de Blocos: %u\n\n", total);
 
-    while ((lidos = fread(bufferLote, sizeof(BlocoMinerado), TAM_LOTE, arqBin)) > 0) 
+    while (proximo <= total && (lidos = lerIntervaloBlocos(proximo, proximo + TAM_LOTE - 1 < total ? proximo + TAM_LOTE - 1 : total, bufferLote)) > 0) 
     {
-        for (size_t i = 0; i < lidos; i++) 
+        if (__atomic_load_n(&exportacaoCancelada, __ATOMIC_ACQUIRE)) 
+        {
+            cancelada = 1;
+            break;
+        }
+        proximo += lidos;
+        for (unsigned int i = 0; i < lidos; i++) 
         {
             BlocoMinerado *b = &bufferLote[i];
             
             fprintf(arqTxt, "--------------------------------------------------\n");
             fprintf(arqTxt, "BLOCO %u\n", b->bloco.numero);
             fprintf(arqTxt, "Nonce: %u\n", b->bloco.nonce);
-            fprintf(arqTxt, "Minerador: %u\n", b->bloco.data[183]); 
+            fprintf(arqTxt, "Minerador: %u\n", formatoMinerador(b->bloco.data, v2));
             
             fprintf(arqTxt, "Hash: ");
             for(int k=0; k<32; k++) fprintf(arqTxt, "%02x", b->hash[k]);
@@ -413,27 +776,91 @@ void exportarParaTexto(const char* nomeArquivoTxt)
             else 
             {
                 fprintf(arqTxt, "Transações:\n");
-                for (int k = 0; k < 183; k += 3) 
+                TransacaoConta tx;
+                for (int slot = 0; slot < formatoMaxTransacoes(v2); slot++) 
                 {
-                    unsigned char origem = b->bloco.data[k];
-                    unsigned char destino = b->bloco.data[k+1];
-                    unsigned char valor = b->bloco.data[k+2];
-                    
-                    if (valor > 0) 
-                        fprintf(arqTxt, "   %d -> %d (%d BTC)\n", origem, destino, valor);
-                    else if (origem == 0 && destino == 0) 
+                    int tipo = formatoLerTransacao(b->bloco.data, v2, slot, &tx);
+                    if (tipo < 0) 
                         break; // Fim das transações
+                    if (tipo > 0) 
+                        fprintf(arqTxt, "   %u -> %u (%u BTC)\n", tx.origem, tx.destino, tx.valor);
                 }
             }
         }
     }
 
-    fclose(arqTxt);
-    fclose(arqBin);
+    int ok = fclose(arqTxt) == 0 && !cancelada && proximo > total;
+    if (!ok || rename(nomeTemporario, nomeArquivoTxt) != 0) 
+    {
+        remove(nomeTemporario);
+        rastroFim("exportarParaTexto", "io", t0);
+        printf("%s\n", cancelada ? "Cancelada." : "Erro ao gravar arquivo de texto.");
+        return 0;
+    }
+    rastroFim("exportarParaTexto", "io", t0);
     printf("Concluído!\n");
+    return 1;
+}
+
+/**
+ * Exporta o .txt da cadeia só se ele não descreve a versão atual (uma
+ * exportação em segundo plano ou de uma execução anterior já serve).
+ * Se um bloco entrar durante a exportação, o texto fica marcado como antigo.
+ */
+int exportarTextoDaCadeia() 
+{
+    if (modoCadeiaGrande) 
+        return 1;
+
+    unsigned long long versao = __atomic_load_n(&versaoCadeia, __ATOMIC_ACQUIRE);
+    if (versao == __atomic_load_n(&versaoExportada, __ATOMIC_ACQUIRE)) 
+        return 1;
+    if (!exportarParaTexto(nomeArquivoTxt)) 
+        return 0;
+    __atomic_store_n(&versaoExportada, versao, __ATOMIC_RELEASE);
+    return 1;
+}
+
+// O .txt no disco já descreve a cadeia carregada: mesmo total no cabeçalho e mesmo hash no último bloco
+static int textoEmDiaNoDisco() 
+{
+    char linha[128];
+    char cauda[8192 + 1];
+    char hexTopo[2 * SHA256_LEN + 1];
+    unsigned char hashTopo[SHA256_LEN];
+    unsigned int total = 0;
+
+    FILE *f = fopen(nomeArquivoTxt, "r");
+    if (f == NULL) 
+        return 0;
+    if (!fgets(linha, sizeof(linha), f) || fscanf(f, "Total de Blocos: %u", &total) != 1 || total != stats.totalBlocos || total == 0) 
+    {
+        fclose(f);
+        return 0;
+    }
+
+    // O último bloco ocupa no máximo ~1.5 KB no fim do arquivo
+    fseeko(f, 0, SEEK_END);
+    off_t tamanho = ftello(f);
+    off_t inicio = tamanho > (off_t)(sizeof(cauda) - 1) ? tamanho - (off_t)(sizeof(cauda) - 1) : 0;
+    fseeko(f, inicio, SEEK_SET);
+    size_t lidos = fread(cauda, 1, sizeof(cauda) - 1, f);
+    cauda[lidos] = '\0';
+    fclose(f);
+
+    char *ultimoHash = NULL;
+    for (char *p = strstr(cauda, "\nHash: "); p != NULL; p = strstr(p + 1, "\nHash: ")) 
+        ultimoHash = p + strlen("\nHash: ");
+    if (ultimoHash == NULL) 
+        return 0;
+
+    getUltimoHash(hashTopo);
+    for (int i = 0; i < SHA256_LEN; i++) 
+        snprintf(&hexTopo[2 * i], 3, "%02x", hashTopo[i]);
+    return strncmp(ultimoHash, hexTopo, 2 * SHA256_LEN) == 0;
 }
 
-static void imprimirListaRecordes(NoRecorde *lista, const char *titulo, int valor) 
+static void imprimirListaRecordes(unsigned int *ids, unsigned int qtd, const char *titulo, int valor) 
 {
     printf("\n--- %s ---\n", titulo);
     printf("Quantidade de transações: %d\n", valor);
@@ -441,11 +868,11 @@ static void imprimirListaRecordes(NoRecorde *lista, const char *titulo, int valo
     int totalEmpates = 0;
     BlocoMinerado temp;
     
-    for(NoRecorde *r = lista; r != NULL; r = r->prox) 
+    for(unsigned int i = 0; i < qtd; i++) 
     {
-        if (lerBlocoPorId(r->idBloco, &temp)) 
+        if (lerBlocoPorId(ids[i], &temp)) 
         {
-            printf("   - Bloco %u | Hash: ", r->idBloco);
+            printf("   - Bloco %u | Hash: ", ids[i]);
             for(int j = 0; j < 32; j++) printf("%02x", temp.hash[j]);
             printf("\n");
             totalEmpates++;
@@ -470,29 +897,169 @@ void *verifica_malloc(size_t tamanho, const char *contexto)
     return ptr;
 }
 
+// Tenta aproveitar o .idx salvo (só vale se bater com o total e o topo do .bin)
+static void carregarIndiceHash() 
+{
+    unsigned int total = contarRegistros(arquivoAtual, sizeof(BlocoMinerado));
+    BlocoMinerado topo;
+
+    if (total == 0 || !lerTrechoDoDisco(total, 1, &topo)) 
+        return;
+
+    indiceHashCarregado = indiceHashCarregar(nomeArquivoIdx, total, topo.hash);
+    if (indiceHashCarregado) 
+        printf("Índice de hashes carregado do disco (%s).\n", nomeArquivoIdx);
+}
+
+/**
+ * Modo cadeia grande (dezenas de milhões de blocos): desliga o histórico por
+ * endereço, único índice que cresce com o número de transações, e a
+ * exportação para texto no encerramento (~830 bytes por bloco). Chamar antes
+ * de inicializarStorage.
+ */
+void definirModoCadeiaGrande(int ativo) 
+{
+    modoCadeiaGrande = ativo;
+}
+
+/**
+ * Cadeias novas no formato v2 com 'qtdContas' contas (0 = formato v1).
+ * Chamar antes de inicializarStorage; uma cadeia existente segue o formato
+ * marcado no próprio gênesis.
+ */
+void definirContasV2(unsigned int qtdContas) 
+{
+    contasPedidas = qtdContas > CONTAS_MAXIMO ? CONTAS_MAXIMO : qtdContas;
+}
+
+/**
+ * Liga a validação das transações de cada bloco pela execução otimista com
+ * 'threads' threads (0 desliga). O resultado é o mesmo da validação em série.
+ */
+void definirValidacaoParalela(int threads) 
+{
+    pthread_mutex_lock(&travaIndices);
+    if (threads > 0) 
+        execucaoIniciar(threads);
+    else 
+        execucaoFinalizar();
+    validacaoParalela = threads > 0;
+    pthread_mutex_unlock(&travaIndices);
+}
+
+// Contas da cadeia aberta (0 = formato v1)
+unsigned int contasDaCadeia() 
+{
+    return contasV2;
+}
+
 void inicializarStorage(const char *nomeArquivo) 
 {
+    snprintf(nomeArquivoBin, TAM_NOME_ARQUIVO, "%s", nomeArquivo);
+    derivarNomeArquivo(nomeArquivo, ".hdr", nomeArquivoHdr);
+    derivarNomeArquivo(nomeArquivo, ".txt", nomeArquivoTxt);
+    derivarNomeArquivo(nomeArquivo, ".idx", nomeArquivoIdx);
+
     arquivoAtual = fopen(nomeArquivo, "rb+");
     if (arquivoAtual == NULL) 
     {
         arquivoAtual = fopen(nomeArquivo, "wb+");
-        if (!arquivoAtual) 
+        arquivoCabecalhos = fopen(nomeArquivoHdr, "wb+");
+        if (!arquivoAtual || !arquivoCabecalhos) 
         {
             perror("Erro ao abrir arquivo"); 
             exit(1);
         }    
+        contasV2 = contasPedidas;
         resetarIndices();
     } 
     else 
     {
+        arquivoCabecalhos = fopen(nomeArquivoHdr, "rb+");
+        if (arquivoCabecalhos == NULL)
+            arquivoCabecalhos = fopen(nomeArquivoHdr, "wb+");
+        if (!arquivoCabecalhos) 
+        {
+            perror("Erro ao abrir arquivo de cabeçalhos"); 
+            exit(1);
+        }
+        BlocoMinerado genesis;
+        contasV2 = lerTrechoDoDisco(1, 1, &genesis) ? formatoContasDoGenesis(genesis.bloco.data) : contasPedidas;
         resetarIndices();
+        carregarIndiceHash();
         reconstruirIndicesDoDisco();
     }
+
+    // Exportação interrompida por um encerramento rápido deixa só o temporário
+    char nomeTemporario[TAM_NOME_ARQUIVO + 8];
+    snprintf(nomeTemporario, sizeof(nomeTemporario), "%s.tmp", nomeArquivoTxt);
+    remove(nomeTemporario);
+    __atomic_store_n(&versaoExportada, textoEmDiaNoDisco() ? versaoCadeia : ~0ULL, __ATOMIC_RELEASE);
+}
+
+// Seção do escritor: exclui outros escritores e consultas com trava; leitores sem trava repetem a cópia
+static void escritaInicio() 
+{
+    pthread_mutex_lock(&travaIndices);
+    seqlockEscritaInicio(&seqEstado);
+}
+
+static void escritaFim() 
+{
+    seqlockEscritaFim(&seqEstado);
+    rcuSincronizar();
+    pthread_mutex_unlock(&travaIndices);
+}
+
+// Descarta os índices em memória e refaz tudo a partir do disco (mesmo caminho da inicialização)
+void recarregarIndicesDoDisco() 
+{
+    escritaInicio();
+    flushBuffer();
+    resetarIndices();
+    carregarIndiceHash();
+    reconstruirIndicesDoDisco();
+    escritaFim();
 }
 
 unsigned int getSaldo(unsigned char endereco) 
 {
-    return saldos[endereco];
+    return __atomic_load_n(&saldos[endereco], __ATOMIC_RELAXED);
+}
+
+// Saldo de uma conta em qualquer formato (0 fora do espaço de endereços)
+unsigned int getSaldoConta(unsigned int conta) 
+{
+    if (!contasV2) 
+        return conta < NUM_ENDERECOS ? getSaldo((unsigned char)conta) : 0;
+
+    rcuLeituraInicio();
+    unsigned int saldo = contasSaldo(conta);
+    rcuLeituraFim();
+    return saldo;
+}
+
+// Minerador do bloco no formato da cadeia aberta
+unsigned int mineradorDoBloco(const BlocoMinerado *b) 
+{
+    return formatoMinerador(b->bloco.data, contasV2 != 0);
+}
+
+// Cópia consistente das estatísticas (sem bloquear a mineração)
+void obterInstantaneo(InstantaneoEstatisticas *saida) 
+{
+    unsigned int seq;
+    do 
+    {
+        seq = seqlockLeituraInicio(&seqEstado);
+        saida->totalBlocos = stats.totalBlocos;
+        memcpy(saida->saldos, saldos, sizeof(saldos));
+        memcpy(saida->blocosMinerados, blocosMinerados, sizeof(blocosMinerados));
+        saida->maiorQtdMinerada = maiorQtdMinerada;
+        saida->totalValorTransacionado = totalValorTransacionado;
+        saida->maxTransacoes = maxTransacoesGlobal;
+        saida->minTransacoes = minTransacoesGlobal;
+    } while (seqlockLeituraRepetir(&seqEstado, seq));
 }
 
 void getUltimoHash(unsigned char *bufferHash) 
@@ -515,120 +1082,838 @@ void getUltimoHash(unsigned char *bufferHash)
 
 void adicionarBloco(BlocoMinerado *bloco) 
 {
+    unsigned long long t0 = rastroInicio();
+    escritaInicio();
     stats.totalBlocos++;
+    __atomic_store_n(&versaoCadeia, versaoCadeia + 1, __ATOMIC_RELEASE);
     
-    inserirNonce(bloco->bloco.nonce, stats.totalBlocos);
-    inserirMinerador(bloco->bloco.data[MINERADOR_OFFSET], stats.totalBlocos);
-    atualizarEstatisticasGlobais(bloco);
+    conectarAosIndices(bloco, stats.totalBlocos, 1);
 
     buffer[contadorBuffer] = *bloco;
     contadorBuffer++;
     if (contadorBuffer == BUFFER_SIZE) 
         flushBuffer();
+    escritaFim();
+    rastroFim("adicionarBloco", "storage", t0);
+}
+
+// Persiste o índice de hashes junto com o .hdr (o .idx carregado e intacto não é regravado)
+static void salvarIndiceHashSeAlterado() 
+{
+    if (!indiceHashAlterado || stats.totalBlocos == 0) 
+        return;
+
+    unsigned char hashTopo[SHA256_LEN];
+    getUltimoHash(hashTopo);
+    if (indiceHashSalvar(nomeArquivoIdx, stats.totalBlocos, hashTopo)) 
+        indiceHashAlterado = 0;
+    else 
+        fprintf(stderr, "AVISO: Não foi possível salvar %s\n", nomeArquivoIdx);
 }
 
 void finalizarStorage() 
 {
+    // A exportação lê blocos pelo seqlock, então só o flush fica na seção de escrita
+    pthread_mutex_lock(&travaIndices);
+    seqlockEscritaInicio(&seqEstado);
     flushBuffer();
+    seqlockEscritaFim(&seqEstado);
+
+    if (arquivoAtual) 
+        salvarIndiceHashSeAlterado();
 
-    // Fecha o arquivo binário ANTES de exportar para texto
+    // Exporta enquanto o binário ainda está aberto (leitura pelo intervalo)
     if (arquivoAtual) 
     {
+        exportarTextoDaCadeia();
         fclose(arquivoAtual);
         arquivoAtual = NULL;
     }
-
-    // Agora exporta (abre o binário novamente para leitura)
-    exportarParaTexto("blockchain.txt");
+    if (arquivoCabecalhos) 
+    {
+        fclose(arquivoCabecalhos);
+        arquivoCabecalhos = NULL;
+    }
     
+    seqlockEscritaInicio(&seqEstado);
     resetarIndices();
+    seqlockEscritaFim(&seqEstado);
+    pthread_mutex_unlock(&travaIndices);
 }
 
-unsigned int obterTotalBlocos() 
+/**
+ * Encerramento rápido (Ctrl+C): cancela a exportação em andamento, grava o
+ * buffer, faz fsync do .bin e do .hdr e regrava o .idx só se ele mudou. Não
+ * exporta texto nem libera os índices: a memória volta ao sistema de uma vez
+ * quando o processo sai. A trava de índices fica presa (nenhum escritor mexe
+ * no que foi persistido) e os arquivos continuam abertos para leitores em
+ * andamento, então o chamador deve sair logo em seguida com _exit.
+ */
+void finalizarStorageRapido() 
 {
-    return stats.totalBlocos;
-}
+    __atomic_store_n(&exportacaoCancelada, 1, __ATOMIC_RELEASE);
+    pthread_mutex_lock(&travaIndices);
 
-int buscarBlocoPorId(unsigned int id, BlocoMinerado *saida) 
-{
-    return lerBlocoPorId(id, saida);
+    // Encerramento normal já fechou tudo
+    if (arquivoAtual == NULL) 
+        return;
+
+    seqlockEscritaInicio(&seqEstado);
+    flushBuffer();
+    seqlockEscritaFim(&seqEstado);
+
+    if (fsync(fileno(arquivoAtual)) != 0) 
+        perror("Erro no fsync do arquivo de blocos");
+    if (arquivoCabecalhos != NULL && fsync(fileno(arquivoCabecalhos)) != 0) 
+        perror("Erro no fsync do arquivo de cabeçalhos");
+
+    salvarIndiceHashSeAlterado();
+}
+
+// DESCONEXÃO DO TOPO (REORGANIZAÇÃO)
+
+// Encurta o .bin e o .hdr para 'qtdBlocos' registros
+static void truncarArquivos(unsigned int qtdBlocos) 
+{
+    // Antes de encurtar: quem leu o disco sem trava confere o contador depois e repete
+    __atomic_add_fetch(&truncamentosDisco, 1, __ATOMIC_SEQ_CST);
+    fflush(arquivoAtual);
+    if (ftruncate(fileno(arquivoAtual), (off_t)qtdBlocos * sizeof(BlocoMinerado)) != 0) 
+        perror("Erro ao truncar arquivo de blocos");
+
+    if (arquivoCabecalhos != NULL) 
+    {
+        fflush(arquivoCabecalhos);
+        if (ftruncate(fileno(arquivoCabecalhos), (off_t)qtdBlocos * sizeof(CabecalhoBloco)) != 0) 
+            perror("Erro ao truncar arquivo de cabeçalhos");
+    }
+}
+
+// Reverte um bloco v1 nos saldos, ranking, histórico, ledger e checkpoints
+static void reverterBloco(BlocoMinerado *b, RegistroDesfazer *r, unsigned int id) 
+{
+    unsigned char minerador = b->bloco.data[MINERADOR_OFFSET];
+    unsigned char alterados[1 + 2 * MAX_TRANSACOES];
+    int qtdAlterados = 0;
+
+    // Reverte transações aplicadas, da última para a primeira
+    for (int slot = MAX_TRANSACOES - 1; slot >= 0; slot--) 
+    {
+        if (!(r->txValidas & (1ULL << slot))) 
+            continue;
+        unsigned char origem = b->bloco.data[slot * TRANSACAO_SIZE];
+        unsigned char destino = b->bloco.data[slot * TRANSACAO_SIZE + 1];
+        unsigned char valor = b->bloco.data[slot * TRANSACAO_SIZE + 2];
+
+        saldos[destino] -= valor;
+        saldos[origem] += valor;
+        alterados[qtdAlterados++] = origem;
+        alterados[qtdAlterados++] = destino;
+    }
+    saldos[minerador] -= 50;
+    blocosMinerados[minerador]--;
+    alterados[qtdAlterados++] = minerador;
+    totalValorTransacionado -= metadadosPagina(id)->valor[metadadosPosicao(id)];
+
+    for (int i = 0; i < qtdAlterados; i++) 
+    {
+        rankingAtualizar(alterados[i], saldos[alterados[i]]);
+        if (!modoCadeiaGrande) 
+            historicoRemoverBloco(alterados[i], id);
+    }
+    ledgerPublicar(alterados, qtdAlterados, saldos, id - 1);
+
+    if (id % INTERVALO_CHECKPOINT == 0) 
+        checkpointRemoverUltimo();
+}
+
+// Reverte um bloco v2 no estado de contas (o valor vem das transações: a coluna de 16 bits satura)
+static void reverterBlocoContas(BlocoMinerado *b, RegistroDesfazer *r) 
+{
+    TransacaoConta tx;
+    for (int slot = V2_MAX_TRANSACOES - 1; slot >= 0; slot--) 
+    {
+        if (!(r->txValidas & (1ULL << slot))) 
+            continue;
+        formatoLerTransacao(b->bloco.data, 1, slot, &tx);
+        contasDebitar(tx.destino, tx.valor);
+        contasCreditar(tx.origem, tx.valor);
+        totalValorTransacionado -= tx.valor;
+    }
+
+    unsigned int minerador = formatoMinerador(b->bloco.data, 1);
+    contasDebitar(minerador, 50);
+    contasSomarMinerado(minerador, -1);
+}
+
+/**
+ * Remove o bloco do topo de todos os índices usando o registro de desfazer,
+ * em O(transações do bloco). O bloco removido é copiado para 'removido'.
+ * Retorna 0 se não há registro (cadeia vazia ou além da profundidade máxima).
+ * O filtro de Bloom não remove chaves: o nonce fica só como falso positivo.
+ */
+int desconectarBlocoTopo(BlocoMinerado *removido) 
+{
+    pthread_mutex_lock(&travaIndices);
+
+    unsigned int id = stats.totalBlocos;
+    BlocoMinerado b;
+
+    // Lido antes da seção de escrita (a leitura passa pelo seqlock)
+    if (id == 0 || qtdDesfazer == 0 || !lerBlocoPorId(id, &b)) 
+    {
+        pthread_mutex_unlock(&travaIndices);
+        return 0;
+    }
+    seqlockEscritaInicio(&seqEstado);
+
+    RegistroDesfazer *r = &registrosDesfazer[(id - 1) % PROFUNDIDADE_MAX_REORG];
+    if (contasV2) 
+        reverterBlocoContas(&b, r);
+    else 
+        reverterBloco(&b, r, id);
+    maiorQtdMinerada = r->maiorQtdMineradaAnterior;
+
+    // Tabela de metadados e recordes (a coluna de contagem já não enxerga o bloco)
+    metadadosPublicar(id - 1);
+    maxTransacoesGlobal = r->maxAnterior;
+    minTransacoesGlobal = r->minAnterior;
+
+    // Nonce: o bloco do topo é sempre o primeiro do seu slot (a coluna de minerador não guarda ligação)
+    unsigned int pos = hashFunction(b.bloco.nonce);
+    PaginaMetadados *pagina = metadadosPagina(id);
+    if (tabelaNonce[pos] == id) 
+        __atomic_store_n(&tabelaNonce[pos], pagina->proxNonce[metadadosPosicao(id)], __ATOMIC_RELEASE);
+
+    indiceHashRemover(pagina->prefixoHash[metadadosPosicao(id)], id);
+    indiceHashAlterado = 1;
+
+    // Arquivo: tira do buffer se ainda não foi gravado, senão trunca o disco
+    if (contadorBuffer > 0) 
+        contadorBuffer--;
+    else 
+        truncarArquivos(id - 1);
+
+    stats.totalBlocos--;
+    __atomic_store_n(&versaoCadeia, versaoCadeia + 1, __ATOMIC_RELEASE);
+    qtdDesfazer--;
+    escritaFim();
+
+    if (removido != NULL) 
+        *removido = b;
+    return 1;
+}
+
+// Quantos blocos do topo ainda podem ser desconectados
+unsigned int profundidadeDesfazerDisponivel() 
+{
+    return qtdDesfazer;
+}
+
+// ID do bloco com exatamente esse hash na cadeia principal (0 se não existe)
+unsigned int localizarBlocoPorHash(const unsigned char hash[SHA256_LEN]) 
+{
+    unsigned int ids[4];
+    uint64_t prefixo = prefixoDoHash(hash);
+    pthread_mutex_lock(&travaIndices);
+    unsigned int qtd = indiceHashBuscar(prefixo, prefixo, ids, 4);
+    pthread_mutex_unlock(&travaIndices);
+    BlocoMinerado temp;
+
+    for (unsigned int i = 0; i < qtd && i < 4; i++) 
+    {
+        if (lerBlocoPorId(ids[i], &temp) && memcmp(temp.hash, hash, SHA256_LEN) == 0) 
+            return ids[i];
+    }
+    return 0;
+}
+
+unsigned int obterTotalBlocos() 
+{
+    return __atomic_load_n(&stats.totalBlocos, __ATOMIC_ACQUIRE);
+}
+
+int buscarBlocoPorId(unsigned int id, BlocoMinerado *saida) 
+{
+    return lerBlocoPorId(id, saida);
+}
+
+/**
+ * Cabeçalho do bloco 'id': do .hdr se já foi gravado, senão montado a
+ * partir do bloco que ainda está no buffer de escrita. Retorna 0 se o
+ * bloco não existe.
+ */
+int buscarCabecalhoPorId(unsigned int id, CabecalhoBloco *saida) 
+{
+    unsigned int total, noBuffer, seq;
+    do 
+    {
+        seq = seqlockLeituraInicio(&seqEstado);
+        total = stats.totalBlocos;
+        noBuffer = (unsigned int)contadorBuffer;
+    } while (seqlockLeituraRepetir(&seqEstado, seq));
+
+    if (id == 0 || id > total) 
+        return 0;
+    if (noBuffer <= total && id <= total - noBuffer && lerCabecalhoDoDisco(id, saida)) 
+        return 1;
+
+    BlocoMinerado b;
+    if (!lerBlocoPorId(id, &b)) 
+        return 0;
+    montarCabecalho(&b, contasV2 != 0, saida);
+    return 1;
+}
+
+/**
+ * Prova de inclusão da folha 'indice' do bloco 'idBloco' (slot da
+ * transação; o minerador é a última folha), com a árvore do cache de
+ * blocos quentes. Copia os bytes da folha e retorna o tamanho (0 se o
+ * bloco ou a folha não existem). Confere-se contra a raiz do cabeçalho.
+ */
+int gerarProvaInclusao(unsigned int idBloco, int indice, ProvaMerkle *prova, unsigned char folha[MERKLE_MAX_FOLHA]) 
+{
+    BlocoMinerado b;
+    unsigned char raiz[SHA256_LEN];
+    int v2 = contasV2 != 0;
+
+    if (!lerBlocoPorId(idBloco, &b) || !provaDoBloco(&b, v2, indice, prova, raiz)) 
+        return 0;
+    return merkleFolha(b.bloco.data, v2, indice, folha);
+}
+
+/**
+ * Lê os blocos [inicio, fim] para 'saida' (que deve comportar fim - inicio + 1 blocos).
+ * O trecho no disco sai em uma única leitura posicional e o trecho que ainda
+ * está no buffer de escrita é copiado direto da memória.
+ * Retorna a quantidade de blocos lidos (0 se o intervalo for inválido).
+ */
+unsigned int lerIntervaloBlocos(unsigned int inicio, unsigned int fim, BlocoMinerado *saida) 
+{
+    unsigned int total = 0, blocosPersistidos = 0, fimLido = 0, seq;
+    unsigned long long truncamentos;
+    int lidoDoDisco;
+
+    // O trecho em disco só cresce, exceto na reorganização (truncarArquivos):
+    // se ela truncou o arquivo durante o pread, o intervalo inteiro é relido
+    do 
+    {
+        // Buffer e contadores copiados sob o seqlock
+        do 
+        {
+            seq = seqlockLeituraInicio(&seqEstado);
+            truncamentos = __atomic_load_n(&truncamentosDisco, __ATOMIC_ACQUIRE);
+            total = stats.totalBlocos;
+            unsigned int noBuffer = (unsigned int)contadorBuffer;
+            if (noBuffer > BUFFER_SIZE || noBuffer > total) 
+                continue;   // Cópia rasgada: a sequência mudou e o laço repete
+            blocosPersistidos = total - noBuffer;
+            fimLido = fim > total ? total : fim;
+
+            // Parte ainda no buffer: [max(inicio, blocosPersistidos + 1), fim]
+            if (inicio >= 1 && inicio <= fimLido && fimLido > blocosPersistidos) 
+            {
+                unsigned int primeiroBuffer = inicio > blocosPersistidos ? inicio : blocosPersistidos + 1;
+                memcpy(&saida[primeiroBuffer - inicio], &buffer[primeiroBuffer - blocosPersistidos - 1],
+                       (fimLido - primeiroBuffer + 1) * sizeof(BlocoMinerado));
+            }
+        } while (seqlockLeituraRepetir(&seqEstado, seq));
+
+        if (inicio < 1 || inicio > fimLido) 
+            return 0;
+
+        // Parte persistida: [inicio, min(fim, blocosPersistidos)]
+        lidoDoDisco = 1;
+        if (inicio <= blocosPersistidos) 
+        {
+            unsigned int fimDisco = fimLido < blocosPersistidos ? fimLido : blocosPersistidos;
+            lidoDoDisco = lerTrechoDoDisco(inicio, fimDisco - inicio + 1, saida);
+        }
+    } while (__atomic_load_n(&truncamentosDisco, __ATOMIC_ACQUIRE) != truncamentos);
+
+    if (!lidoDoDisco) 
+        return 0;
+    if (fimLido > blocosPersistidos) 
+        contadorSomar(CONTADOR_BLOCOS_DO_BUFFER, fimLido - (inicio > blocosPersistidos ? inicio - 1 : blocosPersistidos));
+
+    return fimLido - inicio + 1;
+}
+
+// VERIFICAÇÃO DA CADEIA
+
+int verificarCadeiaPorCabecalhos(unsigned int *verificados) 
+{
+    escritaInicio();
+    flushBuffer();
+    escritaFim();
+
+    // Só a contagem é tirada sob a trava: o .hdr cresce durante a leitura sem
+    // afetar os registros anteriores, e a mineração não fica parada
+    unsigned long long truncamentos;
+    int ok;
+    do 
+    {
+        pthread_mutex_lock(&travaIndices);
+        unsigned int noHdr = stats.totalBlocos - (unsigned int)contadorBuffer;
+        truncamentos = __atomic_load_n(&truncamentosDisco, __ATOMIC_ACQUIRE);
+        pthread_mutex_unlock(&travaIndices);
+
+        ok = verificarCabecalhos(nomeArquivoHdr, contasV2 != 0, noHdr, verificados);
+    } while (__atomic_load_n(&truncamentosDisco, __ATOMIC_ACQUIRE) != truncamentos);
+    return ok;
+}
+
+// Verificação completa: relê os blocos inteiros e recalcula cada hash
+int verificarCadeiaCompleta(unsigned int *verificados) 
+{
+    BlocoMinerado lote[READ_LOTE];
+    unsigned char hashAnterior[SHA256_LEN] = {0};
+    unsigned char hashCalculado[SHA256_LEN];
+    unsigned int esperado = 1;
+    unsigned int lidos;
+
+    *verificados = 0;
+
+    while ((lidos = lerIntervaloBlocos(esperado, esperado + READ_LOTE - 1, lote)) > 0) 
+    {
+        for (unsigned int i = 0; i < lidos; i++) 
+        {
+            BlocoMinerado *b = &lote[i];
+            calcularHashFormato(&b->bloco, contasV2 != 0, hashCalculado);
+
+            if (b->bloco.numero != esperado || memcmp(b->bloco.hashAnterior, hashAnterior, SHA256_LEN) != 0 ||
+                memcmp(hashCalculado, b->hash, SHA256_LEN) != 0 || b->hash[0] != 0) 
+            {
+                printf("Bloco %u inválido.\n", esperado);
+                return 0;
+            }
+
+            memcpy(hashAnterior, b->hash, SHA256_LEN);
+            esperado++;
+            (*verificados)++;
+        }
+    }
+    return 1;
+}
+
+// RELATÓRIOS DO FORMATO V2 (CONTAS COM SALDO, SEM RANKING)
+
+typedef struct {
+    unsigned int conta;
+    unsigned int saldo;
+} SaldoConta;
+
+// Ordem crescente (saldo, conta), a mesma do ranking do formato v1
+static int saldoContaMenor(SaldoConta a, SaldoConta b) 
+{
+    return a.saldo != b.saldo ? a.saldo < b.saldo : a.conta < b.conta;
+}
+
+static int compararSaldoConta(const void *a, const void *b) 
+{
+    SaldoConta x = *(const SaldoConta *)a, y = *(const SaldoConta *)b;
+    return saldoContaMenor(x, y) ? -1 : saldoContaMenor(y, x);
+}
+
+static int compararSaldoContaDecrescente(const void *a, const void *b) 
+{
+    return compararSaldoConta(b, a);
+}
+
+static SaldoConta saldoContaComSaldoEm(unsigned int posicao) 
+{
+    SaldoConta c = {contasComSaldoEm(posicao), 0};
+    c.saldo = contasSaldo(c.conta);
+    return c;
+}
+
+static void descerHeapContas(SaldoConta *heap, unsigned int qtd, unsigned int i) 
+{
+    for (;;) 
+    {
+        unsigned int menor = i, esq = 2 * i + 1, dir = 2 * i + 2;
+        if (esq < qtd && saldoContaMenor(heap[esq], heap[menor])) menor = esq;
+        if (dir < qtd && saldoContaMenor(heap[dir], heap[menor])) menor = dir;
+        if (menor == i) 
+            return;
+        SaldoConta t = heap[i];
+        heap[i] = heap[menor];
+        heap[menor] = t;
+        i = menor;
+    }
+}
+
+/**
+ * Os N maiores saldos v2 (decrescente) com um heap de mínimo de N entradas
+ * sobre o conjunto com saldo: O(S log N), sem ordenar as S contas.
+ * Chamar com a trava de índices.
+ */
+static unsigned int maioresSaldosContas(unsigned int n, SaldoConta *saida) 
+{
+    unsigned int qtdComSaldo = contasComSaldo();
+    if (n > qtdComSaldo) n = qtdComSaldo;
+    if (n == 0) 
+        return 0;
+
+    for (unsigned int i = 0; i < n; i++) 
+        saida[i] = saldoContaComSaldoEm(i);
+    for (unsigned int i = n / 2; i-- > 0; ) 
+        descerHeapContas(saida, n, i);
+    for (unsigned int i = n; i < qtdComSaldo; i++) 
+    {
+        SaldoConta c = saldoContaComSaldoEm(i);
+        if (saldoContaMenor(saida[0], c)) 
+        {
+            saida[0] = c;
+            descerHeapContas(saida, n, 0);
+        }
+    }
+    qsort(saida, n, sizeof(SaldoConta), compararSaldoContaDecrescente);
+    return n;
+}
+
+// Contas com saldo em ordem crescente (saldo, conta); as zeradas ficam implícitas antes delas
+static unsigned int contasOrdenadasPorSaldo(SaldoConta **saida) 
+{
+    pthread_mutex_lock(&travaIndices);
+    unsigned int qtd = contasComSaldo();
+    *saida = verifica_malloc((qtd > 0 ? qtd : 1) * sizeof(SaldoConta), "contasOrdenadasPorSaldo");
+    for (unsigned int i = 0; i < qtd; i++) 
+        (*saida)[i] = saldoContaComSaldoEm(i);
+    pthread_mutex_unlock(&travaIndices);
+
+    qsort(*saida, qtd, sizeof(SaldoConta), compararSaldoConta);
+    return qtd;
+}
+
+static void relatorioMaisRicoContas() 
+{
+    SaldoConta *ordenados;
+    unsigned int qtd = contasOrdenadasPorSaldo(&ordenados);
+    unsigned int maxAtual = qtd > 0 ? ordenados[qtd - 1].saldo : 0;
+
+    printf("\n--- Endereço(s) com mais Bitcoins (Item A) ---\n");
+    printf("Saldo Máximo: %u BTC\n", maxAtual);
+    printf("Endereço(s): ");
+
+    // Empatados são os últimos na ordem crescente: saem em ordem de conta
+    unsigned int k = qtd;
+    while (k > 0 && ordenados[k - 1].saldo == maxAtual) 
+        k--;
+    for (unsigned int i = k; i < qtd; i++) 
+        printf("%s%u", i > k ? " | " : "", ordenados[i].conta);
+    if (qtd == 0) printf("(Nenhum endereço com saldo > 0)");
+    printf("\n");
+    free(ordenados);
+}
+
+// k-ésimo menor saldo entre todas as contas (1-based), com as zeradas antes das ordenadas
+static unsigned int kesimoSaldoContas(const SaldoConta *ordenados, unsigned int zeradas, unsigned int k) 
+{
+    return k <= zeradas ? 0 : ordenados[k - zeradas - 1].saldo;
+}
+
+/**
+ * Mesmo relatório do ranking, calculado sobre as contas com saldo ordenadas:
+ * O(S log S) por consulta, sem o nó de 40 bytes por conta do ranking. As
+ * contas zeradas entram na posição, na mediana, nos percentis e no Gini.
+ */
+static void relatorioRiquezaContas(unsigned int topN, unsigned int conta) 
+{
+    SaldoConta *ordenados;
+    unsigned int qtd = contasOrdenadasPorSaldo(&ordenados);
+    unsigned int total = contasV2;
+    unsigned int zeradas = total - qtd;
+
+    if (topN > qtd) topN = qtd;
+
+    printf("\n--- Distribuição de Riqueza ---\n");
+    printf("Top %u:\n", topN);
+    for (unsigned int k = 1; k <= topN; k++) 
+        printf("  %3u. Conta %u: %u BTC\n", k, ordenados[qtd - k].conta, ordenados[qtd - k].saldo);
+
+    // Posição: quem vem depois de (saldo, conta) na ordem crescente
+    if (conta < total) 
+    {
+        SaldoConta alvo = {conta, getSaldoConta(conta)};
+        unsigned int maiores = 0, comSaldoAcima = 0;
+        for (unsigned int i = 0; i < qtd; i++) 
+        {
+            if (saldoContaMenor(alvo, ordenados[i])) maiores++;
+            if (ordenados[i].conta > conta) comSaldoAcima++;
+        }
+        if (alvo.saldo == 0) 
+            maiores = qtd + (total - 1 - conta) - comSaldoAcima;
+        printf("Conta %u: posição %u de %u (%u BTC)\n", conta, maiores + 1, total, alvo.saldo);
+    }
+    else 
+        printf("Conta %u fora do espaço de %u contas\n", conta, total);
+
+    double mediana = total > 0 ? (kesimoSaldoContas(ordenados, zeradas, (total + 1) / 2) +
+                                  (double)kesimoSaldoContas(ordenados, zeradas, total / 2 + 1)) / 2.0 : 0.0;
+    printf("Mediana: %.1f BTC\n", mediana);
+
+    const int percentis[] = {10, 25, 75, 90, 99};
+    printf("Percentis:");
+    for (int i = 0; i < 5; i++) 
+    {
+        unsigned int k = (unsigned int)((percentis[i] * (unsigned long long)total + 99) / 100);
+        printf(" p%d=%u", percentis[i], total > 0 ? kesimoSaldoContas(ordenados, zeradas, k == 0 ? 1 : k) : 0);
+    }
+
+    // G = 2·Σ(i·x_i) / (n·Σx) - (n + 1) / n, com as zeradas nas primeiras posições
+    double soma = 0.0, ponderada = 0.0;
+    for (unsigned int i = 0; i < qtd; i++) 
+    {
+        soma += ordenados[i].saldo;
+        ponderada += (double)(zeradas + i + 1) * ordenados[i].saldo;
+    }
+    double n = (double)total;
+    printf("\nEndereços sem saldo: %u\n", zeradas);
+    printf("Coeficiente de Gini: %.4f\n", soma > 0 ? 2.0 * ponderada / (n * soma) - (n + 1.0) / n : 0.0);
+    free(ordenados);
 }
 
 // RELATÓRIOS ESTATÍSTICOS
 
 void relatorioMaisRico() 
 {
-    
-    unsigned int maxAtual = 0;
-    for(int i = 0; i < NUM_ENDERECOS; i++) 
+    if (contasV2) 
     {
-        if(saldos[i] > maxAtual) 
-            maxAtual = saldos[i];
+        relatorioMaisRicoContas();
+        return;
     }
 
+    // Maior saldo e empatados vêm do ranking: O(log n) + O(empates · log n)
+    // Copiados sob a trava; a impressão acontece depois, sem segurar o escritor
+    unsigned int maxAtual = 0;
+    unsigned int empatados[NUM_ENDERECOS];
+    unsigned int qtdEmpatados = 0;
+
+    pthread_mutex_lock(&travaIndices);
+    rankingKesimoMaior(1, &maxAtual);
+    unsigned int total = rankingQuantidade();
+    unsigned int iguais = rankingContarIguais(maxAtual);
+
+    // Empatados são os últimos na ordem crescente (saldo, endereço): saem em ordem de endereço
+    for (unsigned int k = total - iguais + 1; k <= total; k++) 
+        empatados[qtdEmpatados++] = rankingKesimoMenor(k, NULL);
+    pthread_mutex_unlock(&travaIndices);
+
     printf("\n--- Endereço(s) com mais Bitcoins (Item A) ---\n");
     printf("Saldo Máximo: %u BTC\n", maxAtual);
     printf("Endereço(s): "); 
+    for (unsigned int i = 0; i < qtdEmpatados; i++) 
+        printf("%s%u", i > 0 ? " | " : "", empatados[i]);
     
-    int primeiro = 1;
-    int encontrou = 0;
-    
-    for(int i = 0; i < NUM_ENDERECOS; i++) 
+    if (qtdEmpatados == 0) printf("(Nenhum endereço com saldo > 0)");
+    printf("\n");
+}
+
+/**
+ * Os N maiores saldos (decrescente) para quem não quer o relatório impresso.
+ * No formato v2, só contas com saldo. Retorna quantos copiou.
+ */
+unsigned int maioresSaldos(unsigned int n, unsigned int *enderecos, unsigned int *valores) 
+{
+    if (contasV2) 
     {
-        if(saldos[i] == maxAtual) 
+        SaldoConta *topo = verifica_malloc((n > 0 ? n : 1) * sizeof(SaldoConta), "maioresSaldos");
+        pthread_mutex_lock(&travaIndices);
+        n = maioresSaldosContas(n, topo);
+        pthread_mutex_unlock(&travaIndices);
+        for (unsigned int i = 0; i < n; i++) 
         {
-            if(!primeiro) printf(" | "); 
-            printf("%d", i);
-            primeiro = 0;
-            encontrou = 1;
+            enderecos[i] = topo[i].conta;
+            valores[i] = topo[i].saldo;
         }
+        free(topo);
+        return n;
     }
-    
-    if (!encontrou) printf("(Nenhum endereço com saldo > 0)");
-        printf("\n");
+
+    pthread_mutex_lock(&travaIndices);
+    if (n > rankingQuantidade()) n = rankingQuantidade();
+    for (unsigned int k = 1; k <= n; k++) 
+        enderecos[k - 1] = rankingKesimoMaior(k, &valores[k - 1]);
+    pthread_mutex_unlock(&travaIndices);
+    return n;
 }
 
-void relatorioMaiorMinerador() 
+// Top-N, posição de um endereço, mediana, percentis e Gini a partir do ranking
+void relatorioRiqueza(unsigned int topN, unsigned int endereco) 
 {
-    printf("\n--- Endereço(s) que mais minerou (Item B) ---\n");
-    printf("Qtd Blocos: %u\n", maiorQtdMinerada);
-    printf("Endereço(s): "); 
-    
-    int primeiro = 1;
-    
-    for(int i = 0; i < NUM_ENDERECOS; i++) 
+    if (contasV2) 
     {
-        if(blocosMinerados[i] == maiorQtdMinerada) 
+        relatorioRiquezaContas(topN, endereco);
+        return;
+    }
+    if (endereco >= NUM_ENDERECOS) 
+    {
+        printf("Endereço %u inválido (0-%d).\n", endereco, NUM_ENDERECOS - 1);
+        return;
+    }
+
+    // Tudo copiado sob a trava; a impressão acontece depois, sem segurar o escritor
+    const int percentis[] = {10, 25, 75, 90, 99};
+    unsigned int topEnderecos[NUM_ENDERECOS], topSaldos[NUM_ENDERECOS], saldosPercentis[5];
+
+    pthread_mutex_lock(&travaIndices);
+    unsigned int total = rankingQuantidade();
+    if (topN > total) topN = total;
+    for (unsigned int k = 1; k <= topN; k++) 
+        topEnderecos[k - 1] = rankingKesimoMaior(k, &topSaldos[k - 1]);
+
+    unsigned int posicao = rankingPosicao(endereco);
+    unsigned int saldoEndereco = saldos[endereco];
+    double mediana = rankingMediana();
+    for (int i = 0; i < 5; i++) 
+    {
+        unsigned int k = (unsigned int)((percentis[i] * (unsigned long long)total + 99) / 100);
+        rankingKesimoMenor(k == 0 ? 1 : k, &saldosPercentis[i]);
+    }
+    unsigned int zeradas = rankingContarIguais(0);
+    double gini = rankingGini();
+    pthread_mutex_unlock(&travaIndices);
+
+    printf("\n--- Distribuição de Riqueza ---\n");
+    printf("Top %u:\n", topN);
+    for (unsigned int k = 1; k <= topN; k++) 
+        printf("  %3u. Endereço %3u: %u BTC\n", k, topEnderecos[k - 1], topSaldos[k - 1]);
+
+    printf("Endereço %d: posição %u de %u (%u BTC)\n", endereco, posicao, total, saldoEndereco);
+    printf("Mediana: %.1f BTC\n", mediana);
+
+    printf("Percentis:");
+    for (int i = 0; i < 5; i++) 
+        printf(" p%d=%u", percentis[i], saldosPercentis[i]);
+    printf("\nEndereços sem saldo: %u\n", zeradas);
+    printf("Coeficiente de Gini: %.4f\n", gini);
+}
+
+/**
+ * Endereços empatados no maior número de blocos minerados, em ordem
+ * crescente. Copia até 'max' e retorna o total de empatados. No formato v2
+ * varre os contadores das páginas alocadas (só as contas já tocadas).
+ */
+unsigned int maioresMineradores(unsigned int *enderecos, unsigned int max, unsigned int *blocos) 
+{
+    unsigned int qtd = 0;
+
+    if (!contasV2) 
+    {
+        InstantaneoEstatisticas inst;
+        obterInstantaneo(&inst);
+        *blocos = inst.maiorQtdMinerada;
+        for (unsigned int i = 0; i < NUM_ENDERECOS; i++) 
         {
-            if(!primeiro) printf(" | "); 
-                printf("%d", i);
-            primeiro = 0; 
+            if (inst.blocosMinerados[i] != inst.maiorQtdMinerada) 
+                continue;
+            if (qtd < max) enderecos[qtd] = i;
+            qtd++;
         }
+        return qtd;
     }
+
+    // Trava: os contadores e o máximo mudam juntos no escritor
+    pthread_mutex_lock(&travaIndices);
+    *blocos = maiorQtdMinerada;
+    for (unsigned int p = 0; *blocos > 0 && p * CONTAS_POR_PAGINA < contasV2; p++) 
+    {
+        const PaginaContas *pagina = contasPagina(p);
+        if (pagina == NULL) 
+            continue;
+        for (unsigned int i = 0; i < CONTAS_POR_PAGINA; i++) 
+        {
+            if (pagina->blocosMinerados[i] != *blocos) 
+                continue;
+            if (qtd < max) enderecos[qtd] = p * CONTAS_POR_PAGINA + i;
+            qtd++;
+        }
+    }
+    pthread_mutex_unlock(&travaIndices);
+    return qtd;
+}
+
+void relatorioMaiorMinerador() 
+{
+    unsigned int enderecos[NUM_ENDERECOS];
+    unsigned int blocos;
+    unsigned int qtd = maioresMineradores(enderecos, NUM_ENDERECOS, &blocos);
+
+    printf("\n--- Endereço(s) que mais minerou (Item B) ---\n");
+    printf("Qtd Blocos: %u\n", blocos);
+    printf("Endereço(s): "); 
+    
+    for (unsigned int i = 0; i < qtd && i < NUM_ENDERECOS; i++) 
+        printf("%s%u", i > 0 ? " | " : "", enderecos[i]);
+    if (qtd > NUM_ENDERECOS) 
+        printf(" | ... (+%u)", qtd - NUM_ENDERECOS);
     printf("\n");
 }
 
+// Valor do recorde e altura lidos juntos; os empatados vêm da coluna de contagem
+static void lerRecorde(int maximo, int *valor, unsigned int *total) 
+{
+    unsigned int seq;
+    do 
+    {
+        seq = seqlockLeituraInicio(&seqEstado);
+        *valor = maximo ? maxTransacoesGlobal : minTransacoesGlobal;
+        *total = stats.totalBlocos;
+    } while (seqlockLeituraRepetir(&seqEstado, seq));
+}
+
+static void relatorioRecordes(int maximo, const char *titulo) 
+{
+    int valor;
+    unsigned int total;
+    lerRecorde(maximo, &valor, &total);
+
+    // O recorde de MIN ignora o gênesis, que não tem transações
+    unsigned int primeiro = maximo ? 1 : 2;
+    unsigned int qtd = varrerContagem(primeiro, total, valor, NULL, 0);
+    unsigned int *ids = verifica_malloc((qtd > 0 ? qtd : 1) * sizeof(unsigned int), "relatorioRecordes");
+    qtd = varrerContagem(primeiro, total, valor, ids, qtd);
+
+    imprimirListaRecordes(ids, qtd, titulo, valor);
+    free(ids);
+}
+
+/**
+ * Blocos empatados no recorde de MAX (maximo = 1) ou MIN transações, do mais
+ * recente ao mais antigo. Copia até 'maxIds' e retorna o total de empatados.
+ */
+unsigned int blocosRecorde(int maximo, int *valor, unsigned int *ids, unsigned int maxIds) 
+{
+    unsigned int total;
+    lerRecorde(maximo, valor, &total);
+    return varrerContagem(maximo ? 1 : 2, total, *valor, ids, maxIds);
+}
+
 void relatorioMaxTransacoes() 
 {
-    imprimirListaRecordes(listaMaxTx, "Bloco(s) com MAIS transações (Item C)", maxTransacoesGlobal);
+    relatorioRecordes(1, "Bloco(s) com MAIS transações (Item C)");
 }
 
 void relatorioMinTransacoes() 
 {
-    imprimirListaRecordes(listaMinTx, "Bloco(s) com MENOS transações (Item D)", minTransacoesGlobal);
+    relatorioRecordes(0, "Bloco(s) com MENOS transações (Item D)");
 }
 
 void calcularMediaBitcoinsPorBloco() 
 {
-    if (stats.totalBlocos == 0) 
+    InstantaneoEstatisticas inst;
+    obterInstantaneo(&inst);
+
+    if (inst.totalBlocos == 0) 
     {
         printf("Blockchain vazia.\n");
         return;
     }
-    double media = (double)totalValorTransacionado / stats.totalBlocos;
+    double media = (double)inst.totalValorTransacionado / inst.totalBlocos;
     printf("\n--- Média de Bitcoins por Bloco (Item E) ---\n");
-    printf("Total transacionado: %llu BTC\n", totalValorTransacionado);
-    printf("Total de blocos: %u\n", stats.totalBlocos);
+    printf("Total transacionado: %llu BTC\n", inst.totalValorTransacionado);
+    printf("Total de blocos: %u\n", inst.totalBlocos);
     printf("Média: %.2f BTC/bloco\n", media);
 }
 
@@ -643,89 +1928,216 @@ void imprimirBlocoPorNumero(unsigned int numero)
         printf("Bloco %u não encontrado.\n", numero);
 }
 
-void listarBlocosMinerador(unsigned char endereco, int n) 
+/**
+ * Visita os N primeiros blocos do minerador, em ordem de ID, varrendo a
+ * coluna de mineradores da tabela de metadados. Para assim que achou N
+ * blocos ou todos os que o minerador tem. Retorna quantos visitou.
+ * No formato v2 a coluna guarda só o byte baixo da conta: ela filtra e o
+ * minerador inteiro é conferido no bloco lido.
+ */
+int percorrerBlocosMinerador(unsigned int endereco, int n, VisitanteBloco visitar, void *contexto) 
 {
-    NoMinerador *atual = indiceMinerador[endereco];
+    unsigned int restantes, total;
     int count = 0;
     BlocoMinerado temp;
-    
-    printf("\n--- %d Primeiros Blocos do Minerador %d ---\n", n, endereco);
-    
-    while (atual != NULL && count < n) 
+
+    if (contasV2) 
     {
-        if (lerBlocoPorId(atual->idBloco, &temp)) 
-            imprimirBlocoCompleto(&temp);
-        atual = atual->prox;
-        count++;
+        rcuLeituraInicio();
+        restantes = contasBlocosMinerados(endereco);
+        rcuLeituraFim();
+        total = obterTotalBlocos();
     }
-    
-    if (count == 0)
-        printf("Minerador %d não possui blocos.\n", endereco);
+    else 
+    {
+        if (endereco >= NUM_ENDERECOS) 
+            return 0;
+        InstantaneoEstatisticas inst;
+        obterInstantaneo(&inst);
+        restantes = inst.blocosMinerados[endereco];
+        total = inst.totalBlocos;
+    }
+
+    rcuLeituraInicio();
+    for (unsigned int id = 1; id <= total && count < n && restantes > 0; ) 
+    {
+        // Uma página por vez: o laço interno só toca bytes vizinhos
+        PaginaMetadados *pagina = metadadosPagina(id);
+        unsigned int pos = metadadosPosicao(id);
+        unsigned int fimPagina = id - pos + METADADOS_POR_PAGINA - 1;
+        unsigned int parada = fimPagina < total ? fimPagina : total;
+
+        for (; id <= parada && count < n && restantes > 0; id++, pos++) 
+        {
+            if (pagina->minerador[pos] != (unsigned char)endereco) 
+                continue;
+            if (!lerBlocoPorId(id, &temp)) 
+                continue;
+            if (contasV2 && formatoMinerador(temp.bloco.data, 1) != endereco) 
+                continue;
+            visitar(&temp, pagina->qtdTx[pos], contexto);
+            restantes--;
+            count++;
+        }
+    }
+    rcuLeituraFim();
+    return count;
 }
 
-void relatorioTransacoes(unsigned int n) 
+static void visitarBlocoCompleto(BlocoMinerado *b, int qtdTx, void *contexto) 
 {
-    if (n > stats.totalBlocos) n = stats.totalBlocos;
-    if (n == 0) return;
+    (void)qtdTx;
+    (void)contexto;
+    imprimirBlocoCompleto(b);
+}
 
-    // Carrega N blocos em memória
-    BlocoMinerado *blocos = verifica_malloc(n * sizeof(BlocoMinerado), "relatorioTransacoes");
+void listarBlocosMinerador(unsigned int endereco, int n) 
+{
+    printf("\n--- %d Primeiros Blocos do Minerador %u ---\n", n, endereco);
+    
+    if (percorrerBlocosMinerador(endereco, n, visitarBlocoCompleto, NULL) == 0)
+        printf("Minerador %u não possui blocos.\n", endereco);
+}
 
-    for (unsigned int i = 0; i < n; i++) 
-        lerBlocoPorId(i + 1, &blocos[i]);
+/**
+ * Motor do relatório por transações: ordena os IDs dos N primeiros blocos
+ * por bucket sort usando só a coluna de contagem da tabela de metadados e lê os
+ * blocos do storage apenas na hora de visitá-los, em trechos consecutivos.
+ * A ordem dentro de cada bucket é crescente por ID.
+ */
+void percorrerBlocosPorTransacoes(unsigned int n, VisitanteBloco visitar, void *contexto) 
+{
+    // Trava: a coluna de contagem é lida inteira e o escritor pode estar no meio de um bloco
+    pthread_mutex_lock(&travaIndices);
+    if (n > stats.totalBlocos) n = stats.totalBlocos;
+    if (n == 0) 
+    {
+        pthread_mutex_unlock(&travaIndices);
+        return;
+    }
 
-    // Bucket Sort: 62 buckets (0 a 61 transações)
+    // Bucket Sort: 62 buckets (0 a 61 transações), listas encadeadas por índice
     int *next = verifica_malloc(n * sizeof(int), "next");
-    int buckets[62];
-    for(int i = 0; i < 62; i++) buckets[i] = -1;
+    int buckets[MAX_TRANSACOES + 1];
+    for(int i = 0; i <= MAX_TRANSACOES; i++) buckets[i] = -1;
 
-    // Usa cache em vez de recontar
+    // Percorre de trás para frente para que cada bucket fique em ordem crescente
     for (int i = (int)n - 1; i >= 0; i--) 
     {
-        // Consulta O(1) do cache em vez de O(61) de contarTransacoes
-        int qtd = obterContagemDoCache(blocos[i].bloco.numero);
-        if (qtd > 61) qtd = 61;
+        int qtd = obterContagemTx((unsigned int)i + 1);
+        if (qtd > MAX_TRANSACOES) qtd = MAX_TRANSACOES;
         next[i] = buckets[qtd];
         buckets[qtd] = i;
     }
 
-    printf("\n--- Relatório Top %u Blocos (Ordenado por Transações) ---\n", n);
-    
-    for (int t = 0; t < 62; t++) 
+    // As listas dos buckets já são cópias: leitura dos blocos e visitas acontecem sem a trava
+    pthread_mutex_unlock(&travaIndices);
+    BlocoMinerado lote[LOTE_RELATORIO];
+
+    for (int t = 0; t <= MAX_TRANSACOES; t++) 
     {
-        if (buckets[t] == -1) 
-            continue;
+        int idx = buckets[t];
+        while (idx != -1) 
+        {
+            // Agrupa IDs consecutivos do mesmo bucket em uma única leitura
+            unsigned int inicio = (unsigned int)idx + 1;
+            unsigned int qtdTrecho = 1;
+            int fimTrecho = idx;
+            while (qtdTrecho < LOTE_RELATORIO && next[fimTrecho] == fimTrecho + 1) 
+            {
+                fimTrecho = next[fimTrecho];
+                qtdTrecho++;
+            }
+
+            unsigned int lidos = lerIntervaloBlocos(inicio, inicio + qtdTrecho - 1, lote);
+            for (unsigned int k = 0; k < lidos; k++) 
+                visitar(&lote[k], t, contexto);
 
-        printf("\n[ %d Transações ]\n", t);
-        for (int idx = buckets[t]; idx != -1; idx = next[idx]) 
-            imprimirBlocoCompleto(&blocos[idx]);
+            idx = next[fimTrecho];
+        }
     }
     free(next);
-    free(blocos);
 }
 
-int listarBlocosPorNonce(unsigned int nonce) 
+static void visitarImpressao(BlocoMinerado *b, int qtdTx, void *contexto) 
+{
+    int *ultimoBucket = contexto;
+    if (qtdTx != *ultimoBucket) 
+    {
+        printf("\n[ %d Transações ]\n", qtdTx);
+        *ultimoBucket = qtdTx;
+    }
+    imprimirBlocoCompleto(b);
+}
+
+void relatorioTransacoes(unsigned int n) 
+{
+    if (n > obterTotalBlocos()) n = obterTotalBlocos();
+    if (n == 0) return;
+
+    int ultimoBucket = -1;
+
+    printf("\n--- Relatório Top %u Blocos (Ordenado por Transações) ---\n", n);
+    percorrerBlocosPorTransacoes(n, visitarImpressao, &ultimoBucket);
+}
+
+// Visita todos os blocos com esse nonce (filtro de Bloom antes da tabela). Retorna quantos visitou.
+int percorrerBlocosPorNonce(unsigned int nonce, VisitanteBloco visitar, void *contexto) 
 {
     unsigned int pos = hashFunction(nonce);
-    NoHash *atual = tabelaNonce[pos];
     int encontrados = 0;
     BlocoMinerado temp;
+    FiltroBloom filtro;
+    unsigned int seq;
 
-    printf("\n--- Buscando Blocos com Nonce %u ---\n", nonce);
+    __atomic_fetch_add(&consultasNonce, 1, __ATOMIC_RELAXED);
+
+    rcuLeituraInicio();
+    do 
+    {
+        seq = seqlockLeituraInicio(&seqEstado);
+        filtro = filtroNonce;
+    } while (seqlockLeituraRepetir(&seqEstado, seq));
 
-    while (atual != NULL) 
+    // Negativo do filtro é definitivo: nem toca nos nós da lista
+    if (!bloomTalvezContem(&filtro, nonce)) 
     {
-        if (atual->nonce == nonce) 
+        rcuLeituraFim();
+        __atomic_fetch_add(&rejeitadasBloom, 1, __ATOMIC_RELAXED);
+        return 0;
+    }
+
+    contadorSomar(CONTADOR_BUSCAS_NONCE, 1);
+    unsigned long long sondagens = 0;
+    unsigned int id = __atomic_load_n(&tabelaNonce[pos], __ATOMIC_ACQUIRE);
+    while (id != 0) 
+    {
+        PaginaMetadados *pagina = metadadosPagina(id);
+        unsigned int posBloco = metadadosPosicao(id);
+        sondagens++;
+        if (pagina->nonce[posBloco] == nonce) 
         {
-            if (lerBlocoPorId(atual->idBloco, &temp)) 
+            if (lerBlocoPorId(id, &temp)) 
             {
-                imprimirBlocoCompleto(&temp);
+                visitar(&temp, pagina->qtdTx[posBloco], contexto);
                 encontrados++;
             }
         }
-        atual = atual->prox;
+        id = pagina->proxNonce[posBloco];
     }
+    rcuLeituraFim();
+    contadorSomar(CONTADOR_SONDAGENS_NONCE, sondagens);
+
+    if (encontrados == 0) 
+        __atomic_fetch_add(&falsosPositivosBloom, 1, __ATOMIC_RELAXED);
+    return encontrados;
+}
+
+int listarBlocosPorNonce(unsigned int nonce) 
+{
+    printf("\n--- Buscando Blocos com Nonce %u ---\n", nonce);
 
+    int encontrados = percorrerBlocosPorNonce(nonce, visitarBlocoCompleto, NULL);
     if (encontrados == 0) 
         printf("Nenhum bloco encontrado com o nonce %u.\n", nonce);
     else
@@ -734,35 +2146,357 @@ int listarBlocosPorNonce(unsigned int nonce)
     return encontrados;
 }
 
+// BUSCA POR HASH
+
+static int valorHex(char c) 
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+/**
+ * Busca pelo hash completo (64 hex) ou por um prefixo hex único.
+ * Os 2 primeiros dígitos são o byte da dificuldade (sempre 00); os 16
+ * seguintes vão para o índice e o restante é conferido no bloco lido.
+ * Retorna quantos blocos casaram (1 = encontrado, >1 = prefixo ambíguo).
+ */
+int buscarBlocoPorHash(const char *hex) 
+{
+    size_t tamanho = strlen(hex);
+    unsigned char alvo[SHA256_LEN] = {0};
+    const unsigned int MAX_CANDIDATOS = 10;
+    unsigned int ids[10];
+
+    printf("\n--- Buscando Bloco por Hash %s ---\n", hex);
+
+    if (tamanho == 0 || tamanho > SHA256_LEN * 2) 
+    {
+        printf("Informe de 1 a 64 dígitos hexadecimais.\n");
+        return 0;
+    }
+    for (size_t i = 0; i < tamanho; i++) 
+    {
+        int v = valorHex(hex[i]);
+        if (v < 0) 
+        {
+            printf("Caractere inválido no hash: '%c'\n", hex[i]);
+            return 0;
+        }
+        alvo[i / 2] |= (unsigned char)(i % 2 == 0 ? v << 4 : v);
+    }
+
+    // Todo bloco válido tem hash[0] == 0: outro primeiro byte não existe na cadeia
+    if (alvo[0] != 0) 
+    {
+        printf("Nenhum bloco encontrado (todo hash válido começa com 00).\n");
+        return 0;
+    }
+
+    // Bits do prefixo que caem dentro da chave de 8 bytes do índice
+    int bitsChave = (int)tamanho * 4 - PREFIXO_OFFSET * 8;
+    if (bitsChave < 0) bitsChave = 0;
+    if (bitsChave > 64) bitsChave = 64;
+
+    uint64_t chave = prefixoDoHash(alvo);
+    uint64_t mascara = bitsChave == 64 ? ~0ULL : (bitsChave == 0 ? 0 : ~0ULL << (64 - bitsChave));
+    uint64_t minimo = chave & mascara;
+    uint64_t maximo = minimo | ~mascara;
+
+    pthread_mutex_lock(&travaIndices);
+    unsigned int candidatos = indiceHashBuscar(minimo, maximo, ids, MAX_CANDIDATOS);
+    pthread_mutex_unlock(&travaIndices);
+    int encontrados = 0;
+    unsigned int confirmados[10];
+    BlocoMinerado temp;
+
+    // Prefixo maior que a chave: confere o restante no hash do bloco
+    for (unsigned int i = 0; i < candidatos && i < MAX_CANDIDATOS; i++) 
+    {
+        if (!lerBlocoPorId(ids[i], &temp)) 
+            continue;
+
+        int casou = 1;
+        for (size_t d = 0; d < tamanho && casou; d++) 
+        {
+            unsigned char nibble = (unsigned char)(d % 2 == 0 ? temp.hash[d / 2] >> 4 : temp.hash[d / 2] & 0x0f);
+            casou = nibble == valorHex(hex[d]);
+        }
+        if (casou) 
+            confirmados[encontrados++] = ids[i];
+    }
+
+    if (candidatos > MAX_CANDIDATOS) 
+    {
+        printf("Prefixo ambíguo: %u blocos começam com %s. Digite mais dígitos.\n", candidatos, hex);
+        return (int)candidatos;
+    }
+    if (encontrados == 0) 
+        printf("Nenhum bloco encontrado com esse hash.\n");
+    else if (encontrados == 1) 
+    {
+        lerBlocoPorId(confirmados[0], &temp);
+        imprimirBlocoCompleto(&temp);
+    }
+    else 
+    {
+        printf("Prefixo ambíguo, %d blocos:\n", encontrados);
+        for (int i = 0; i < encontrados; i++) 
+        {
+            lerBlocoPorId(confirmados[i], &temp);
+            printf("   - Bloco %u | Hash: ", confirmados[i]);
+            for (int j = 0; j < SHA256_LEN; j++) printf("%02x", temp.hash[j]);
+            printf("\n");
+        }
+    }
+    return encontrados;
+}
+
+// Ajusta a taxa de falso positivo do filtro de nonces (recria o filtro na hora)
+void definirTaxaFalsoPositivoNonce(double taxa) 
+{
+    if (taxa <= 0.0 || taxa >= 1.0) 
+    {
+        printf("Taxa inválida: use um valor entre 0 e 1 (ex: 0.01).\n");
+        return;
+    }
+    escritaInicio();
+    taxaFalsoPositivoNonce = taxa;
+    reconstruirFiltroNonce(filtroNonce.capacidade);
+    escritaFim();
+}
+
+// HISTÓRICO POR ENDEREÇO
+
+void listarHistoricoEndereco(unsigned int endereco, unsigned int inicio, unsigned int limite) 
+{
+    if (modoCadeiaGrande || contasV2) 
+    {
+        printf("\nÍndice de histórico desligado no modo cadeia grande e no formato v2: use a varredura completa.\n");
+        return;
+    }
+    if (endereco >= NUM_ENDERECOS) 
+    {
+        printf("Endereço %u inválido (0-%d).\n", endereco, NUM_ENDERECOS - 1);
+        return;
+    }
+
+    // Só a cópia da página é feita sob a trava; leitura dos blocos e impressão vêm depois
+    EntradaHistorico *pagina = verifica_malloc((limite > 0 ? limite : 1) * sizeof(EntradaHistorico), "listarHistoricoEndereco");
+    unsigned int qtd = 0;
+
+    pthread_mutex_lock(&travaIndices);
+    unsigned int total = historicoTotal(endereco);
+    if (limite > 0 && inicio < total) 
+        qtd = historicoConsultar(endereco, inicio, limite, pagina);
+    pthread_mutex_unlock(&travaIndices);
+
+    printf("\n--- Histórico do Endereço %d (%u transferências) ---\n", endereco, total);
+    if (qtd == 0) 
+    {
+        printf("Nenhuma transferência nessa página.\n");
+        free(pagina);
+        return;
+    }
+
+    BlocoMinerado temp;
+    unsigned int blocoCarregado = 0;
+
+    for (unsigned int i = 0; i < qtd; i++) 
+    {
+        // Entradas do mesmo bloco são vizinhas: lê cada bloco uma vez só
+        if (pagina[i].idBloco != blocoCarregado) 
+        {
+            if (!lerBlocoPorId(pagina[i].idBloco, &temp)) 
+                continue;
+            blocoCarregado = pagina[i].idBloco;
+        }
+
+        unsigned char *tx = &temp.bloco.data[pagina[i].slot * TRANSACAO_SIZE];
+        if (pagina[i].direcao == DIRECAO_SAIDA) 
+            printf("  #%u Bloco %u [tx %u]: enviou %d BTC para %d\n", inicio + i, pagina[i].idBloco, pagina[i].slot, tx[2], tx[1]);
+        else 
+            printf("  #%u Bloco %u [tx %u]: recebeu %d BTC de %d\n", inicio + i, pagina[i].idBloco, pagina[i].slot, tx[2], tx[0]);
+    }
+    printf("Exibindo %u a %u de %u.\n", inicio, inicio + qtd - 1, total);
+
+    free(pagina);
+}
+
+/**
+ * Mesma consulta do histórico, mas varrendo todos os blocos do disco.
+ * Usada como referência de desempenho para o índice (e como a única forma
+ * de consulta no formato v2, que não tem índice por conta).
+ */
+unsigned int varrerHistoricoEndereco(unsigned int endereco, unsigned int inicio, unsigned int limite) 
+{
+    BlocoMinerado lote[READ_LOTE];
+    unsigned int proximo = 2; // Gênesis não tem transações
+    unsigned int indice = 0;
+    unsigned int encontradas = 0;
+    unsigned int lidos;
+    int v2 = contasV2 != 0;
+    TransacaoConta tx;
+
+    while (encontradas < limite && (lidos = lerIntervaloBlocos(proximo, proximo + READ_LOTE - 1, lote)) > 0) 
+    {
+        proximo += lidos;
+        for (unsigned int k = 0; k < lidos && encontradas < limite; k++) 
+        {
+            for (int slot = 0; slot < formatoMaxTransacoes(v2) && encontradas < limite; slot++) 
+            {
+                int tipo = formatoLerTransacao(lote[k].bloco.data, v2, slot, &tx);
+                if (tipo < 0) break;
+                if (tipo == 0) continue;
+
+                // Origem e destino contam separadamente, como no índice
+                uint32_t papeis[2] = {tx.origem, tx.destino};
+                for (int papel = 0; papel < 2 && encontradas < limite; papel++) 
+                {
+                    if (papeis[papel] != endereco) continue;
+                    if (indice >= inicio) encontradas++;
+                    indice++;
+                }
+            }
+        }
+    }
+    return encontradas;
+}
+
+size_t memoriaHistorico() 
+{
+    pthread_mutex_lock(&travaIndices);
+    size_t total = historicoMemoria();
+    pthread_mutex_unlock(&travaIndices);
+    return total;
+}
+
+// SALDOS HISTÓRICOS
+
+// Aplica recompensa e transações válidas de um bloco sobre 'alvo' (mesma regra de atualizarEstatisticasGlobais)
+static void aplicarBlocoAosSaldos(unsigned int *alvo, BlocoMinerado *b) 
+{
+    alvo[b->bloco.data[MINERADOR_OFFSET]] += 50;
+    if (b->bloco.numero <= 1) 
+        return;
+
+    for (int i = 0; i < MINERADOR_OFFSET; i += TRANSACAO_SIZE) 
+    {
+        unsigned char origem = b->bloco.data[i];
+        unsigned char destino = b->bloco.data[i + 1];
+        unsigned char valor = b->bloco.data[i + 2];
+
+        if (valor > 0) 
+        {
+            if (alvo[origem] >= valor) 
+            {
+                alvo[origem] -= valor;
+                alvo[destino] += valor;
+            }
+        } 
+        else if (origem == 0 && destino == 0)
+            break;
+    }
+}
+
+/**
+ * Saldos de todos os endereços logo após o bloco 'altura':
+ * restaura o checkpoint mais próximo e reaplica no máximo K blocos.
+ */
+int saldosNaAltura(unsigned int altura, unsigned int saida[]) 
+{
+    if (contasV2 || altura > obterTotalBlocos()) 
+        return 0;
+
+    // Só a restauração do checkpoint precisa da trava; o replay lê blocos já gravados
+    pthread_mutex_lock(&travaIndices);
+    unsigned int proximo = checkpointRestaurar(altura, saida) + 1;
+    pthread_mutex_unlock(&travaIndices);
+    BlocoMinerado lote[READ_LOTE];
+    unsigned int lidos;
+
+    while (proximo <= altura && (lidos = lerIntervaloBlocos(proximo, altura < proximo + READ_LOTE - 1 ? altura : proximo + READ_LOTE - 1, lote)) > 0) 
+    {
+        for (unsigned int k = 0; k < lidos; k++) 
+            aplicarBlocoAosSaldos(saida, &lote[k]);
+        proximo += lidos;
+    }
+    return 1;
+}
+
+void relatorioSaldoHistorico(unsigned int endereco, unsigned int altura) 
+{
+    unsigned int saldosAltura[NUM_ENDERECOS];
+
+    if (contasV2) 
+    {
+        printf("Saldos históricos usam checkpoints dos 256 endereços: indisponível no formato v2.\n");
+        return;
+    }
+    if (endereco >= NUM_ENDERECOS) 
+    {
+        printf("Endereço %u inválido (0-%d).\n", endereco, NUM_ENDERECOS - 1);
+        return;
+    }
+    if (!saldosNaAltura(altura, saldosAltura)) 
+    {
+        printf("Altura %u inválida (a cadeia tem %u blocos).\n", altura, obterTotalBlocos());
+        return;
+    }
+
+    unsigned int maxAltura = 0;
+    for (int i = 0; i < NUM_ENDERECOS; i++) 
+        if (saldosAltura[i] > maxAltura) maxAltura = saldosAltura[i];
+
+    printf("\n--- Saldos na Altura %u ---\n", altura);
+    printf("Endereço %u: %u BTC (hoje: %u BTC)\n", endereco, saldosAltura[endereco], getSaldo((unsigned char)endereco));
+    printf("Mais rico(s) nessa altura: %u BTC | Endereço(s): ", maxAltura);
+
+    int primeiro = 1;
+    for (int i = 0; i < NUM_ENDERECOS && maxAltura > 0; i++) 
+    {
+        if (saldosAltura[i] == maxAltura) 
+        {
+            if (!primeiro) printf(" | ");
+            printf("%d", i);
+            primeiro = 0;
+        }
+    }
+    if (maxAltura == 0) printf("(Nenhum endereço com saldo > 0)");
+    pthread_mutex_lock(&travaIndices);
+    printf("\nCheckpoints: %u a cada %d blocos (%zu KB)\n", checkpointQuantidade(), INTERVALO_CHECKPOINT, checkpointMemoria() / 1024);
+    pthread_mutex_unlock(&travaIndices);
+}
+
 // FUNÇÃO AUXILIAR DE IMPRESSÃO
 
 void imprimirBlocoCompleto(BlocoMinerado *b) 
 {
     printf("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n");
-    printf("BLOCO %u | Minerador: %d | Nonce: %u\n", b->bloco.numero, b->bloco.data[MINERADOR_OFFSET], b->bloco.nonce);
+    int v2 = contasV2 != 0;
+    printf("BLOCO %u | Minerador: %u | Nonce: %u\n", b->bloco.numero, formatoMinerador(b->bloco.data, v2), b->bloco.nonce);
     printf("Hash: ");
     for(int i = 0; i < 32; i++) 
         printf("%02x", b->hash[i]);
     printf("\n");
     
-    // Mostra contagem do cache 
-    printf("Transações: %d\n", obterContagemDoCache(b->bloco.numero));
+    // Mostra contagem da tabela de metadados
+    printf("Transações: %d\n", obterContagemTx(b->bloco.numero));
     
     if (b->bloco.numero == 1) 
         printf("Dados (Gênesis): %s\n", b->bloco.data);
     else 
     {
         printf("Detalhes:\n");
-        for (int i = 0; i < MINERADOR_OFFSET; i += TRANSACAO_SIZE) 
+        TransacaoConta tx;
+        for (int slot = 0; slot < formatoMaxTransacoes(v2); slot++) 
         {
-            unsigned char origem = b->bloco.data[i];
-            unsigned char destino = b->bloco.data[i + 1];
-            unsigned char valor = b->bloco.data[i + 2];
-            
-            if (valor > 0) 
-                printf("  %d → %d ($%d BTC)\n", origem, destino, valor); 
-            else if (origem == 0 && destino == 0)
+            int tipo = formatoLerTransacao(b->bloco.data, v2, slot, &tx);
+            if (tipo < 0) 
                 break;
+            if (tipo > 0) 
+                printf("  %u → %u ($%u BTC)\n", tx.origem, tx.destino, tx.valor); 
         }
     }
     printf("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n");
@@ -776,17 +2510,19 @@ void exibirHistogramaHash()
     int distribuicao[20] = {0}; 
     int maxComprimento = 0;
     int totalSlotsOcupados = 0;
+
+    pthread_mutex_lock(&travaIndices);
     
     for (int i = 0; i < TAM_HASH; i++) 
     {
         int contador = 0;
-        NoHash *atual = tabelaNonce[i];
+        unsigned int id = tabelaNonce[i];
         
-        // Conta elementos na lista encadeada deste slot
-        while (atual != NULL) 
+        // Conta elementos da corrente deste slot (ligada pela coluna proxNonce)
+        while (id != 0) 
         {
             contador++;
-            atual = atual->prox;
+            id = metadadosPagina(id)->proxNonce[metadadosPosicao(id)];
         }
 
         // Estatísticas gerais
@@ -802,6 +2538,18 @@ void exibirHistogramaHash()
             distribuicao[contador]++;
     }
 
+    // Números do filtro e das tabelas copiados sob a trava; a impressão vem depois
+    unsigned int totalBlocos = stats.totalBlocos;
+    size_t memoriaFiltro = bloomMemoria(&filtroNonce);
+    unsigned int bitsPorChave = (unsigned int)(memoriaFiltro * 8 / filtroNonce.capacidade);
+    unsigned int kFiltro = filtroNonce.k, elementosFiltro = filtroNonce.elementos, capacidadeFiltro = filtroNonce.capacidade;
+    double taxaAlvo = taxaFalsoPositivoNonce, taxaEstimada = bloomTaxaEstimada(&filtroNonce);
+    unsigned long long consultas = consultasNonce, rejeitadas = rejeitadasBloom, falsosPositivos = falsosPositivosBloom;
+    size_t memoriaTabela = metadadosMemoria();
+    unsigned int paginas = metadadosPaginas();
+    size_t memoriaIndiceHash = indiceHashMemoria();
+    pthread_mutex_unlock(&travaIndices);
+
     // Encontra a maior frequência para montar o gráfico
     int maxFreq = 0;
     for (int i = 0; i < 20; i++) 
@@ -813,7 +2561,7 @@ void exibirHistogramaHash()
     // Exibe o Relatório
     printf("\n=== ANÁLISE DE PERFORMANCE DA HASH TABLE ===\n");
     printf("Tamanho da Tabela: %d slots\n", TAM_HASH);
-    printf("Total de Blocos:   %u\n", stats.totalBlocos);
+    printf("Total de Blocos:   %u\n", totalBlocos);
     printf("Ocupação:          %d slots (%.1f%%)\n", totalSlotsOcupados, (float)totalSlotsOcupados/TAM_HASH*100);
     printf("Maior colisão:     %d elementos numa lista\n\n", maxComprimento);
     printf("Tam. Lista | Qtd. Slots | Distribuição\n");
@@ -838,4 +2586,30 @@ void exibirHistogramaHash()
     printf("-----------+------------+--------------------------------------------------\n");
     printf("Legenda: 'Tam. Lista' é a quantidade de blocos que caíram no mesmo slot.\n");
     printf("         '0' indica slots vazios (desperdício de memória).\n");
+
+    printf("\n=== FILTRO DE BLOOM DE NONCES ===\n");
+    printf("Tamanho:           %zu KB (%u bits por chave, k = %u)\n", memoriaFiltro / 1024, bitsPorChave, kFiltro);
+    printf("Elementos:         %u de %u previstos\n", elementosFiltro, capacidadeFiltro);
+    printf("Falso positivo:    alvo %.2f%% | estimado %.2f%%\n", taxaAlvo * 100, taxaEstimada * 100);
+    printf("Consultas:         %llu\n", consultas);
+    if (consultas > 0) 
+    {
+        unsigned long long ausentes = rejeitadas + falsosPositivos;
+        printf("Rejeitadas filtro: %llu (%.1f%% das consultas)\n", rejeitadas, 100.0 * rejeitadas / consultas);
+        printf("Falsos positivos:  %llu (%.2f%% dos nonces ausentes)\n", falsosPositivos,
+               ausentes > 0 ? 100.0 * falsosPositivos / ausentes : 0.0);
+    }
+
+    // Colunas por bloco: prefixo (8) + nonce (4) + proxNonce (4) + valor (2) + contagem (1) + minerador (1)
+    size_t bytesPorBloco = sizeof(PaginaMetadados) / METADADOS_POR_PAGINA;
+    printf("\n=== TABELA DE METADADOS POR BLOCO ===\n");
+    printf("Colunas:           %zu bytes por bloco (%.1f MB por milhão de blocos)\n", bytesPorBloco,
+           bytesPorBloco * 1e6 / (1024.0 * 1024.0));
+    printf("Alocado:           %.1f MB em %u páginas de %u blocos\n", memoriaTabela / (1024.0 * 1024.0),
+           paginas, METADADOS_POR_PAGINA);
+    if (totalBlocos > 0) 
+        printf("Efetivo:           %.1f bytes por bloco (%.1f MB por milhão, com a página parcial)\n",
+               (double)memoriaTabela / totalBlocos, memoriaTabela * 1e6 / totalBlocos / (1024.0 * 1024.0));
+    printf("Índice por hash:   %.1f MB (%.1f bytes por bloco)\n", memoriaIndiceHash / (1024.0 * 1024.0),
+           totalBlocos > 0 ? (double)memoriaIndiceHash / totalBlocos : 0.0);
 }
\ No newline at end of file
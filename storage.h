@@ -2,24 +2,73 @@
 #define STORAGE_H
 
 #include "structs.h"
+#include "merkle.h"
+
+// Cópia consistente das estatísticas, lida sem bloquear a mineração
+typedef struct {
+    unsigned int totalBlocos;
+    unsigned int saldos[256];
+    unsigned int blocosMinerados[256];
+    unsigned int maiorQtdMinerada;
+    unsigned long long totalValorTransacionado;
+    int maxTransacoes;
+    int minTransacoes;
+} InstantaneoEstatisticas;
+
+// Callback usado pelos relatórios que percorrem blocos sob demanda
+typedef void (*VisitanteBloco)(BlocoMinerado *b, int qtdTx, void *contexto);
 
 unsigned int obterTotalBlocos();
 unsigned int getSaldo(unsigned char endereco);
+void obterInstantaneo(InstantaneoEstatisticas *saida);
 int listarBlocosPorNonce(unsigned int nonce);
+int percorrerBlocosPorNonce(unsigned int nonce, VisitanteBloco visitar, void *contexto);
+int percorrerBlocosMinerador(unsigned int endereco, int n, VisitanteBloco visitar, void *contexto);
+void percorrerBlocosPorTransacoes(unsigned int n, VisitanteBloco visitar, void *contexto);
+unsigned int maioresSaldos(unsigned int n, unsigned int *enderecos, unsigned int *valores);
+unsigned int maioresMineradores(unsigned int *enderecos, unsigned int max, unsigned int *blocos);
+unsigned int blocosRecorde(int maximo, int *valor, unsigned int *ids, unsigned int maxIds);
+void definirTaxaFalsoPositivoNonce(double taxa);
+int buscarBlocoPorHash(const char *hex);
 int buscarBlocoPorId(unsigned int id, BlocoMinerado *saida);
+int buscarCabecalhoPorId(unsigned int id, CabecalhoBloco *saida);
+int gerarProvaInclusao(unsigned int idBloco, int indice, ProvaMerkle *prova, unsigned char folha[MERKLE_MAX_FOLHA]);
+int contagemTransacoes(unsigned int idBloco);
+unsigned int lerIntervaloBlocos(unsigned int inicio, unsigned int fim, BlocoMinerado *saida);
+void definirModoCadeiaGrande(int ativo);
+void definirContasV2(unsigned int qtdContas);
+void definirValidacaoParalela(int threads);
+unsigned int contasDaCadeia();
+unsigned int getSaldoConta(unsigned int conta);
+unsigned int mineradorDoBloco(const BlocoMinerado *b);
 void inicializarStorage(const char *nomeArquivo);
 void finalizarStorage();
+void finalizarStorageRapido();
+void recarregarIndicesDoDisco();
+int exportarParaTexto(const char *nomeArquivoTxt);
+int exportarTextoDaCadeia();
 void getUltimoHash(unsigned char *bufferHash);
 void adicionarBloco(BlocoMinerado *bloco);
+int desconectarBlocoTopo(BlocoMinerado *removido);
+unsigned int profundidadeDesfazerDisponivel();
+unsigned int localizarBlocoPorHash(const unsigned char hash[SHA256_LEN]);
 void relatorioMaisRico();
 void relatorioMaiorMinerador();
+void relatorioRiqueza(unsigned int topN, unsigned int endereco);
 void relatorioMaxTransacoes();
 void relatorioMinTransacoes();
 void calcularMediaBitcoinsPorBloco();
 void imprimirBlocoPorNumero(unsigned int numero);
-void listarBlocosMinerador(unsigned char endereco, int n);
+void listarBlocosMinerador(unsigned int endereco, int n);
 void relatorioTransacoes(unsigned int n);
 void *verifica_malloc(size_t tamanho, const char *contexto);
 void exibirHistogramaHash();
+void listarHistoricoEndereco(unsigned int endereco, unsigned int inicio, unsigned int limite);
+unsigned int varrerHistoricoEndereco(unsigned int endereco, unsigned int inicio, unsigned int limite);
+size_t memoriaHistorico();
+int saldosNaAltura(unsigned int altura, unsigned int saida[]);
+void relatorioSaldoHistorico(unsigned int endereco, unsigned int altura);
+int verificarCadeiaPorCabecalhos(unsigned int *verificados);
+int verificarCadeiaCompleta(unsigned int *verificados);
 
 #endif
\ No newline at end of file
@@ -27,40 +27,34 @@ typedef struct {
     BlocoNaoMinerado bloco; // Dados do bloco que foram hasheados
 } BlocoMinerado;
 
-/**
- * Nó da Hash Table para índice de Nonces
- * 
- * Estrutura de dados: Hash Table com encadeamento 
- * - Cada slot da tabela aponta para uma lista encadeada de nós
- * - Permite busca rápida O(1) em média de blocos pelo nonce
- * - 'prox' aponta para o próximo nó na mesma lista 
- */
-typedef struct NoHash {
-    unsigned int nonce;           // Nonce usado na mineração do bloco
-    unsigned int idBloco;         // ID sequencial do bloco (1 a N)
-    struct NoHash *prox;          // Ponteiro para próximo nó (lista encadeada)
-} NoHash;
+typedef struct {
+    unsigned int totalBlocos;           // Contador total de blocos no sistema
+} Estatisticas;
 
 /**
- * Nó do Índice de Mineradores
+ * Cabeçalho compacto de um bloco (arquivo .hdr)
  * 
- * Estrutura de dados: Array de 256 listas encadeadas
- * - Cada endereço (0-255) tem sua própria lista de blocos
- * - Inserção sempre no FIM da lista
- * - 'prox' aponta para o próximo bloco minerado pelo mesmo endereço
+ * Guarda apenas o necessário para verificar encadeamento e prova de trabalho:
+ * - 'raizDados' é a raiz Merkle das transações + minerador (61 + 1 no v1, 15 + 1 no v2),
+ *   contra a qual as provas de inclusão são conferidas
+ * - v1: 'estadoParcial' é o estado interno do SHA-256 após numero|nonce|data
+ *   (exatamente 3 blocos de 64 bytes), então hash = SHA256(estadoParcial + hashAnterior)
+ * - v2: hash = SHA256(numero | nonce | raizDados | hashAnterior); 'estadoParcial' fica zerado
+ *
+ * No v1 o estado parcial é opaco: nada no cabeçalho mostra que ele saiu de
+ * 'numero', 'nonce' e dos dados da 'raizDados'. A verificação só por
+ * cabeçalhos prova trabalho sobre esses 32 bytes e o encadeamento, sem amarrar
+ * os outros campos, e uma prova de inclusão conferida contra a raiz vale o
+ * mesmo que a origem do .hdr. Só a verificação completa (que relê 'data')
+ * cobre o v1.
  */
-typedef struct NoMinerador {
-    unsigned int idBloco;         // ID do bloco minerado
-    struct NoMinerador *prox;     // Próximo bloco do mesmo minerador
-} NoMinerador;
-
 typedef struct {
-    unsigned int totalBlocos;           // Contador total de blocos no sistema
-} Estatisticas;
-
-typedef struct RecordBlocos {
-    unsigned int idBloco;
-    struct RecordBlocos *prox;          // Ponteiro para próximo nó (lista encadeada)
-} NoRecorde;
+    unsigned int numero;                    // Número sequencial do bloco
+    unsigned int nonce;                     // Nonce usado na mineração
+    unsigned char hashAnterior[SHA256_LEN]; // Hash do bloco anterior
+    unsigned char estadoParcial[SHA256_LEN];// Estado SHA-256 intermediário (midstate)
+    unsigned char raizDados[SHA256_LEN];    // Raiz Merkle das transações do bloco
+    unsigned char hash[SHA256_LEN];         // Hash do bloco
+} CabecalhoBloco;
 
 #endif
\ No newline at end of file
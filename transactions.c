@@ -1,28 +1,72 @@
 #include <stdio.h>
 #include <string.h> 
 #include "mtwister.h"
+#include "philox.h"
 #include "transactions.h"
 #include "structs.h"
 #include "storage.h"
+#include "contadores.h"
+#include "ledger.h"
+#include "formato.h"
+#include "contas.h"
 
 #define TOTAL_ENDERECOS 256
 #define TAMANHO_DATA 184
 #define MAX_TRANSACOES 61
 #define POSICAO_MINERADOR 183 
 
+// Fonte dos sorteios de um bloco: a sequência única do Mersenne Twister ou o fluxo Philox do bloco
+typedef struct {
+    MTRand *mt;             // NULL no modo contador
+    FluxoPhilox fluxo;
+} Sorteador;
+
+// Inteiro em [0, limite): '%' no Mersenne Twister (mantém as cadeias já mineradas), multiplicação no Philox
+static inline unsigned int sortear(Sorteador *s, unsigned int limite)
+{
+    contadorSomar(CONTADOR_SORTEIOS_RNG, 1);
+    if (s->mt != NULL)
+        return genRandLong(s->mt) % limite;
+    return sorteioLimitado(philoxProximo(&s->fluxo), limite);
+}
+
+/**
+ * Saldos de rascunho do bloco. Sem carteira de origem, o ponto de partida é
+ * uma versão do ledger e cada endereço só é copiado quando o bloco o toca
+ * pela primeira vez (bit em 'copiados'), em vez dos 256 saldos por bloco.
+ */
+typedef struct {
+    unsigned int saldos[TOTAL_ENDERECOS];
+    uint64_t copiados[TOTAL_ENDERECOS / 64];
+    VersaoLedger *versao;       // NULL: 'saldos' já veio inteiro da carteira
+} Rascunho;
+
+static inline unsigned int *saldoRascunho(Rascunho *rascunho, unsigned char endereco)
+{
+    uint64_t bit = 1ULL << (endereco & 63);
+    if (rascunho->versao != NULL && !(rascunho->copiados[endereco >> 6] & bit))
+    {
+        rascunho->copiados[endereco >> 6] |= bit;
+        rascunho->saldos[endereco] = ledgerSaldo(rascunho->versao, endereco);
+    }
+    return &rascunho->saldos[endereco];
+}
+
 // GERAÇÃO DE DADOS DO BLOCO 
 
 /**
  * Gera dados do bloco: minerador + transações aleatórias
  */
-int gerarDadosDoBloco(unsigned int numeroDoBloco, unsigned char dataBlock[], unsigned int carteiraOrigem[], MTRand *r) 
+static int gerarDados(unsigned int numeroDoBloco, unsigned char dataBlock[], unsigned int carteiraOrigem[], Sorteador *r) 
 {
     
+    contadorSomar(CONTADOR_BLOCOS_GERADOS, 1);
+
     // Limpa vetor de dados
     memset(dataBlock, 0, TAMANHO_DATA);
 
     // Define minerador aleatório
-    unsigned char minerador = (unsigned char)(genRandLong(r) % 256);
+    unsigned char minerador = (unsigned char)sortear(r, 256);
     dataBlock[POSICAO_MINERADOR] = minerador;
 
     if (numeroDoBloco == 1) 
@@ -33,32 +77,32 @@ int gerarDadosDoBloco(unsigned int numeroDoBloco, unsigned char dataBlock[], uns
         return 0;
     }
 
-    
-    unsigned int saldoTemp[TOTAL_ENDERECOS];
-    
+    // Saldos e candidatos (endereços com saldo > 0, em ordem crescente)
+    Rascunho rascunho;
+    unsigned char candidatos[TOTAL_ENDERECOS];
+    int totalCandidatos = 0;
 
     if (carteiraOrigem != NULL) 
-        memcpy(saldoTemp, carteiraOrigem, sizeof(unsigned int) * TOTAL_ENDERECOS);
-    else 
     {
-        for (int i = 0; i < TOTAL_ENDERECOS; i++) 
-            saldoTemp[i] = getSaldo((unsigned char)i);
-    }
-
-    // Lista de candidatos: endereços com saldo > 0
-    unsigned char candidatos[TOTAL_ENDERECOS];
-    int totalCandidatos = 0;
-    
-    // OTIMIZAÇÃO 1: Inicializa lista UMA VEZ (não a cada transação)
-    for (int k = 0; k < TOTAL_ENDERECOS; k++) {
-        if (saldoTemp[k] > 0) {
-            candidatos[totalCandidatos] = (unsigned char)k;
-            totalCandidatos++;
+        rascunho.versao = NULL;
+        memcpy(rascunho.saldos, carteiraOrigem, sizeof(unsigned int) * TOTAL_ENDERECOS);
+        for (int k = 0; k < TOTAL_ENDERECOS; k++) {
+            if (rascunho.saldos[k] > 0) {
+                candidatos[totalCandidatos] = (unsigned char)k;
+                totalCandidatos++;
+            }
         }
     }
+    else 
+    {
+        // Versão consistente do ledger: candidatos saem do bitmap, sem varrer os saldos
+        memset(rascunho.copiados, 0, sizeof(rascunho.copiados));
+        rascunho.versao = ledgerAdquirir();
+        totalCandidatos = (int)ledgerEnderecosNaoZero(rascunho.versao, candidatos);
+    }
 
     // Quantidade aleatória de transações (0 a 61)
-    int qtdTransacoes = (int)(genRandLong(r) % (MAX_TRANSACOES + 1)); 
+    int qtdTransacoes = (int)sortear(r, MAX_TRANSACOES + 1); 
     int posicaoAtual = 0;
     int transacoesValidas = 0;
 
@@ -66,17 +110,18 @@ int gerarDadosDoBloco(unsigned int numeroDoBloco, unsigned char dataBlock[], uns
         if (totalCandidatos == 0) break; // Ninguém mais tem saldo
 
         // Sorteia origem da lista de candidatos
-        int indiceSorteado = (int)(genRandLong(r) % totalCandidatos);
+        int indiceSorteado = (int)sortear(r, (unsigned int)totalCandidatos);
         unsigned char origem = candidatos[indiceSorteado];
         
         // Destino pode ser qualquer endereço
-        unsigned char destino = (unsigned char)(genRandLong(r) % 256); 
+        unsigned char destino = (unsigned char)sortear(r, 256); 
 
         // Valor: máximo é o saldo da origem, limitado a 50
-        unsigned int maximoPossivel = saldoTemp[origem];
+        unsigned int *saldoOrigem = saldoRascunho(&rascunho, origem);
+        unsigned int maximoPossivel = *saldoOrigem;
         if (maximoPossivel > 50) maximoPossivel = 50;
 
-        unsigned char valor = (unsigned char)(genRandLong(r) % (maximoPossivel + 1));
+        unsigned char valor = (unsigned char)sortear(r, maximoPossivel + 1);
 
         // Grava no vetor de dados
         dataBlock[posicaoAtual]     = origem;
@@ -87,11 +132,10 @@ int gerarDadosDoBloco(unsigned int numeroDoBloco, unsigned char dataBlock[], uns
         transacoesValidas++;
 
         // Atualiza saldos temporários
-        saldoTemp[origem] -= valor;
-        saldoTemp[destino] += valor;
-
+        *saldoOrigem -= valor;
+        *saldoRascunho(&rascunho, destino) += valor;
 
-        if (saldoTemp[origem] == 0) {
+        if (*saldoOrigem == 0) {
             candidatos[indiceSorteado] = candidatos[totalCandidatos - 1];
             totalCandidatos--;
         }
@@ -99,6 +143,122 @@ int gerarDadosDoBloco(unsigned int numeroDoBloco, unsigned char dataBlock[], uns
         // Se destino não estava na lista e agora tem saldo, adiciona
         // (Apenas se valor > 0 e destino era 0 antes)
     }
+
+    ledgerLiberar(rascunho.versao);
+
+    contadorSomar(CONTADOR_TRANSACOES_GERADAS, (unsigned long long)transacoesValidas);
     
     return transacoesValidas;
 }
+
+int gerarDadosDoBloco(unsigned int numeroDoBloco, unsigned char dataBlock[], unsigned int carteiraOrigem[], MTRand *r)
+{
+    Sorteador s = {.mt = r};
+    return gerarDados(numeroDoBloco, dataBlock, carteiraOrigem, &s);
+}
+
+/**
+ * Mesma geração com sorteios Philox de (semente, numeroDoBloco, índice): não
+ * depende dos blocos gerados antes além dos saldos. Com carteiraOrigem =
+ * saldos na altura numeroDoBloco - 1, regenera o bloco em qualquer thread e
+ * em qualquer ordem.
+ */
+int gerarDadosDoBlocoContador(unsigned int numeroDoBloco, unsigned char dataBlock[], unsigned int carteiraOrigem[], uint64_t semente)
+{
+    Sorteador s = {.mt = NULL};
+    philoxIniciarFluxo(&s.fluxo, semente, numeroDoBloco);
+    return gerarDados(numeroDoBloco, dataBlock, carteiraOrigem, &s);
+}
+
+// GERAÇÃO NO FORMATO V2 (CONTAS DE 32 BITS)
+
+#define TENTATIVAS_ORIGEM 4     // Sorteios de origem antes de desistir do resto do bloco
+
+// Rascunho dos saldos tocados pelo bloco: no máximo origem e destino de cada transação
+typedef struct {
+    unsigned int conta[2 * V2_MAX_TRANSACOES];
+    unsigned int saldo[2 * V2_MAX_TRANSACOES];
+    int qtd;
+} RascunhoContas;
+
+static unsigned int *saldoRascunhoContas(RascunhoContas *rascunho, unsigned int conta)
+{
+    for (int i = 0; i < rascunho->qtd; i++)
+    {
+        if (rascunho->conta[i] == conta)
+            return &rascunho->saldo[i];
+    }
+    rascunho->conta[rascunho->qtd] = conta;
+    rascunho->saldo[rascunho->qtd] = contasSaldo(conta);
+    return &rascunho->saldo[rascunho->qtd++];
+}
+
+/**
+ * Minerador + até 15 transações entre contas de 32 bits. A origem sai do
+ * conjunto de contas com saldo do storage (O(1) por sorteio, sem varrer o
+ * espaço de contas); uma origem que o próprio bloco já esvaziou é sorteada
+ * de novo. Valores de 1 até o saldo inteiro da origem.
+ */
+static int gerarDadosContas(unsigned int numeroDoBloco, unsigned char dataBlock[], Sorteador *r)
+{
+    contadorSomar(CONTADOR_BLOCOS_GERADOS, 1);
+    memset(dataBlock, 0, TAMANHO_DATA);
+
+    unsigned int qtdContas = contasQuantidade();
+    gravarU32(&dataBlock[V2_MINERADOR_OFFSET], sortear(r, qtdContas));
+
+    if (numeroDoBloco == 1)
+    {
+        strcpy((char*)dataBlock, "The Times 03/Jan/2009 Chancellor on brink of second bailout for banks");
+        formatoMarcarGenesisV2(dataBlock, qtdContas);
+        return 0;
+    }
+
+    RascunhoContas rascunho = {.qtd = 0};
+    int qtdTransacoes = (int)sortear(r, V2_MAX_TRANSACOES + 1);
+    int transacoesValidas = 0;
+
+    for (int i = 0; i < qtdTransacoes && contasComSaldo() > 0; i++)
+    {
+        unsigned int origem = 0;
+        unsigned int *saldoOrigem = NULL;
+        for (int t = 0; t < TENTATIVAS_ORIGEM && saldoOrigem == NULL; t++)
+        {
+            origem = contasComSaldoEm(sortear(r, contasComSaldo()));
+            unsigned int *saldo = saldoRascunhoContas(&rascunho, origem);
+            if (*saldo > 0)
+                saldoOrigem = saldo;
+        }
+        if (saldoOrigem == NULL)
+            break;
+
+        unsigned int destino = sortear(r, qtdContas);
+        unsigned int valor = 1 + sortear(r, *saldoOrigem);
+
+        formatoGravarTransacaoV2(dataBlock, transacoesValidas, origem, destino, valor);
+        transacoesValidas++;
+        *saldoOrigem -= valor;
+        *saldoRascunhoContas(&rascunho, destino) += valor;
+    }
+
+    contadorSomar(CONTADOR_TRANSACOES_GERADAS, (unsigned long long)transacoesValidas);
+    return transacoesValidas;
+}
+
+/**
+ * Bloco no formato v2 sobre o estado de contas do storage (cadeia aberta
+ * com definirContasV2). Deve rodar na thread que adiciona os blocos, como
+ * a simulação: o conjunto de contas com saldo é lido sem trava.
+ */
+int gerarDadosDoBlocoContas(unsigned int numeroDoBloco, unsigned char dataBlock[], MTRand *r)
+{
+    Sorteador s = {.mt = r};
+    return gerarDadosContas(numeroDoBloco, dataBlock, &s);
+}
+
+int gerarDadosDoBlocoContasContador(unsigned int numeroDoBloco, unsigned char dataBlock[], uint64_t semente)
+{
+    Sorteador s = {.mt = NULL};
+    philoxIniciarFluxo(&s.fluxo, semente, numeroDoBloco);
+    return gerarDadosContas(numeroDoBloco, dataBlock, &s);
+}
@@ -1,8 +1,12 @@
 #ifndef TRANSACTIONS_H
 #define TRANSACTIONS_H
 
+#include <stdint.h>
 #include "mtwister.h" 
 
 int gerarDadosDoBloco(unsigned int numeroDoBloco, unsigned char dataBlock[], unsigned int carteiraOficial[], MTRand *r);
+int gerarDadosDoBlocoContador(unsigned int numeroDoBloco, unsigned char dataBlock[], unsigned int carteiraOficial[], uint64_t semente);
+int gerarDadosDoBlocoContas(unsigned int numeroDoBloco, unsigned char dataBlock[], MTRand *r);
+int gerarDadosDoBlocoContasContador(unsigned int numeroDoBloco, unsigned char dataBlock[], uint64_t semente);
 
 #endif
\ No newline at end of file